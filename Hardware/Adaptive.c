@@ -0,0 +1,301 @@
+#include "stm32f10x.h"
+#include "Adaptive.h"
+#include "PID.h"
+#include "Delay.h"
+#include "Defer.h"
+#include "GainSched.h"
+#include <stdio.h>
+#include <math.h>
+
+/* ==========================================================
+ * 在线自适应速度控制模块（Adaptive.c）
+ * 
+ * 辨识模型 v[k] = a·v[k-1] + b·u[k-1]。闭环稳态时数据只约束
+ * a + b·u/v = 1 这一个组合，因此仅在输入有足够变化（目标切换、
+ * 负载扰动）的窗口更新，其余窗口保持估计不变。
+ * 
+ * 测速为1ms内脉冲数，量化噪声约为信号逐周期变化量的数倍，逐周期
+ * 回归时回归量含噪使 a 明显偏小。模型是线性的，对 ADAPT_WINDOW 个
+ * 周期求和后仍成立：
+ *     Σv[k] = a·Σv[k-1] + b·Σu[k-1]
+ * 而窗口内测速之和等于窗口首尾计数差，量化误差不随周期数累积，
+ * 故每窗口用各项的窗口均值做一次RLS更新。测速为区间平均速度，
+ * 输入在区间内的作用近似各占前后两个周期一半，u[k-1] 取
+ * (u[k-1] + u[k-2]) / 2。
+ * 
+ * 定点格式：
+ *  - 回归量 φ = [v/1024, u/1024]（窗口均值），Q15
+ *  - 参数 θ = [a, b]、协方差 P、遗忘因子 λ 均为 Q16（λ按窗口计）
+ * 每周期只做累加，每窗口一次RLS（2×2矩阵，一次64位除法），执行时间有界。
+ * 
+ * 防发散措施：
+ *  - 激励不足（|Δu|过小）时跳过更新，避免沿稳态约束漂移及P指数增长
+ *  - P 迹超过上限时整体缩小，对角元非正时重置
+ *  - θ 限制在物理合理范围（0 < a < 1，b > 0）
+ *  - 极点配置解出 Kp ≤ 0 时保留原增益
+ * 
+ * 输入 u 取速度环PID输出，不含摩擦前馈，前馈抵消的摩擦
+ * 近似并入模型。
+ * ========================================================== */
+
+#define ADAPT_WINDOW        10              // 辨识窗口（周期）
+#define ADAPT_P_INIT        (1000L << 16)   // 协方差初值（Q16）
+#define ADAPT_P_TRACE_MAX   (10000L << 16)  // 协方差迹上限
+#define ADAPT_EXCITE_MIN    (8 << 5)        // |Δu| 下限（Q15回归量），低于此不更新
+#define ADAPT_A_MAX         65470           // a 上限 ≈ 0.999
+#define ADAPT_B_MIN         66              // b 下限 ≈ 0.001
+#define ADAPT_B_MAX         (4L << 16)      // b 上限
+#define ADAPT_KP_MAX        50.0f
+#define ADAPT_KI_MAX        20.0f
+
+static volatile uint8_t adapt_enabled = 0;
+static volatile uint8_t adapt_report = 0;
+static int32_t adapt_theta[2];          // [a, b]，Q16
+static int32_t adapt_p[2][2];           // 协方差，Q16
+static int32_t adapt_lambda = 65208;    // 遗忘因子 0.995（Q16）
+static int32_t adapt_inv_lambda;        // 1/λ（Q16）
+static float adapt_pole = 0.98f;        // 期望闭环极点
+static int32_t adapt_v_prev;            // 窗口内 v[k-1] 均值（Q15）
+static int32_t adapt_u_prev;            // 窗口内 u[k-1] 均值（Q15）
+static int32_t adapt_du_prev;           // 与上一窗口 u 均值之差（Q15）
+static int32_t adapt_sum_y;             // 窗口内 Σv[k]
+static int32_t adapt_sum_v;             // 窗口内 Σv[k-1]
+static int32_t adapt_sum_u;             // 窗口内 Σ(u[k-1] + u[k-2])
+static int16_t adapt_v_last;            // v[k-1]
+static int16_t adapt_u_last[2];         // u[k-1]、u[k-2]
+static uint8_t adapt_window;
+static uint16_t adapt_counter;
+static uint32_t adapt_resets;           // 协方差重置次数
+static uint32_t adapt_max_cycles;       // 单次更新最大周期数
+static float adapt_kp, adapt_ki;        // 最近一次计算出的增益
+
+static void Adaptive_Place_Poles(void);
+
+
+/**
+ * @brief 复位估计器
+ * 
+ * θ 初值取 a=0.9、b=0.1，仅用于启动，随后由数据修正。
+ */
+void Adaptive_Reset(void)
+{
+    adapt_theta[0] = 58982;             // 0.9
+    adapt_theta[1] = 6554;              // 0.1
+    adapt_p[0][0] = adapt_p[1][1] = ADAPT_P_INIT;
+    adapt_p[0][1] = adapt_p[1][0] = 0;
+    adapt_counter = 0;
+    adapt_window = 0;
+    adapt_sum_y = adapt_sum_v = adapt_sum_u = 0;
+}
+
+
+/**
+ * @brief 开关自适应模式
+ * @param enable     1开启，0关闭（关闭时保留当前增益）
+ * @param tcl_ms     期望闭环时间常数（ms），0保持原值
+ * @param lambda_q16 遗忘因子（Q16，建议0.98~0.999），0保持原值
+ */
+void Adaptive_Enable(uint8_t enable, uint16_t tcl_ms, int32_t lambda_q16)
+{
+    if (tcl_ms > 0)
+    {
+        adapt_pole = expf(-1.0f / tcl_ms);     // 控制周期1ms
+    }
+    if (lambda_q16 > 32768 && lambda_q16 <= 65536)
+    {
+        adapt_lambda = lambda_q16;
+    }
+    adapt_inv_lambda = (int32_t)((1LL << 32) / adapt_lambda);
+
+    if (enable && !adapt_enabled)
+    {
+        Defer_Register(DEFER_ADAPT, Adaptive_Place_Poles);
+        Adaptive_Reset();
+    }
+    else if (!enable && adapt_enabled)
+    {
+        GainSched_Invalidate();         // 交还调度表，下周期按表重算
+    }
+    adapt_enabled = enable;
+}
+
+
+uint8_t Adaptive_IsEnabled(void)
+{
+    return adapt_enabled;
+}
+
+
+/**
+ * @brief 按当前估计做极点配置并应用增益
+ * 
+ * 对象 b/(z-a) 与增量式PI构成二阶闭环，特征式
+ *     z² + (b(Kp+Ki) - 1 - a) z + (a - b·Kp)
+ * 令其等于 (z - p)² 解得 Kp、Ki。每 ADAPT_PERIOD 周期一次，使用浮点，
+ * 由控制中断置位后在 PendSV 下半部执行。
+ * 
+ * 期望闭环时间常数须小于开环时间常数（a > p²），否则不改增益。
+ */
+static void Adaptive_Place_Poles(void)
+{
+    if (!adapt_enabled)
+        return;
+
+    float a = adapt_theta[0] / 65536.0f;
+    float b = adapt_theta[1] / 65536.0f;
+    float p = adapt_pole;
+
+    float kp = (a - p * p) / b;
+    float ki = (1.0f + a - 2.0f * p) / b - kp;
+
+    // a ≤ p² 说明期望闭环比开环还慢，估计尚不可信，不改增益
+    if (kp <= 0)
+        return;
+    if (kp > ADAPT_KP_MAX) kp = ADAPT_KP_MAX;
+    if (ki < 0) ki = 0;
+    if (ki > ADAPT_KI_MAX) ki = ADAPT_KI_MAX;
+
+    adapt_kp = kp;
+    adapt_ki = ki;
+    // 增量式PID改增益不会引起输出突变（积分量保存在输出中）
+    Speed_PID_SetParams(kp, ki, 0.0f);
+}
+
+
+/**
+ * @brief RLS单步更新（每窗口一次）
+ * @param y 窗口内 v[k] 均值（Q15）
+ */
+static void Adaptive_Rls_Update(int32_t y)
+{
+    int32_t phi[2] = { adapt_v_prev, adapt_u_prev };
+
+    // 输入变化过小（稳态）时不更新：此时数据只约束 a、b 的一个组合，
+    // 继续更新会让估计沿该方向漂移
+    if (adapt_du_prev < ADAPT_EXCITE_MIN && adapt_du_prev > -ADAPT_EXCITE_MIN)
+        return;
+
+    // Pφ（Q16）
+    int32_t pphi[2];
+    pphi[0] = (int32_t)(((int64_t)adapt_p[0][0] * phi[0] + (int64_t)adapt_p[0][1] * phi[1]) >> 15);
+    pphi[1] = (int32_t)(((int64_t)adapt_p[1][0] * phi[0] + (int64_t)adapt_p[1][1] * phi[1]) >> 15);
+
+    // 分母 λ + φᵀPφ（Q16，恒大于0）
+    int64_t denom = adapt_lambda + (((int64_t)phi[0] * pphi[0] + (int64_t)phi[1] * pphi[1]) >> 15);
+    if (denom <= 0)
+    {
+        Adaptive_Reset();
+        adapt_resets++;
+        return;
+    }
+
+    // 增益向量 K = Pφ / 分母（Q16）
+    int64_t inv = (1LL << 32) / denom;
+    int32_t gain[2];
+    gain[0] = (int32_t)(((int64_t)pphi[0] * inv) >> 16);
+    gain[1] = (int32_t)(((int64_t)pphi[1] * inv) >> 16);
+
+    // 预测误差 e = y - φᵀθ（Q15）
+    int32_t err = y - (int32_t)(((int64_t)phi[0] * adapt_theta[0] + (int64_t)phi[1] * adapt_theta[1]) >> 16);
+
+    adapt_theta[0] += (int32_t)(((int64_t)gain[0] * err) >> 15);
+    adapt_theta[1] += (int32_t)(((int64_t)gain[1] * err) >> 15);
+
+    // P = (P - K·(Pφ)ᵀ) / λ，并强制对称
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        for (uint8_t j = 0; j < 2; j++)
+        {
+            int64_t pij = adapt_p[i][j] - (((int64_t)gain[i] * pphi[j]) >> 16);
+            adapt_p[i][j] = (int32_t)((pij * adapt_inv_lambda) >> 16);
+        }
+    }
+    adapt_p[0][1] = adapt_p[1][0] = (adapt_p[0][1] + adapt_p[1][0]) / 2;
+
+    // 防发散：对角元非正则重置，迹超限则整体缩小
+    if (adapt_p[0][0] <= 0 || adapt_p[1][1] <= 0)
+    {
+        adapt_p[0][0] = adapt_p[1][1] = ADAPT_P_INIT;
+        adapt_p[0][1] = adapt_p[1][0] = 0;
+        adapt_resets++;
+    }
+    else if ((int64_t)adapt_p[0][0] + adapt_p[1][1] > ADAPT_P_TRACE_MAX)
+    {
+        adapt_p[0][0] >>= 1;
+        adapt_p[0][1] >>= 1;
+        adapt_p[1][0] >>= 1;
+        adapt_p[1][1] >>= 1;
+    }
+
+    // 参数限幅
+    if (adapt_theta[0] < 0) adapt_theta[0] = 0;
+    if (adapt_theta[0] > ADAPT_A_MAX) adapt_theta[0] = ADAPT_A_MAX;
+    if (adapt_theta[1] < ADAPT_B_MIN) adapt_theta[1] = ADAPT_B_MIN;
+    if (adapt_theta[1] > ADAPT_B_MAX) adapt_theta[1] = ADAPT_B_MAX;
+}
+
+
+/**
+ * @brief 自适应周期处理（控制中断中，速度环计算之后调用）
+ * @param speed 本周期速度 v[k]
+ * @param u     本周期速度环输出 u[k]（下周期作为回归量）
+ */
+void Adaptive_Tick(int16_t speed, int16_t u)
+{
+    if (!adapt_enabled)
+        return;
+
+    uint32_t start = DWT_CYCCNT;
+
+    adapt_sum_y += speed;
+    adapt_sum_v += adapt_v_last;
+    adapt_sum_u += adapt_u_last[0] + adapt_u_last[1];
+    adapt_v_last = speed;
+    adapt_u_last[1] = adapt_u_last[0];
+    adapt_u_last[0] = u;
+
+    if (++adapt_window >= ADAPT_WINDOW)
+    {
+        // 窗口均值，v/1024、u/1024（Q15）
+        int32_t u_q15 = (adapt_sum_u << 5) / (2 * ADAPT_WINDOW);
+        adapt_du_prev = u_q15 - adapt_u_prev;
+        adapt_u_prev = u_q15;
+        adapt_v_prev = (adapt_sum_v << 5) / ADAPT_WINDOW;
+        Adaptive_Rls_Update((adapt_sum_y << 5) / ADAPT_WINDOW);
+
+        adapt_window = 0;
+        adapt_sum_y = adapt_sum_v = adapt_sum_u = 0;
+    }
+
+    if (++adapt_counter >= ADAPT_PERIOD)
+    {
+        adapt_counter = 0;
+        Defer_Post(DEFER_ADAPT);
+    }
+
+    uint32_t cycles = DWT_CYCCNT - start;
+    if (cycles > adapt_max_cycles) adapt_max_cycles = cycles;
+}
+
+
+void Adaptive_Request_Report(void)
+{
+    adapt_report = 1;
+}
+
+
+/**
+ * @brief 输出自适应状态（主循环中调用）
+ * 
+ * 格式：adapt,<使能>,<a>,<b>,<Kp>,<Ki>,<重置次数>,<最大周期数>\n
+ */
+void Adaptive_PollReport(void)
+{
+    if (!adapt_report)
+        return;
+    adapt_report = 0;
+
+    printf("adapt,%d,%.4f,%.4f,%.3f,%.4f,%lu,%lu\n", adapt_enabled,
+           adapt_theta[0] / 65536.0f, adapt_theta[1] / 65536.0f,
+           adapt_kp, adapt_ki, (unsigned long)adapt_resets, (unsigned long)adapt_max_cycles);
+}
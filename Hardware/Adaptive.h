@@ -0,0 +1,32 @@
+#ifndef __ADAPTIVE_H
+#define __ADAPTIVE_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 在线自适应速度控制模块接口说明（定点RLS + 极点配置）
+ *
+ * 用递推最小二乘估计电机1离散模型（每个控制周期累加，每10个周期
+ * 以窗口均值更新一次，抑制测速量化噪声）
+ *     v[k] = a·v[k-1] + b·u[k-1]
+ * 每 ADAPT_PERIOD 个周期按期望闭环极点重新计算PI增益：
+ *     Kp = (a - p²) / b，Ki = (1 + a - 2p) / b - Kp，p = exp(-T/Tcl)
+ *
+ * - Adaptive_Enable(en, tcl_ms, lambda_q16)  开关自适应，设置闭环时间常数与遗忘因子
+ * - Adaptive_IsEnabled()                     已开启返回1
+ * - Adaptive_Tick(speed, u)                  控制中断中每周期调用（速度环计算之后）
+ * - Adaptive_Reset()                         复位估计器（协方差重置为初值）
+ * - Adaptive_Request_Report()                请求主循环输出一次状态
+ * - Adaptive_PollReport()                    有报告请求时输出状态
+ * ========================================================== */
+
+#define ADAPT_PERIOD        100     // 增益重算间隔（周期）
+
+void Adaptive_Enable(uint8_t enable, uint16_t tcl_ms, int32_t lambda_q16);
+uint8_t Adaptive_IsEnabled(void);
+void Adaptive_Tick(int16_t speed, int16_t u);
+void Adaptive_Reset(void);
+void Adaptive_Request_Report(void);
+void Adaptive_PollReport(void);
+
+#endif
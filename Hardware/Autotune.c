@@ -0,0 +1,268 @@
+#include "stm32f10x.h"
+#include "Autotune.h"
+#include "PID.h"
+#include "GainSched.h"
+#include "Motor.h"
+#include <stdio.h>
+#include <math.h>
+
+/* ==========================================================
+ * 速度环继电反馈自整定模块（Autotune.c）
+ * 功能：
+ *  - 在控制中断中以状态机方式完成工作点稳定、继电振荡与测量
+ *  - 计算增益并换算到 PID.c 使用的增量式形式：
+ *      Ki = Kp·T/Ti，Kd = Kp·Td/T（T 为控制周期，按1个周期计）
+ * ========================================================== */
+
+#define TUNE_SETTLE_TICKS    1500   // 工作点稳定时间（周期）
+#define TUNE_BIAS_TICKS      500    // 稳定阶段末尾用于求平均输出的周期数
+#define TUNE_SKIP_CYCLES     2      // 丢弃的起始振荡周期数
+#define TUNE_MEASURE_CYCLES  4      // 参与平均的振荡周期数
+#define TUNE_TIMEOUT_TICKS   15000  // 继电阶段超时
+#define TUNE_HYSTERESIS_Q4   (3 << 4)  // 继电回差ε（速度单位，Q4）
+#define TUNE_DEFAULT_RELAY   100    // 默认继电幅值d
+
+typedef enum
+{
+    TUNE_IDLE = 0,
+    TUNE_SETTLE,
+    TUNE_RELAY,
+} Tune_State;
+
+static volatile Tune_State tune_state = TUNE_IDLE;
+static volatile uint8_t tune_done = 0;
+static int16_t tune_setpoint;           // 工作点速度
+static uint8_t tune_rule;
+static int16_t tune_relay;              // 继电幅值d
+static int16_t tune_bias;               // 偏置输出u0
+static int32_t tune_bias_sum;
+static uint16_t tune_timer;
+static int32_t tune_speed_q4;           // 滤波后速度（Q4）
+static int8_t tune_output_high;         // 当前继电输出：1高，0低
+static uint16_t tune_last_switch;       // 上一次向上切换的时刻
+static uint8_t tune_cycles;             // 已完成的振荡周期数
+static int32_t tune_peak_max, tune_peak_min;  // 本周期速度极值（Q4）
+static uint32_t tune_period_sum;        // 周期累加（周期数）
+static int32_t tune_amp_sum_q4;         // 峰峰值累加（Q4）
+
+// 整定结果
+static float tune_ku, tune_tu;
+static float tune_kp, tune_ki, tune_kd;
+
+
+/**
+ * @brief 启动自整定
+ * @param speed 工作点速度（与 Encoder_Get_Speed 同单位）
+ * @param rule  整定规则（TUNE_RULE_xxx）
+ * @param relay 继电幅值d，<=0时使用默认值
+ */
+void Autotune_Start(int16_t speed, uint8_t rule, int16_t relay)
+{
+    if (tune_state != TUNE_IDLE || speed == 0)
+        return;
+
+    tune_setpoint = speed;
+    tune_rule = (rule <= TUNE_RULE_NO_OVERSHOOT) ? rule : TUNE_RULE_ZN_PID;
+    tune_relay = (relay > 0) ? relay : TUNE_DEFAULT_RELAY;
+    tune_timer = 0;
+    tune_bias_sum = 0;
+    tune_done = 0;
+    Speed_PID_Reset();
+    tune_state = TUNE_SETTLE;
+}
+
+
+void Autotune_Abort(void)
+{
+    if (tune_state != TUNE_IDLE)
+    {
+        tune_state = TUNE_IDLE;
+        Motor_Set_Speed(1, 0);
+    }
+}
+
+
+uint8_t Autotune_IsRunning(void)
+{
+    return tune_state != TUNE_IDLE;
+}
+
+
+/**
+ * @brief 根据 Ku、Tu 计算增益并应用
+ */
+static void Autotune_Apply(void)
+{
+    float kp, ti, td;
+
+    switch (tune_rule)
+    {
+    case TUNE_RULE_ZN_PI:
+        kp = 0.45f * tune_ku;  ti = tune_tu / 1.2f;  td = 0;
+        break;
+    case TUNE_RULE_TL_PID:
+        kp = tune_ku / 2.2f;   ti = 2.2f * tune_tu;  td = tune_tu / 6.3f;
+        break;
+    case TUNE_RULE_NO_OVERSHOOT:
+        kp = 0.2f * tune_ku;   ti = 0.5f * tune_tu;  td = tune_tu / 3.0f;
+        break;
+    default:
+        kp = 0.6f * tune_ku;   ti = 0.5f * tune_tu;  td = 0.125f * tune_tu;
+        break;
+    }
+
+    // 换算为增量式PID系数（周期T = 1）
+    tune_kp = kp;
+    tune_ki = kp / ti;
+    tune_kd = kp * td;
+
+    Speed_PID_SetParams(tune_kp, tune_ki, tune_kd);
+    Speed_PID_Reset();
+    GainSched_Invalidate();             // 调度开启时以调度表为准
+}
+
+
+/**
+ * @brief 结束整定
+ * @param ok 1成功，0失败
+ * 
+ * 成功时新增益已生效，电机继续以工作点速度闭环运行；
+ * 失败时停止电机，原增益保持不变。
+ */
+static void Autotune_Finish(uint8_t ok)
+{
+    tune_state = TUNE_IDLE;
+    tune_done = ok ? 1 : 2;
+    if (ok)
+    {
+        Autotune_Apply();
+    }
+    else
+    {
+        Motor_Set_Speed(1, 0);
+    }
+}
+
+
+/**
+ * @brief 自整定状态机，控制中断中每周期调用
+ * @param speed 电机1本周期速度
+ */
+void Autotune_Tick(int16_t speed)
+{
+    tune_timer++;
+
+    // 一阶低通（α=1/4）抑制速度量化噪声，避免继电器抖动切换
+    tune_speed_q4 += (((int32_t)speed << 4) - tune_speed_q4) >> 2;
+
+    switch (tune_state)
+    {
+    case TUNE_SETTLE:
+    {
+        int16_t output = Speed_PID_Compute(tune_setpoint, speed);
+        Motor_Set_Speed(1, output);
+
+        if (tune_timer > TUNE_SETTLE_TICKS - TUNE_BIAS_TICKS)
+        {
+            tune_bias_sum += output;
+        }
+        if (tune_timer >= TUNE_SETTLE_TICKS)
+        {
+            tune_bias = tune_bias_sum / TUNE_BIAS_TICKS;
+            tune_output_high = 1;
+            tune_cycles = 0;
+            tune_period_sum = 0;
+            tune_amp_sum_q4 = 0;
+            tune_peak_max = tune_peak_min = tune_speed_q4;
+            tune_last_switch = 0;
+            tune_timer = 0;
+            tune_state = TUNE_RELAY;
+        }
+        break;
+    }
+
+    case TUNE_RELAY:
+    {
+        int32_t error_q4 = ((int32_t)tune_setpoint << 4) - tune_speed_q4;
+
+        if (tune_speed_q4 > tune_peak_max) tune_peak_max = tune_speed_q4;
+        if (tune_speed_q4 < tune_peak_min) tune_peak_min = tune_speed_q4;
+
+        // 带回差继电器：误差越过 ±ε 才切换
+        if (!tune_output_high && error_q4 > TUNE_HYSTERESIS_Q4)
+        {
+            tune_output_high = 1;
+
+            // 以向上切换为周期边界
+            if (tune_last_switch != 0)
+            {
+                tune_cycles++;
+                if (tune_cycles > TUNE_SKIP_CYCLES)
+                {
+                    tune_period_sum += tune_timer - tune_last_switch;
+                    tune_amp_sum_q4 += tune_peak_max - tune_peak_min;
+                }
+            }
+            tune_last_switch = tune_timer;
+            tune_peak_max = tune_peak_min = tune_speed_q4;
+
+            if (tune_cycles >= TUNE_SKIP_CYCLES + TUNE_MEASURE_CYCLES)
+            {
+                float a = (float)tune_amp_sum_q4 / (2.0f * 16.0f * TUNE_MEASURE_CYCLES);
+                float eps = TUNE_HYSTERESIS_Q4 / 16.0f;
+                tune_tu = (float)tune_period_sum / TUNE_MEASURE_CYCLES;
+
+                if (a <= eps)
+                {
+                    Autotune_Finish(0);     // 振荡幅值不足，无法辨识
+                    return;
+                }
+                tune_ku = 4.0f * tune_relay / (3.14159265f * sqrtf(a * a - eps * eps));
+                Autotune_Finish(1);
+                return;
+            }
+        }
+        else if (tune_output_high && error_q4 < -TUNE_HYSTERESIS_Q4)
+        {
+            tune_output_high = 0;
+        }
+
+        if (tune_timer >= TUNE_TIMEOUT_TICKS)
+        {
+            Autotune_Finish(0);
+            return;
+        }
+
+        int16_t output = tune_output_high ? tune_bias + tune_relay : tune_bias - tune_relay;
+        Motor_Set_Speed(1, output);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief 查询整定是否刚完成（读后清除）
+ * @return 0未完成，1成功，2失败
+ */
+uint8_t Autotune_PollDone(void)
+{
+    uint8_t done = tune_done;
+    tune_done = 0;
+    return done;
+}
+
+
+/**
+ * @brief 串口输出整定结果
+ * 
+ * 格式：tune,<Ku>,<Tu周期数>,<Kp>,<Ki>,<Kd>\n
+ */
+void Autotune_Report(void)
+{
+    printf("tune,%.3f,%.1f,%.3f,%.4f,%.3f\n",
+           tune_ku, tune_tu, tune_kp, tune_ki, tune_kd);
+}
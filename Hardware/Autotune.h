@@ -0,0 +1,36 @@
+#ifndef __AUTOTUNE_H
+#define __AUTOTUNE_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 速度环继电反馈自整定模块接口说明（Åström–Hägglund）
+ *
+ * 流程：
+ *  1. 以当前PID将电机1稳定在工作点速度，取平均输出作为偏置u0
+ *  2. 输出在 u0±d 间切换（带回差的继电器），激发极限环振荡
+ *  3. 测量振荡周期Tu与幅值a，Ku = 4d / (π·sqrt(a² - ε²))
+ *  4. 按所选整定规则计算增益，调用 Speed_PID_SetParams 立即生效
+ *
+ * - Autotune_Start(speed, rule, d)  启动整定（仅速度模式）
+ * - Autotune_Abort()                中止并停止电机
+ * - Autotune_IsRunning()            运行中返回1（控制中断据此让出电机1）
+ * - Autotune_Tick(speed)            控制中断中每周期调用
+ * - Autotune_PollDone()             完成后返回一次：1成功，2失败
+ * - Autotune_Report()               串口输出 Ku、Tu 与计算出的增益
+ * ========================================================== */
+
+// 整定规则
+#define TUNE_RULE_ZN_PID        0   // Ziegler-Nichols PID
+#define TUNE_RULE_ZN_PI         1   // Ziegler-Nichols PI
+#define TUNE_RULE_TL_PID        2   // Tyreus-Luyben PID（更保守）
+#define TUNE_RULE_NO_OVERSHOOT  3   // Ziegler-Nichols 无超调 PID
+
+void Autotune_Start(int16_t speed, uint8_t rule, int16_t relay);
+void Autotune_Abort(void);
+uint8_t Autotune_IsRunning(void);
+void Autotune_Tick(int16_t speed);
+uint8_t Autotune_PollDone(void);
+void Autotune_Report(void);
+
+#endif
@@ -0,0 +1,187 @@
+#include "Baud.h"
+#include "Fmt.h"
+
+/* ==========================================================
+ * 串口波特率协商模块（Baud.c）
+ *
+ * 请求与确认在串口接收中断中到达，只记录标志；应答、切换和超时
+ * 判断都在 Baud_Poll（主循环）中完成，切换前等待 offer 应答发完，
+ * 保证上位机能以原速率收到。
+ *
+ * 72MHz 的 APB2 下 BRR = 72000000 / 波特率，表中速率误差均小于0.2%。
+ * ========================================================== */
+
+#define BAUD_IDLE           0       // 正常运行，监测错误率
+#define BAUD_OFFER          1       // 已接受请求，待发送 offer
+#define BAUD_SWITCH         2       // offer 发送中，发完即切换
+#define BAUD_CONFIRM        3       // 已切换，等待 @baud%ok
+
+static const uint32_t baud_rates[] =
+{
+    115200, 230400, 460800, 921600, 1000000, 1500000, 2000000
+};
+
+static volatile uint8_t baud_state = BAUD_IDLE;
+static volatile uint32_t baud_pending = 0;
+static volatile uint8_t baud_confirmed = 0;
+static volatile uint8_t baud_report = 0;
+static uint32_t baud_current = BAUD_DEFAULT;
+static uint32_t baud_previous = BAUD_DEFAULT;
+static uint32_t baud_deadline = 0;
+static uint32_t baud_window_start = 0;
+static uint32_t baud_window_errors = 0;     // 窗口起点的累计错误数
+
+
+/**
+ * @brief 发送应答：baud,<事件>,<速率>[,<附加值>]\n
+ * @param extra 附加值，小于0时不输出
+ */
+static void Baud_Reply(const char *event, uint32_t rate, int32_t extra)
+{
+    char line[40];
+    uint8_t n = 0;
+
+    for (const char *p = "baud,"; *p; p++) line[n++] = *p;
+    while (*event && n < 16) line[n++] = *event++;
+    line[n++] = ',';
+    n += Fmt_Uint(line + n, rate);
+    if (extra >= 0)
+    {
+        line[n++] = ',';
+        n += Fmt_Uint(line + n, extra);
+    }
+    line[n++] = '\n';
+    line[n] = '\0';
+    Baud_Port_Reply(line);
+}
+
+
+/**
+ * @brief 回到正常运行、恢复遥测并重新开始错误统计
+ */
+static void Baud_Restart_Window(uint32_t now)
+{
+    baud_state = BAUD_IDLE;
+    Baud_Port_Hold_Telemetry(0);
+    baud_window_start = now;
+    baud_window_errors = Baud_Port_Errors();
+}
+
+
+/**
+ * @brief 立即切换到指定速率（回退用，不等待发送完成）
+ */
+static void Baud_Switch_Now(uint32_t rate, uint32_t now)
+{
+    Baud_Port_Apply(rate);
+    baud_current = rate;
+    Baud_Restart_Window(now);
+}
+
+
+/**
+ * @brief 请求切换波特率（串口命令中调用）
+ * @return 1：已接受；0：速率不支持或上一次协商未结束
+ */
+uint8_t Baud_Request(uint32_t baud)
+{
+    if (baud_state != BAUD_IDLE)
+        return 0;
+
+    for (uint8_t i = 0; i < sizeof(baud_rates) / sizeof(baud_rates[0]); i++)
+    {
+        if (baud_rates[i] == baud)
+        {
+            baud_pending = baud;
+            baud_state = BAUD_OFFER;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+void Baud_Confirm(void)
+{
+    if (baud_state == BAUD_CONFIRM)
+    {
+        baud_confirmed = 1;
+    }
+}
+
+
+void Baud_Request_Report(void)
+{
+    baud_report = 1;
+}
+
+
+uint32_t Baud_Current(void)
+{
+    return baud_current;
+}
+
+
+/**
+ * @brief 推进协商状态并监测接收错误率（主循环任务中调用）
+ * @param now_ms 当前毫秒节拍
+ */
+void Baud_Poll(uint32_t now_ms)
+{
+    switch (baud_state)
+    {
+        case BAUD_OFFER:
+            Baud_Port_Hold_Telemetry(1);    // 此后只剩 offer 在发送缓冲中
+            Baud_Reply("offer", baud_pending, -1);
+            baud_state = BAUD_SWITCH;
+            break;
+
+        case BAUD_SWITCH:
+            if (Baud_Port_Tx_Idle())
+            {
+                baud_previous = baud_current;
+                baud_confirmed = 0;
+                baud_deadline = now_ms + BAUD_CONFIRM_MS;
+                Baud_Port_Apply(baud_pending);
+                baud_current = baud_pending;
+                baud_state = BAUD_CONFIRM;
+            }
+            break;
+
+        case BAUD_CONFIRM:
+            if (baud_confirmed)
+            {
+                Baud_Restart_Window(now_ms);
+                Baud_Reply("ok", baud_current, -1);
+            }
+            else if ((int32_t)(now_ms - baud_deadline) >= 0)
+            {
+                Baud_Switch_Now(baud_previous, now_ms);
+                Baud_Reply("revert", baud_current, -1);
+            }
+            break;
+
+        default:
+            if (now_ms - baud_window_start >= BAUD_WINDOW_MS)
+            {
+                uint32_t errors = Baud_Port_Errors() - baud_window_errors;
+                if (errors > BAUD_ERROR_LIMIT && baud_current != BAUD_DEFAULT)
+                {
+                    Baud_Switch_Now(BAUD_DEFAULT, now_ms);
+                    Baud_Reply("fallback", baud_current, (int32_t)errors);
+                }
+                else
+                {
+                    baud_window_start = now_ms;
+                    baud_window_errors += errors;
+                }
+            }
+            break;
+    }
+
+    if (baud_report)
+    {
+        baud_report = 0;
+        Baud_Reply("rate", baud_current, (int32_t)Baud_Port_Errors());
+    }
+}
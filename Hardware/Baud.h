@@ -0,0 +1,53 @@
+#ifndef __BAUD_H
+#define __BAUD_H
+
+#include <stdint.h>
+
+/* ==========================================================
+ * 串口波特率协商模块接口说明
+ *
+ * 协商过程（双方确认）：
+ *   1. 上位机以当前速率发送 @baud%<速率>
+ *   2. 下位机以当前速率回复 baud,offer,<速率>，发送完毕后切换
+ *   3. 上位机收到 offer 后切换，等待 BAUD_GUARD_MS（下位机在主循环中
+ *      发完 offer 才切换，有延迟）后以新速率发送 @baud%ok
+ *   4. 下位机回复 baud,ok,<速率>，协商完成；切换后 BAUD_CONFIRM_MS 内未确认则切回原速率
+ *      并回复 baud,revert,<原速率>
+ * 上位机在 BAUD_CONFIRM_MS 内未收到 baud,ok 也应切回原速率。
+ *
+ * 从接受请求到协商结束（ok/revert）暂停遥测，保证 offer 之后发送缓冲保持空闲，
+ * 改写速率时不会有遥测帧正在发送。
+ *
+ * 运行中每 BAUD_WINDOW_MS 统计一次接收错误（ORE/FE/NE），非默认速率下
+ * 超过 BAUD_ERROR_LIMIT 则回退到 BAUD_DEFAULT 并回复
+ * baud,fallback,<速率>,<错误数>；上位机长时间收不到有效数据时同样回退。
+ *
+ * 只依赖 stdint.h 与 Fmt，上位机测试（Tools/baud_pty.c）直接编译本文件；
+ * 硬件相关操作由下面的 Baud_Port_* 接口提供（固件中在 Serial.c 实现）。
+ *
+ * - Baud_Request(baud)     命令 @baud%<速率>，返回1表示接受
+ * - Baud_Confirm()         命令 @baud%ok
+ * - Baud_Request_Report()  命令 @baud%?，回复 baud,rate,<速率>,<累计错误>
+ * - Baud_Poll(now_ms)      主循环任务中调用，推进协商并监测错误率
+ * ========================================================== */
+
+#define BAUD_DEFAULT        115200
+#define BAUD_CONFIRM_MS     500     // 切换后等待确认的时间
+#define BAUD_GUARD_MS       30      // 上位机收到 offer 到发送确认的最短间隔
+#define BAUD_WINDOW_MS      1000    // 错误率统计窗口
+#define BAUD_ERROR_LIMIT    8       // 每窗口允许的接收错误数
+
+// 平台接口
+void Baud_Port_Apply(uint32_t baud);        // 设置波特率
+uint8_t Baud_Port_Tx_Idle(void);            // 发送缓冲已空且最后一个字节已移出
+uint32_t Baud_Port_Errors(void);            // 累计接收错误数（单调递增）
+void Baud_Port_Hold_Telemetry(uint8_t hold); // 协商期间暂停/恢复遥测输出
+void Baud_Port_Reply(const char *line);     // 发送一行应答（含换行）
+
+uint8_t Baud_Request(uint32_t baud);
+void Baud_Confirm(void);
+void Baud_Request_Report(void);
+void Baud_Poll(uint32_t now_ms);
+uint32_t Baud_Current(void);
+
+#endif
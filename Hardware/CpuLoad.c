@@ -0,0 +1,261 @@
+#include "stm32f10x.h"
+#include "CpuLoad.h"
+#include "Serial.h"
+#include "Delay.h"
+#include <stdio.h>
+
+/* ==========================================================
+ * CPU负载统计模块（CpuLoad.c）
+ *
+ * 维护一个上下文栈：栈底为主循环，每次进入中断压栈、退出出栈。
+ * 每次切换时把距上次打点的周期数记给栈顶上下文，因此各上下文
+ * 累计的是独占时间，嵌套中断不会重复计算。打点过程关中断，
+ * 每次约几十个周期。
+ *
+ * QEnc 边沿中断处于最高抢占级，按编码器边沿频率触发，不能每次关中断
+ * 打点；它只在出口把自身周期数累加到 exti，并把打点时刻后移同样的
+ * 周期数，使被抢占的上下文不计入这段时间。同级中断不互相嵌套，
+ * 其余打点代码都在关中断下读写打点时刻，因此无需额外保护。
+ *
+ * 窗口结算在 SysTick 中进行，10个窗口组成1秒滑动平均。
+ * ========================================================== */
+
+#define CPU_WINDOW_MS       100
+#define CPU_WINDOWS         10      // 滑动平均窗口数（1秒）
+
+static const char *const cpu_ctx_name[CPU_CTX_COUNT] =
+{
+    "main", "idle", "control", "pwm", "usart", "exti", "pendsv", "systick"
+};
+
+static uint8_t cpu_stack[CPU_STACK_DEPTH] = { CPU_CTX_MAIN };
+static uint8_t cpu_depth = 0;
+static volatile uint32_t cpu_mark = 0;                  // 上次打点时刻（DWT）
+static volatile uint32_t cpu_exti_cycles = 0;           // 当前窗口 QEnc 边沿中断周期数
+static uint32_t cpu_accum[CPU_CTX_COUNT];               // 当前窗口累计周期数
+static uint32_t cpu_window_start = 0;
+static uint16_t cpu_history[CPU_WINDOWS][CPU_CTX_COUNT];    // 各窗口占比（‰）
+static uint8_t cpu_history_index = 0;
+static uint16_t cpu_peak[CPU_CTX_COUNT];                // 单窗口峰值（‰）
+static uint16_t cpu_ms = 0;
+static volatile uint8_t cpu_report = 0;
+static uint8_t cpu_depth_max = 0;                       // 最大嵌套深度（含栈底）
+static uint8_t cpu_deepest[CPU_STACK_DEPTH];            // 最大嵌套时的上下文链
+static uint32_t cpu_sp_min[CPU_CTX_COUNT];              // 各上下文进入时的最低MSP，0为未进入过
+
+
+/**
+ * @brief 进入上下文（中断入口或休眠前调用）
+ */
+void CpuLoad_Enter(uint8_t ctx)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t now = DWT_CYCCNT;
+    cpu_accum[cpu_stack[cpu_depth]] += now - cpu_mark;
+    cpu_mark = now;
+    if (cpu_depth < CPU_STACK_DEPTH - 1)
+    {
+        cpu_stack[++cpu_depth] = ctx;
+    }
+
+    // 嵌套深度与进入时的栈位置，供栈余量分析
+    if (cpu_depth > cpu_depth_max)
+    {
+        cpu_depth_max = cpu_depth;
+        for (uint8_t i = 0; i <= cpu_depth; i++)
+        {
+            cpu_deepest[i] = cpu_stack[i];
+        }
+    }
+    uint32_t sp = __get_MSP();
+    if (cpu_sp_min[ctx] == 0 || sp < cpu_sp_min[ctx])
+    {
+        cpu_sp_min[ctx] = sp;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief 退出当前上下文（中断出口或休眠后调用）
+ */
+void CpuLoad_Exit(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t now = DWT_CYCCNT;
+    cpu_accum[cpu_stack[cpu_depth]] += now - cpu_mark;
+    cpu_mark = now;
+    if (cpu_depth > 0)
+    {
+        cpu_depth--;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief 边沿中断出口记账（仅供抢占优先级0、互不嵌套的 EXTI 中断调用）
+ * @param cycles 本次中断执行周期数
+ */
+void CpuLoad_Charge_Exti(uint32_t cycles)
+{
+    cpu_mark += cycles;
+    cpu_exti_cycles += cycles;
+}
+
+
+/**
+ * @brief 结算一个窗口（SysTick 中调用，此时栈顶为 SysTick 自身）
+ */
+static void CpuLoad_Close_Window(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint32_t now = DWT_CYCCNT;
+    cpu_accum[cpu_stack[cpu_depth]] += now - cpu_mark;
+    cpu_mark = now;
+    cpu_accum[CPU_CTX_EXTI] += cpu_exti_cycles;
+    cpu_exti_cycles = 0;
+    uint32_t unit = (now - cpu_window_start) / 1000;
+    cpu_window_start = now;
+
+    uint16_t *slot = cpu_history[cpu_history_index];
+    for (uint8_t i = 0; i < CPU_CTX_COUNT; i++)
+    {
+        uint32_t permille = unit ? cpu_accum[i] / unit : 0;
+        if (permille > 1000) permille = 1000;
+        slot[i] = permille;
+        cpu_accum[i] = 0;
+        if (permille > cpu_peak[i]) cpu_peak[i] = permille;
+    }
+    cpu_history_index = (cpu_history_index + 1) % CPU_WINDOWS;
+
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief 1ms节拍处理（SysTick_Handler 中调用）
+ */
+void CpuLoad_Tick(void)
+{
+    if (++cpu_ms >= CPU_WINDOW_MS)
+    {
+        cpu_ms = 0;
+        CpuLoad_Close_Window();
+    }
+}
+
+
+/**
+ * @brief 上下文最近1秒平均占比（‰）
+ */
+static uint16_t CpuLoad_Average(uint8_t ctx)
+{
+    uint32_t sum = 0;
+    for (uint8_t w = 0; w < CPU_WINDOWS; w++)
+    {
+        sum += cpu_history[w][ctx];
+    }
+    return sum / CPU_WINDOWS;
+}
+
+
+/**
+ * @brief 最近1秒CPU忙碌比例
+ * @return 1000 - 空闲占比（‰）
+ */
+uint16_t CpuLoad_Get_Busy(void)
+{
+    return 1000 - CpuLoad_Average(CPU_CTX_IDLE);
+}
+
+
+/**
+ * @brief 清零峰值、最大嵌套深度及栈位置记录
+ */
+void CpuLoad_Reset_Peak(void)
+{
+    for (uint8_t i = 0; i < CPU_CTX_COUNT; i++)
+    {
+        cpu_peak[i] = 0;
+        cpu_sp_min[i] = 0;
+    }
+    cpu_depth_max = 0;
+}
+
+
+/**
+ * @brief 最大嵌套深度
+ * @param chain 输出最大嵌套时的上下文链（栈底在前），长度至少 CPU_STACK_DEPTH，可为NULL
+ * @return 栈底之上的上下文层数
+ */
+uint8_t CpuLoad_Get_Nesting(uint8_t *chain)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    uint8_t depth = cpu_depth_max;
+    if (chain)
+    {
+        for (uint8_t i = 0; i <= depth; i++)
+        {
+            chain[i] = cpu_deepest[i];
+        }
+    }
+
+    __set_PRIMASK(primask);
+    return depth;
+}
+
+
+/**
+ * @brief 上下文进入时的最低MSP
+ * @return 地址，0表示该上下文尚未进入过
+ */
+uint32_t CpuLoad_Get_Entry_SP(uint8_t ctx)
+{
+    return ctx < CPU_CTX_COUNT ? cpu_sp_min[ctx] : 0;
+}
+
+
+const char *CpuLoad_Ctx_Name(uint8_t ctx)
+{
+    return ctx < CPU_CTX_COUNT ? cpu_ctx_name[ctx] : "?";
+}
+
+
+void CpuLoad_Request_Report(void)
+{
+    cpu_report = 1;
+}
+
+
+/**
+ * @brief 输出负载统计（主循环任务中调用）
+ *
+ * 格式：cpu,<上下文>,<1秒平均‰>,<最近窗口‰>,<峰值‰>\n
+ *       cpu,busy,<1秒平均忙碌‰>\n
+ */
+void CpuLoad_PollReport(void)
+{
+    if (!cpu_report)
+        return;
+    cpu_report = 0;
+
+    Serial_Telemetry_Enable(0);
+    uint8_t last = (cpu_history_index + CPU_WINDOWS - 1) % CPU_WINDOWS;
+    for (uint8_t i = 0; i < CPU_CTX_COUNT; i++)
+    {
+        printf("cpu,%s,%u,%u,%u\n", cpu_ctx_name[i], CpuLoad_Average(i), cpu_history[last][i], cpu_peak[i]);
+    }
+    printf("cpu,busy,%u\n", CpuLoad_Get_Busy());
+    Serial_Telemetry_Enable(1);
+}
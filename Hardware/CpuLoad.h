@@ -0,0 +1,64 @@
+#ifndef __CPULOAD_H
+#define __CPULOAD_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * CPU负载统计模块接口说明
+ *
+ * 各中断入口/出口及主循环休眠前后用 DWT 周期计数打点，按执行
+ * 上下文分别累计独占时间（被抢占的时间记入抢占者），每100ms
+ * 结算一个窗口，给出最近1秒滑动平均、最近窗口值及峰值（‰）。
+ *
+ * - CPULOAD_ENTER(ctx) / CPULOAD_EXIT()  中断或休眠区首尾打点
+ * - CPULOAD_CHARGE_EXTI(cycles)          QEnc 边沿中断（抢占优先级0）出口记账：不关中断、
+ *                                        不入上下文栈，只把本次周期数从被抢占者移给 exti
+ * - CpuLoad_Tick()                       1ms节拍中调用，满100ms结算窗口
+ * - CpuLoad_Get_Busy()                   最近1秒非空闲比例（‰）
+ * - CpuLoad_Reset_Peak()                 清零峰值、最大嵌套记录
+ * - CpuLoad_Get_Nesting(chain)           最大嵌套深度及当时的上下文链
+ * - CpuLoad_Get_Entry_SP(ctx)            上下文进入时的最低MSP（栈余量分析用）
+ * - CpuLoad_Request_Report()             请求输出统计
+ * - CpuLoad_PollReport()                 有报告请求时输出（主循环任务中调用）
+ *
+ * 未打点的中断（DMA等）时间记入被其抢占的上下文。
+ * 置 CPULOAD_ENABLE 为0可去掉全部打点开销。
+ * ========================================================== */
+
+#define CPULOAD_ENABLE      1
+
+// 执行上下文
+#define CPU_CTX_MAIN        0       // 主循环任务（含调度开销）
+#define CPU_CTX_IDLE        1       // __WFI 休眠
+#define CPU_CTX_CONTROL     2       // TIM1_UP 控制中断
+#define CPU_CTX_PWM         3       // TIM2 方向提交中断
+#define CPU_CTX_USART       4       // USART1 收发中断
+#define CPU_CTX_EXTI        5       // QEnc 边沿中断
+#define CPU_CTX_PENDSV      6       // PendSV 下半部
+#define CPU_CTX_SYSTICK     7       // SysTick 节拍
+#define CPU_CTX_COUNT       8
+#define CPU_STACK_DEPTH     8       // 上下文栈深度（含栈底）
+
+#if CPULOAD_ENABLE
+#define CPULOAD_ENTER(ctx)  CpuLoad_Enter(ctx)
+#define CPULOAD_EXIT()      CpuLoad_Exit()
+#define CPULOAD_CHARGE_EXTI(cycles) CpuLoad_Charge_Exti(cycles)
+#else
+#define CPULOAD_ENTER(ctx)
+#define CPULOAD_EXIT()
+#define CPULOAD_CHARGE_EXTI(cycles) ((void)(cycles))
+#endif
+
+void CpuLoad_Enter(uint8_t ctx);
+void CpuLoad_Exit(void);
+void CpuLoad_Charge_Exti(uint32_t cycles);
+void CpuLoad_Tick(void);
+uint16_t CpuLoad_Get_Busy(void);
+void CpuLoad_Reset_Peak(void);
+uint8_t CpuLoad_Get_Nesting(uint8_t *chain);
+uint32_t CpuLoad_Get_Entry_SP(uint8_t ctx);
+const char *CpuLoad_Ctx_Name(uint8_t ctx);
+void CpuLoad_Request_Report(void);
+void CpuLoad_PollReport(void);
+
+#endif
@@ -0,0 +1,62 @@
+#include "stm32f10x.h"
+#include "Defer.h"
+
+/* ==========================================================
+ * 延后处理模块（Defer.c）
+ *
+ * 待处理位图由各中断置位，PendSV 取走后清零再逐位执行。
+ * PendSV 优先级最低，可被所有外设中断抢占；处理函数执行期间
+ * 新置位的工作会再次挂起 PendSV，退出后立即重新进入。
+ * ========================================================== */
+
+static volatile uint32_t defer_pending = 0;
+static void (*defer_handlers[DEFER_MAX])(void);
+
+
+void Defer_Init(void)
+{
+    NVIC_SetPriority(PendSV_IRQn, (1 << __NVIC_PRIO_BITS) - 1);   // 最低优先级
+}
+
+
+void Defer_Register(uint8_t id, void (*handler)(void))
+{
+    if (id < DEFER_MAX)
+    {
+        defer_handlers[id] = handler;
+    }
+}
+
+
+/**
+ * @brief 置位待处理工作并挂起 PendSV
+ * @param id 工作编号（DEFER_xxx）
+ */
+void Defer_Post(uint8_t id)
+{
+    __disable_irq();
+    defer_pending |= 1UL << id;
+    __enable_irq();
+
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+
+/**
+ * @brief 执行全部已置位的工作（仅在 PendSV_Handler 中调用）
+ */
+void Defer_Run(void)
+{
+    __disable_irq();
+    uint32_t pending = defer_pending;
+    defer_pending = 0;
+    __enable_irq();
+
+    for (uint8_t id = 0; pending; id++, pending >>= 1)
+    {
+        if ((pending & 1) && defer_handlers[id])
+        {
+            defer_handlers[id]();
+        }
+    }
+}
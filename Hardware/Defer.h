@@ -0,0 +1,31 @@
+#ifndef __DEFER_H
+#define __DEFER_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 延后处理模块接口说明（PendSV 下半部）
+ *
+ * 中断上半部只做采样、计算与输出，格式化输出、浮点整定等耗时且
+ * 不要求确定时刻的工作置位待处理位图后交给最低优先级的 PendSV
+ * 执行，不再占用控制中断与串口接收的响应时间。
+ *
+ * - Defer_Init()             设置 PendSV 为最低优先级
+ * - Defer_Register(id, fn)   登记某一位对应的处理函数
+ * - Defer_Post(id)           置位并触发 PendSV（任意中断中可调用）
+ * - Defer_Run()              PendSV_Handler 中调用，依次执行已置位的处理函数
+ *
+ * 同一位在处理前多次置位只执行一次，处理函数须读取最新状态。
+ * ========================================================== */
+
+#define DEFER_TELEMETRY     0       // 周期遥测帧格式化发送
+#define DEFER_ADAPT         1       // 自适应极点配置（浮点）
+#define DEFER_MEASURE       2       // 测量采集帧格式化发送
+#define DEFER_MAX           8
+
+void Defer_Init(void);
+void Defer_Register(uint8_t id, void (*handler)(void));
+void Defer_Post(uint8_t id);
+void Defer_Run(void);
+
+#endif
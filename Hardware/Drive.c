@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include "Drive.h"
+#include "Trig.h"
+
+/* ==========================================================
+ * 差速底盘运动学与里程计（Drive.c）
+ *
+ * 几何参数与速度命令由串口接收中断写入、速度环读取，与 Gear.c 相同
+ * 按版本号复制：复制期间被串口中断改写则重新复制。轮速目标只在
+ * 命令或参数变化时重新计算（Q8），速度环每周期只取结果。
+ *
+ * 速度环目标为整数，低速时直接取整误差很大（1 rad/s 只有 ±1，更小的
+ * 命令为0）。每周期把 Q8 目标加上上周期的余数再取整，余数留到下周期，
+ * 整数目标在相邻周期间交替，平均值等于 Q8 目标，由速度环积分项跟随。
+ *
+ * 里程计由速度环写、主循环读，写入方每次更新后序号加一，读取方
+ * 复制前后序号不同（复制中被中断更新）则重新复制。
+ *
+ * 航向以 Q16 的二进制角（64位）累加：每脉冲差对应的角度（Q16）
+ * 在设置几何参数时算好，每周期只做整数乘法，不丢弃余数。
+ * ========================================================== */
+
+// 2^32 / 2π × 1000：二进制角 × mm·(脉冲/m)，除以 轮距×每米脉冲数 得每脉冲差的航向变化
+#define DRIVE_ANGLE_K           683565275576LL
+
+// 速度单位换算：mm/s × 2000 → Encoder_Get_Speed 单位（Q8）
+//   × 每米脉冲数 / 1000 (脉冲/s) / 1000 (脉冲/ms) × 1.85 × 256 / 2000 = × 每米脉冲数 × 37 / 156250000
+#define DRIVE_SPEED_NUM         37
+#define DRIVE_SPEED_DEN         156250000LL
+
+// 配置（串口中断写）
+static volatile uint8_t cfg_version = 0;
+static uint32_t cfg_cpm = DRIVE_COUNTS_PER_M;
+static uint16_t cfg_track = DRIVE_TRACK_MM;
+static int16_t cfg_wheel_max = DRIVE_WHEEL_MAX;
+static int64_t cfg_angle_q16 = (DRIVE_ANGLE_K * 65536 + (int64_t)DRIVE_COUNTS_PER_M * DRIVE_TRACK_MM / 2) /
+                               ((int64_t)DRIVE_COUNTS_PER_M * DRIVE_TRACK_MM);
+static int16_t cfg_v = 0;
+static int16_t cfg_w = 0;
+
+// 运行参数（速度环）
+static uint8_t drive_version = 0xFF;        // 与 cfg_version 不同，首次调用时复制
+static uint32_t drive_cpm;
+static int64_t drive_angle_q16;             // 每脉冲差的航向变化（Q16 二进制角）
+static int32_t drive_target1 = 0;         // 轮速目标（Q8）
+static int32_t drive_target2 = 0;
+static int32_t drive_frac1 = 0;           // 取整余数（Q8，±128 以内）
+static int32_t drive_frac2 = 0;
+static uint8_t drive_scaled = 0;
+
+// 里程计（速度环写）
+static int64_t odom_x = 0;                  // Q16 脉冲
+static int64_t odom_y = 0;
+static uint64_t odom_heading = 0;           // Q16 二进制角
+static int32_t odom_last1 = 0;
+static int32_t odom_last2 = 0;
+static volatile uint8_t odom_rebase = 1;    // 首次调用时只记录位置
+static volatile uint8_t odom_reset_req = 0;
+static volatile uint32_t odom_seq = 0;
+
+// 输出（主循环）
+static volatile uint16_t stream_period = 0; // ms，0 关闭
+static volatile uint8_t stream_restart = 0;
+static uint32_t stream_due = 0;
+static volatile uint8_t drive_report = 0;
+
+
+static int64_t Drive_Angle_Q16(uint32_t counts_per_m, uint16_t track_mm)
+{
+    uint64_t den = (uint64_t)counts_per_m * track_mm;
+    return (int64_t)(((uint64_t)DRIVE_ANGLE_K * 65536 + den / 2) / den);
+}
+
+
+static int16_t Drive_Round_Q8(int64_t v_q8)
+{
+    return (int16_t)(v_q8 >= 0 ? (v_q8 + 128) >> 8 : -((-v_q8 + 128) >> 8));
+}
+
+
+// Q16 脉冲 → mm，四舍五入
+static int32_t Drive_To_Mm(int64_t q16, uint32_t cpm)
+{
+    int64_t den = (int64_t)cpm << 16;
+    int64_t num = q16 * 1000;
+    return (int32_t)(num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den));
+}
+
+
+/**
+ * @brief 复制配置并重新计算轮速目标（速度环中调用）
+ */
+static void Drive_Load_Config(void)
+{
+    while (drive_version != cfg_version)
+    {
+        uint8_t version = cfg_version;
+        uint32_t cpm = cfg_cpm;
+        int64_t track = cfg_track;
+        int64_t limit = (int64_t)cfg_wheel_max << 8;
+        int64_t v = cfg_v, w = cfg_w;
+        drive_angle_q16 = cfg_angle_q16;
+        drive_cpm = cpm;
+        drive_version = version;
+
+        // 轮速（mm/s × 2000），换算为速度单位（Q8）
+        int64_t t1 = (v * 2000 - w * track) * cpm * DRIVE_SPEED_NUM / DRIVE_SPEED_DEN;
+        int64_t t2 = (v * 2000 + w * track) * cpm * DRIVE_SPEED_NUM / DRIVE_SPEED_DEN;
+        int64_t peak1 = t1 < 0 ? -t1 : t1;
+        int64_t peak2 = t2 < 0 ? -t2 : t2;
+        int64_t peak = peak1 > peak2 ? peak1 : peak2;
+
+        // 超过上限时两轮同比例缩小，保持转弯半径
+        drive_scaled = peak > limit;
+        if (drive_scaled)
+        {
+            t1 = t1 * limit / peak;
+            t2 = t2 * limit / peak;
+        }
+        drive_target1 = (int32_t)t1;
+        drive_target2 = (int32_t)t2;
+    }
+}
+
+
+uint8_t Drive_Set_Geometry(uint32_t counts_per_m, uint16_t track_mm)
+{
+    if (counts_per_m < DRIVE_CPM_MIN || counts_per_m > DRIVE_CPM_MAX ||
+        track_mm < DRIVE_TRACK_MIN || track_mm > DRIVE_TRACK_MAX)
+        return 0;
+    cfg_cpm = counts_per_m;
+    cfg_track = track_mm;
+    cfg_angle_q16 = Drive_Angle_Q16(counts_per_m, track_mm);
+    cfg_version++;
+    return 1;
+}
+
+
+void Drive_Set_Wheel_Max(int16_t max)
+{
+    cfg_wheel_max = max > 0 ? max : 0;
+    cfg_version++;
+}
+
+
+/**
+ * @brief 设置线速度与角速度命令（串口接收中断中调用）
+ * @param v_mm_s 线速度（mm/s，前进为正）
+ * @param w_mrad_s 角速度（mrad/s，逆时针为正）
+ */
+void Drive_Set_Velocity(int16_t v_mm_s, int16_t w_mrad_s)
+{
+    cfg_v = v_mm_s;
+    cfg_w = w_mrad_s;
+    cfg_version++;
+}
+
+
+// Q8 目标加余数取整，余数留到下周期
+static int16_t Drive_Dither(int32_t target_q8, int32_t *frac)
+{
+    int32_t sum = target_q8 + *frac;
+    int16_t out = Drive_Round_Q8(sum);
+    *frac = sum - ((int32_t)out << 8);
+    return out;
+}
+
+
+/**
+ * @brief 取两轮速度目标（模式4速度环中每1ms调用）
+ * @note 每次调用推进取整余数，多周期平均等于 Q8 目标
+ * @return 1：命令超过轮速上限，已按比例缩小
+ */
+uint8_t Drive_Wheel_Targets(int16_t *target1, int16_t *target2)
+{
+    Drive_Load_Config();
+    *target1 = Drive_Dither(drive_target1, &drive_frac1);
+    *target2 = Drive_Dither(drive_target2, &drive_frac2);
+    return drive_scaled;
+}
+
+
+/**
+ * @brief 里程计积分（速度环中每1ms调用）
+ * @param pos1 左轮（电机1）累计位置
+ * @param pos2 右轮（电机2）累计位置
+ */
+void Drive_Odom_Tick(int32_t pos1, int32_t pos2)
+{
+    Drive_Load_Config();
+
+    if (odom_reset_req)
+    {
+        odom_reset_req = 0;
+        odom_x = 0;
+        odom_y = 0;
+        odom_heading = 0;
+        odom_seq++;
+    }
+
+    int32_t dl = (int32_t)((uint32_t)pos1 - (uint32_t)odom_last1);
+    int32_t dr = (int32_t)((uint32_t)pos2 - (uint32_t)odom_last2);
+    odom_last1 = pos1;
+    odom_last2 = pos2;
+
+    // 首次调用或累计位置被清零（模式切换）时只重新对齐，不积分
+    if (odom_rebase)
+    {
+        odom_rebase = 0;
+        return;
+    }
+    if (dl > DRIVE_STEP_MAX || dl < -DRIVE_STEP_MAX || dr > DRIVE_STEP_MAX || dr < -DRIVE_STEP_MAX)
+        return;
+    if (dl == 0 && dr == 0)
+        return;
+
+    // 中点航向：θ + dθ/2
+    int64_t dth = (int64_t)(dr - dl) * drive_angle_q16;
+    uint32_t mid = (uint32_t)((odom_heading + (uint64_t)(dth / 2)) >> 16);
+
+    // (dL+dR)/2 × Q15 → Q16 脉冲，乘积不舍入
+    odom_x += (int64_t)(dl + dr) * Trig_Cos_Q15(mid);
+    odom_y += (int64_t)(dl + dr) * Trig_Sin_Q15(mid);
+    odom_heading += (uint64_t)dth;
+    odom_seq++;
+}
+
+
+void Drive_Odom_Rebase(void)
+{
+    odom_rebase = 1;
+}
+
+
+void Drive_Reset_Pose(void)
+{
+    odom_reset_req = 1;
+}
+
+
+/**
+ * @brief 读取位姿（主循环中调用）
+ */
+void Drive_Get_Pose(Drive_Pose *pose)
+{
+    uint32_t seq;
+    int64_t x, y;
+    uint64_t heading;
+    uint32_t cpm;
+
+    do
+    {
+        seq = odom_seq;
+        x = odom_x;
+        y = odom_y;
+        heading = odom_heading;
+        cpm = drive_cpm;
+    } while (seq != odom_seq);
+
+    if (cpm == 0)
+        cpm = cfg_cpm;              // 速度环尚未运行
+    pose->x_mm = Drive_To_Mm(x, cpm);
+    pose->y_mm = Drive_To_Mm(y, cpm);
+    pose->heading = (uint32_t)(heading >> 16);
+    pose->heading_cdeg = (int16_t)(((int64_t)(int32_t)pose->heading * 18000) >> 31);
+}
+
+
+void Drive_Set_Stream(uint16_t hz)
+{
+    if (hz > DRIVE_STREAM_MAX_HZ)
+        hz = DRIVE_STREAM_MAX_HZ;
+    stream_period = hz ? 1000 / hz : 0;
+    stream_restart = 1;
+}
+
+
+void Drive_Request_Report(void)
+{
+    drive_report = 1;
+}
+
+
+static void Drive_Print_Pose(uint32_t now)
+{
+    Drive_Pose pose;
+    Drive_Get_Pose(&pose);
+    printf("odom,%lu,%ld,%ld,%d\n", (unsigned long)now, (long)pose.x_mm, (long)pose.y_mm, pose.heading_cdeg);
+}
+
+
+/**
+ * @brief 输出位姿与报告（主循环中调用）
+ * @param now 当前时间（ms）
+ *
+ * 格式：odom,<时间ms>,<x mm>,<y mm>,<航向0.01°>\n
+ *       drv,<每米脉冲数>,<轮距mm>,<轮速上限>,<线速度>,<角速度>,<左轮目标>,<右轮目标>,<已缩放>,<输出周期ms>\n
+ *       轮速目标为取整前的值，保留两位小数
+ */
+void Drive_PollReport(uint32_t now)
+{
+    uint16_t period = stream_period;
+
+    if (stream_restart)
+    {
+        stream_restart = 0;
+        stream_due = now;
+    }
+    if (period && (int32_t)(now - stream_due) >= 0)
+    {
+        Drive_Print_Pose(now);
+        stream_due += period;
+        if ((int32_t)(now - stream_due) >= 0)
+            stream_due = now + period;      // 主循环被阻塞过，不补发
+    }
+
+    if (!drive_report)
+        return;
+    drive_report = 0;
+
+    printf("drv,%lu,%u,%d,%d,%d,%.2f,%.2f,%u,%u\n", (unsigned long)cfg_cpm, cfg_track, cfg_wheel_max,
+           cfg_v, cfg_w, drive_target1 / 256.0f, drive_target2 / 256.0f, drive_scaled, period);
+    Drive_Print_Pose(now);
+}
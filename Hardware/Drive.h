@@ -0,0 +1,76 @@
+#ifndef __DRIVE_H
+#define __DRIVE_H
+
+#include <stdint.h>
+
+/* ==========================================================
+ * 差速底盘运动学与里程计接口说明（模式4）
+ *
+ * 电机1为左轮、电机2为右轮，两轮前进方向均为正转（编码器计数增加）。
+ *
+ * 运动学：上位机给出线速度 v（mm/s）与角速度 ω（mrad/s，逆时针为正），
+ *   左轮 = v - ω·轮距/2，右轮 = v + ω·轮距/2
+ * 换算为速度环目标（Encoder_Get_Speed 的单位，每ms脉冲数×1.85），内部保留
+ * Q8 小数，每周期带余数取整，整数目标的平均值等于换算结果。
+ * 任一轮超过轮速上限时两轮按同一比例缩小，转弯半径不变、只降低速度，
+ * 而不是各自限幅使轨迹变形。
+ *
+ * 里程计：速度环每1ms由两轮编码器增量积分位姿（不分模式，轮子被推动也计入），
+ *   d = (dL + dR)/2，dθ = (dR - dL)/轮距
+ *   x += d·cos(θ + dθ/2)，y += d·sin(θ + dθ/2)，θ += dθ
+ * 全部为定点运算：航向为32位二进制角（2^32 = 360°，自然回绕），
+ * 正余弦查表（System/Trig.c），x、y 为 Q16 脉冲的 64 位累加，
+ * 每周期的乘积不经舍入，长时间运行不累积截断误差。
+ * 位姿以 x 轴为开机（或清零）时的车头方向。
+ *
+ * 位姿输出：主循环按设定频率输出 odom,<时间ms>,<x mm>,<y mm>,<航向0.01°>，
+ * 航向范围 -18000 ~ 17999。
+ *
+ * 只依赖 stdint/stdio 与 Trig，上位机测试（Tools/odom_check.c）直接编译本文件。
+ *
+ * - Drive_Set_Geometry(cpm, track)     每米脉冲数、轮距（mm），返回0表示不合法
+ * - Drive_Set_Wheel_Max(max)           轮速上限（速度单位）
+ * - Drive_Set_Velocity(v, w)           线速度、角速度命令（串口中断中调用）
+ * - Drive_Wheel_Targets(t1, t2)        模式4速度环中每1ms调用，返回1表示已按上限缩放
+ * - Drive_Odom_Tick(pos1, pos2)        速度环中每1ms调用
+ * - Drive_Odom_Rebase()                编码器累计位置清零后调用，位姿不变
+ * - Drive_Reset_Pose()                 位姿清零
+ * - Drive_Get_Pose(pose)               读取位姿（主循环中调用）
+ * - Drive_Set_Stream(hz)               位姿输出频率（0关闭，最高 DRIVE_STREAM_MAX_HZ）
+ * - Drive_Request_Report()             命令 @drv%?
+ * - Drive_PollReport(now)              主循环中调用，now 为当前时间（ms）
+ * ========================================================== */
+
+// 默认几何参数按 65mm 轮径、每圈 1560 脉冲、轮距 160mm 估算，实际底盘用 @drv%g 设置
+#define DRIVE_COUNTS_PER_M      7640
+#define DRIVE_TRACK_MM          160
+#define DRIVE_WHEEL_MAX         30          // 默认轮速上限（速度单位）
+
+#define DRIVE_CPM_MIN           100         // 每米脉冲数范围
+#define DRIVE_CPM_MAX           1000000L
+#define DRIVE_TRACK_MIN         20          // 轮距范围（mm）
+#define DRIVE_TRACK_MAX         5000
+#define DRIVE_STEP_MAX          1000        // 每周期编码器增量超过此值视为位置被清零
+#define DRIVE_STREAM_MAX_HZ     100         // 主循环命令任务 10ms 一次
+
+typedef struct
+{
+    int32_t x_mm;
+    int32_t y_mm;
+    int16_t heading_cdeg;   // 航向（0.01°）
+    uint32_t heading;       // 航向（二进制角）
+} Drive_Pose;
+
+uint8_t Drive_Set_Geometry(uint32_t counts_per_m, uint16_t track_mm);
+void Drive_Set_Wheel_Max(int16_t max);
+void Drive_Set_Velocity(int16_t v_mm_s, int16_t w_mrad_s);
+uint8_t Drive_Wheel_Targets(int16_t *target1, int16_t *target2);
+void Drive_Odom_Tick(int32_t pos1, int32_t pos2);
+void Drive_Odom_Rebase(void);
+void Drive_Reset_Pose(void);
+void Drive_Get_Pose(Drive_Pose *pose);
+void Drive_Set_Stream(uint16_t hz);
+void Drive_Request_Report(void);
+void Drive_PollReport(uint32_t now);
+
+#endif
@@ -1,10 +1,12 @@
 #include "stm32f10x.h"
+#include "QEnc.h"
 
 /* ==========================================================
  * 编码器驱动模块（Encoder.c）
  * 功能：
  *  - 配置 TIM3 / TIM4 为编码器接口模式
  *  - 提供速度与位置的读取接口
+ *  - 编号3、4转交 QEnc 软件正交解码（EXTI）
  * 
  * 保持原有逻辑完全一致，仅调整结构与注释。
  * ========================================================== */
@@ -67,7 +69,7 @@ void Encoder_Init(void)
 
 /**
  * @brief 获取编码器转速（单位：脉冲数 / 10ms）
- * @param num 编码器编号（1：电机1，2：电机2）
+ * @param num 编码器编号（1：电机1，2：电机2，3/4：EXTI软件解码轴）
  * @return 编码器在10ms内的脉冲变化量（正反区分方向）
  * 
  * 原理：
@@ -102,6 +104,10 @@ int16_t Encoder_Get_Speed(uint8_t num)
 
         encoder_pos2 += delta;
     }
+    else if (num == 3 || num == 4)
+    {
+        delta = QEnc_Get_Delta(num);    // 累计位置由中断直接维护
+    }
 
     return (int16_t)(delta * 1.85f);  // 修改：添加f后缀，防止隐式类型警告
 }
@@ -109,13 +115,15 @@ int16_t Encoder_Get_Speed(uint8_t num)
 
 /**
  * @brief 获取编码器累计位置（相对值）
- * @param num 编码器编号（1或2）
+ * @param num 编码器编号（1~4）
  * @return 从清零以来的累计脉冲数
  */
 int32_t Encoder_Get_Position(uint8_t num)
 {
     if (num == 1)
         return encoder_pos1;
+    else if (num == 3 || num == 4)
+        return QEnc_Get_Count(num);
     else
         return encoder_pos2;
 }
@@ -123,7 +131,7 @@ int32_t Encoder_Get_Position(uint8_t num)
 
 /**
  * @brief 清零编码器累计位置（重置基准）
- * @param num 编码器编号（1或2）
+ * @param num 编码器编号（1~4）
  * 
  * 在切换位置控制模式时调用。
  */
@@ -134,6 +142,10 @@ void Encoder_Clear_TotalCount(uint8_t num)
         encoder_pos1 = 0;
         prev_count1 = TIM_GetCounter(TIM3);
     }
+    else if (num == 3 || num == 4)
+    {
+        QEnc_Clear_Count(num);
+    }
     else
     {
         encoder_pos2 = 0;
@@ -10,6 +10,9 @@
  * - Encoder_Get_Speed(num)       获取当前速度（单位：脉冲/10ms）
  * - Encoder_Get_Position(num)    获取累计位置脉冲
  * - Encoder_Clear_TotalCount(num)清零累计位置
+ *
+ * 编号1、2为 TIM3/TIM4 硬件编码器；编号3、4为 QEnc 软件解码轴，
+ * 需额外调用 QEnc_Init()。
  * ========================================================== */
 
 void Encoder_Init(void);
@@ -0,0 +1,326 @@
+#include "stm32f10x.h"
+#include "Friction.h"
+#include "Encoder.h"
+#include "Motor.h"
+#include <stdio.h>
+
+/* ==========================================================
+ * 摩擦标定与补偿模块（Friction.c）
+ * 功能：
+ *  - 在控制中断中以状态机方式执行斜坡/稳态测试
+ *  - 拟合库仑 + 粘滞摩擦模型，替代固定的静摩擦偏置和死区截断
+ * 
+ * 所有时间常数以控制周期（1ms）计。
+ * ========================================================== */
+
+#define FRIC_RAMP_INTERVAL   10     // 斜坡：每10个周期指令+1
+#define FRIC_RAMP_LIMIT      600    // 斜坡上限，超过仍未起动则判定失败
+#define FRIC_MOVE_WINDOW     50     // 位移检测窗口（周期）
+#define FRIC_MOVE_COUNTS     3      // 窗口内位移达到此值视为已起动
+#define FRIC_LEVELS          5      // 稳态测试档数
+#define FRIC_LEVEL_MAX       700    // 稳态测试最高指令
+#define FRIC_SETTLE          300    // 每档稳定时间
+#define FRIC_MEASURE         200    // 每档测量时间
+#define FRIC_PAUSE           500    // 换向前停止时间
+
+#define FRIC_DEFAULT_BREAKAWAY  120 // 未标定时位置模式修正脉冲幅值（原固定值）
+
+typedef enum
+{
+    FRIC_IDLE = 0,
+    FRIC_RAMP,
+    FRIC_STEADY,
+    FRIC_PAUSE_STATE,
+} Fric_State;
+
+static volatile Fric_State fric_state = FRIC_IDLE;
+static volatile uint8_t fric_done = 0;      // 完成标志（1成功，2失败）
+static uint8_t fric_motor = 1;              // 被标定电机
+static uint8_t fric_dir_index = 0;          // 0正转，1反转
+static int16_t fric_command = 0;            // 当前指令（绝对值）
+static int16_t fric_breakaway = 0;          // 本方向起动值
+static uint16_t fric_timer = 0;             // 状态内计时
+static uint8_t fric_level = 0;              // 当前稳态档位
+static int32_t fric_window_pos = 0;         // 位移窗口起点
+static int32_t fric_speed_sum = 0;          // 测量窗口速度累加
+static int16_t fric_level_u[FRIC_LEVELS];   // 各档指令
+static float fric_level_v[FRIC_LEVELS];     // 各档平均速度（绝对值）
+static Friction_Dir fric_fit[2];            // 两个方向的拟合结果，全部成功后才写入 param
+
+
+/**
+ * @brief 以当前方向输出指令
+ */
+static void Friction_Output(int16_t command)
+{
+    Motor_Set_Speed(fric_motor, fric_dir_index == 0 ? command : -command);
+}
+
+
+/**
+ * @brief 开始一个方向的斜坡测试
+ */
+static void Friction_Begin_Direction(void)
+{
+    fric_state = FRIC_RAMP;
+    fric_command = 0;
+    fric_timer = 0;
+    fric_window_pos = Encoder_Get_Position(fric_motor);
+}
+
+
+/**
+ * @brief 对一个方向的稳态数据做最小二乘拟合 u = Fc + B*v
+ * @return 1成功，0数据退化（速度无差异）
+ */
+static uint8_t Friction_Fit(Friction_Dir *model)
+{
+    float mean_u = 0, mean_v = 0;
+    for (uint8_t i = 0; i < FRIC_LEVELS; i++)
+    {
+        mean_u += fric_level_u[i];
+        mean_v += fric_level_v[i];
+    }
+    mean_u /= FRIC_LEVELS;
+    mean_v /= FRIC_LEVELS;
+
+    float sxy = 0, sxx = 0;
+    for (uint8_t i = 0; i < FRIC_LEVELS; i++)
+    {
+        float dv = fric_level_v[i] - mean_v;
+        sxy += dv * (fric_level_u[i] - mean_u);
+        sxx += dv * dv;
+    }
+    if (sxx < 1.0f)
+        return 0;
+
+    float viscous = sxy / sxx;
+    float coulomb = mean_u - viscous * mean_v;
+
+    // 物理上两项均非负，噪声导致的负值按0处理
+    if (viscous < 0) viscous = 0;
+    if (coulomb < 0) coulomb = 0;
+
+    model->breakaway = fric_breakaway;
+    model->coulomb_q8 = (int32_t)(coulomb * 256.0f);
+    model->viscous_q8 = (int32_t)(viscous * 256.0f);
+    return 1;
+}
+
+
+/**
+ * @brief 结束标定
+ * @param ok 1成功（两个方向均已拟合，一并写入模型），0失败（原模型不变）
+ */
+static void Friction_Finish(uint8_t ok)
+{
+    if (ok)
+    {
+        param.friction[fric_motor - 1].dir[0] = fric_fit[0];
+        param.friction[fric_motor - 1].dir[1] = fric_fit[1];
+    }
+    Motor_Set_Speed(fric_motor, 0);
+    fric_state = FRIC_IDLE;
+    fric_done = ok ? 1 : 2;
+}
+
+
+/**
+ * @brief 启动摩擦标定
+ * @param num 电机编号（1或2）
+ * @return 1已启动，0编号无效或标定已在进行
+ */
+uint8_t Friction_Calib_Start(uint8_t num)
+{
+    if ((num != 1 && num != 2) || fric_state != FRIC_IDLE)
+        return 0;
+
+    fric_motor = num;
+    fric_dir_index = 0;
+    fric_done = 0;
+    Friction_Begin_Direction();
+    return 1;
+}
+
+
+/**
+ * @brief 中止标定（模式切换时调用）
+ */
+void Friction_Calib_Abort(void)
+{
+    if (fric_state != FRIC_IDLE)
+    {
+        fric_state = FRIC_IDLE;
+        Motor_Set_Speed(fric_motor, 0);
+    }
+}
+
+
+uint8_t Friction_Calib_IsRunning(void)
+{
+    return fric_state != FRIC_IDLE;
+}
+
+
+uint8_t Friction_Calib_Motor(void)
+{
+    return fric_motor;
+}
+
+
+/**
+ * @brief 标定状态机，控制中断中每周期调用
+ * @param speed 被标定电机本周期速度（Encoder_Get_Speed）
+ */
+void Friction_Calib_Tick(int16_t speed)
+{
+    fric_timer++;
+
+    switch (fric_state)
+    {
+    case FRIC_RAMP:
+        if (fric_timer % FRIC_RAMP_INTERVAL == 0)
+        {
+            if (++fric_command > FRIC_RAMP_LIMIT)
+            {
+                Friction_Finish(0);     // 堵转或编码器未接
+                return;
+            }
+        }
+        if (fric_timer % FRIC_MOVE_WINDOW == 0)
+        {
+            int32_t pos = Encoder_Get_Position(fric_motor);
+            int32_t moved = pos - fric_window_pos;
+            fric_window_pos = pos;
+            if (moved >= FRIC_MOVE_COUNTS || moved <= -FRIC_MOVE_COUNTS)
+            {
+                // 已起动：记录起动值，生成稳态测试档位
+                fric_breakaway = fric_command;
+                for (uint8_t i = 0; i < FRIC_LEVELS; i++)
+                {
+                    fric_level_u[i] = fric_breakaway +
+                        (int32_t)(FRIC_LEVEL_MAX - fric_breakaway) * (i + 1) / FRIC_LEVELS;
+                }
+                fric_level = 0;
+                fric_timer = 0;
+                fric_speed_sum = 0;
+                fric_command = fric_level_u[0];
+                fric_state = FRIC_STEADY;
+            }
+        }
+        Friction_Output(fric_command);
+        break;
+
+    case FRIC_STEADY:
+        if (fric_timer > FRIC_SETTLE)
+        {
+            fric_speed_sum += (speed < 0) ? -speed : speed;
+        }
+        if (fric_timer >= FRIC_SETTLE + FRIC_MEASURE)
+        {
+            fric_level_v[fric_level] = (float)fric_speed_sum / FRIC_MEASURE;
+            fric_speed_sum = 0;
+            fric_timer = 0;
+            if (++fric_level >= FRIC_LEVELS)
+            {
+                if (!Friction_Fit(&fric_fit[fric_dir_index]))
+                {
+                    Friction_Finish(0);
+                    return;
+                }
+                fric_state = FRIC_PAUSE_STATE;
+                Motor_Set_Speed(fric_motor, 0);
+                return;
+            }
+            fric_command = fric_level_u[fric_level];
+        }
+        Friction_Output(fric_command);
+        break;
+
+    case FRIC_PAUSE_STATE:
+        Motor_Set_Speed(fric_motor, 0);
+        if (fric_timer >= FRIC_PAUSE)
+        {
+            if (fric_dir_index == 0)
+            {
+                fric_dir_index = 1;
+                Friction_Begin_Direction();
+            }
+            else
+            {
+                Friction_Finish(1);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+/**
+ * @brief 查询标定是否刚完成（读后清除）
+ * @return 0未完成，1成功，2失败
+ */
+uint8_t Friction_Calib_PollDone(void)
+{
+    uint8_t done = fric_done;
+    fric_done = 0;
+    return done;
+}
+
+
+/**
+ * @brief 串口输出摩擦模型
+ * @param num 电机编号（1或2）
+ * 
+ * 格式：fric,<电机>,<方向>,<起动值>,<库仑Q8>,<粘滞Q8>\n
+ */
+void Friction_Report(uint8_t num)
+{
+    if (num != 1 && num != 2)
+        return;
+
+    for (uint8_t d = 0; d < 2; d++)
+    {
+        const Friction_Dir *model = &param.friction[num - 1].dir[d];
+        printf("fric,%d,%c,%d,%ld,%ld\n", num, d == 0 ? '+' : '-',
+               model->breakaway, (long)model->coulomb_q8, (long)model->viscous_q8);
+    }
+}
+
+
+/**
+ * @brief 计算摩擦前馈
+ * @param num 电机编号（1或2）
+ * @param v   目标速度（与 Encoder_Get_Speed 同单位）
+ * @return 前馈指令（Q8），v为0时不补偿
+ */
+int32_t Friction_FeedForward_Q8(uint8_t num, int16_t v)
+{
+    if (v == 0 || (num != 1 && num != 2))
+        return 0;
+
+    const Friction_Dir *model = &param.friction[num - 1].dir[v > 0 ? 0 : 1];
+    int32_t magnitude = (v > 0) ? v : -v;
+    int32_t ff = model->coulomb_q8 + model->viscous_q8 * magnitude;
+
+    return (v > 0) ? ff : -ff;
+}
+
+
+/**
+ * @brief 获取起动指令值
+ * @param num 电机编号（1或2）
+ * @param dir 方向（>=0正转，<0反转）
+ * @return 起动指令（正值），未标定时返回默认值
+ */
+int16_t Friction_Breakaway(uint8_t num, int8_t dir)
+{
+    if (num != 1 && num != 2)
+        return FRIC_DEFAULT_BREAKAWAY;
+
+    int16_t breakaway = param.friction[num - 1].dir[dir >= 0 ? 0 : 1].breakaway;
+    return (breakaway > 0) ? breakaway : FRIC_DEFAULT_BREAKAWAY;
+}
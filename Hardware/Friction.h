@@ -0,0 +1,37 @@
+#ifndef __FRICTION_H
+#define __FRICTION_H
+
+#include "stm32f10x.h"
+#include "Param.h"
+
+/* ==========================================================
+ * 摩擦标定与补偿模块接口说明
+ *
+ * 标定流程（每个方向各一次）：
+ *  1. 斜坡：指令从0缓慢增加，编码器出现持续位移即记为起动值
+ *  2. 稳态：在起动值与上限之间取若干档指令，稳定后测平均速度
+ *  3. 拟合：最小二乘拟合 u = Fc + B*|v|（库仑 + 粘滞）
+ * 两个方向均拟合成功后结果才写入 param.friction（失败时原模型不变），
+ * 由主循环保存至Flash。
+ *
+ * - Friction_Calib_Start(num)     启动电机num的标定，返回0表示未启动
+ * - Friction_Calib_Abort()        中止标定并停止电机
+ * - Friction_Calib_IsRunning()    标定进行中返回1（控制中断据此让出电机）
+ * - Friction_Calib_Tick(speed)    在控制中断中每周期调用，speed为该电机速度
+ * - Friction_Calib_PollDone()     标定完成后返回一次1（主循环据此保存/上报）
+ * - Friction_Report(num)          通过串口输出电机num的模型
+ * - Friction_FeedForward_Q8(num, v) 按模型计算前馈指令（Q8）
+ * - Friction_Breakaway(num, dir)  起动指令值，未标定时返回默认值
+ * ========================================================== */
+
+uint8_t Friction_Calib_Start(uint8_t num);
+void Friction_Calib_Abort(void);
+uint8_t Friction_Calib_IsRunning(void);
+uint8_t Friction_Calib_Motor(void);
+void Friction_Calib_Tick(int16_t speed);
+uint8_t Friction_Calib_PollDone(void);
+void Friction_Report(uint8_t num);
+int32_t Friction_FeedForward_Q8(uint8_t num, int16_t v);
+int16_t Friction_Breakaway(uint8_t num, int8_t dir);
+
+#endif
@@ -0,0 +1,188 @@
+#include "stm32f10x.h"
+#include "GainSched.h"
+#include "Param.h"
+#include "PID.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ==========================================================
+ * 速度环增益调度模块（GainSched.c）
+ *
+ * 低速段编码器量化与摩擦占主导，高速段反电动势占主导，单组增益
+ * 只能折中。本模块按目标速度在调度表断点间插值出增益：
+ *  - 调度变量取 |目标速度| 而非实测速度，避免测量噪声经增益回灌
+ *  - 插值全程定点（Q16），仅在目标速度或调度表变化时重算，
+ *    其余周期只做一次比较
+ *  - 速度环为增量式PID，积分量保存在输出中，改增益不会引起
+ *    输出突变，天然无扰切换
+ * ========================================================== */
+
+static volatile uint8_t gs_dirty = 1;       // 调度表或开关变化，需重算
+static volatile uint8_t gs_report = 0;
+static int16_t gs_last_speed = -1;          // 上次计算时的调度变量
+
+
+/**
+ * @brief 浮点增益转Q16（限制在 0~32767）
+ */
+static int32_t GainSched_To_Q16(float gain)
+{
+    if (gain < 0) gain = 0;
+    if (gain > 32767.0f) gain = 32767.0f;
+    return (int32_t)(gain * 65536.0f + 0.5f);
+}
+
+
+/**
+ * @brief 在两断点间按 frac（Q16，0~65536）插值
+ */
+static int32_t GainSched_Lerp(int32_t g0, int32_t g1, int32_t frac)
+{
+    return g0 + (int32_t)(((int64_t)(g1 - g0) * frac) >> 16);
+}
+
+
+/**
+ * @brief 增益调度周期处理（控制中断中，速度环计算之前调用）
+ * @param target 电机1目标速度
+ */
+void GainSched_Tick(int16_t target)
+{
+    const Gain_Table *table = &param.gain_sched;
+
+    if (!table->enabled || table->count == 0)
+        return;
+
+    int16_t speed = abs(target);
+    if (speed == gs_last_speed && !gs_dirty)
+        return;
+    // 先清标志再读表：读表期间若被串口中断修改，下周期会再次重算
+    gs_dirty = 0;
+    gs_last_speed = speed;
+
+    const Gain_Point *lo = &table->point[0];
+    const Gain_Point *hi = lo;
+    int32_t frac = 0;
+
+    if (speed >= table->point[table->count - 1].speed)
+    {
+        lo = hi = &table->point[table->count - 1];
+    }
+    else if (speed > lo->speed)
+    {
+        uint8_t i = 1;
+        while (speed >= table->point[i].speed)
+            i++;
+        lo = &table->point[i - 1];
+        hi = &table->point[i];
+        frac = (int32_t)(((int64_t)(speed - lo->speed) << 16) / (hi->speed - lo->speed));
+    }
+
+    int32_t kp = GainSched_Lerp(lo->kp_q16, hi->kp_q16, frac);
+    int32_t ki = GainSched_Lerp(lo->ki_q16, hi->ki_q16, frac);
+    int32_t kd = GainSched_Lerp(lo->kd_q16, hi->kd_q16, frac);
+
+    Speed_PID_SetParams(kp / 65536.0f, ki / 65536.0f, kd / 65536.0f);
+}
+
+
+/**
+ * @brief 设置或追加一个断点
+ * @param index 断点序号，等于当前断点数时追加
+ * @param speed 速度断点，须大于前一断点、小于后一断点
+ * @return 1：成功；0：序号越界或破坏升序
+ */
+uint8_t GainSched_Set_Point(uint8_t index, int16_t speed, float kp, float ki, float kd)
+{
+    Gain_Table *table = &param.gain_sched;
+
+    if (index >= GAIN_SCHED_POINTS || index > table->count || speed < 0)
+        return 0;
+    if (index > 0 && speed <= table->point[index - 1].speed)
+        return 0;
+    if (index + 1 < table->count && speed >= table->point[index + 1].speed)
+        return 0;
+
+    Gain_Point *point = &table->point[index];
+    point->speed = speed;
+    point->reserved = 0;
+    point->kp_q16 = GainSched_To_Q16(kp);
+    point->ki_q16 = GainSched_To_Q16(ki);
+    point->kd_q16 = GainSched_To_Q16(kd);
+    if (index == table->count)
+    {
+        table->count++;
+    }
+    gs_dirty = 1;
+    return 1;
+}
+
+
+/**
+ * @brief 清空调度表并关闭调度（当前增益保持不变）
+ */
+void GainSched_Clear(void)
+{
+    param.gain_sched.enabled = 0;
+    param.gain_sched.count = 0;
+}
+
+
+void GainSched_Enable(uint8_t enable)
+{
+    param.gain_sched.enabled = (enable && param.gain_sched.count > 0);
+    gs_dirty = 1;
+}
+
+
+uint8_t GainSched_IsEnabled(void)
+{
+    return param.gain_sched.enabled;
+}
+
+
+/**
+ * @brief 增益被调度以外的来源改写（@pid、自整定、自适应关闭）后调用
+ * 
+ * 目标速度不变时 GainSched_Tick 不重算，不标记则改写的增益一直保留。
+ */
+void GainSched_Invalidate(void)
+{
+    gs_dirty = 1;
+}
+
+
+void GainSched_Request_Save(void)
+{
+    Param_Request_Save();   // 与其他参数一起由主循环写入Flash
+}
+
+
+void GainSched_Request_Report(void)
+{
+    gs_report = 1;
+}
+
+
+/**
+ * @brief 处理输出请求（主循环中调用）
+ *
+ * 输出格式：gs,<使能>,<断点数>\n 后接每个断点 gs,<序号>,<速度>,<Kp>,<Ki>,<Kd>\n
+ */
+void GainSched_Poll(void)
+{
+    if (gs_report)
+    {
+        const Gain_Table *table = &param.gain_sched;
+
+        gs_report = 0;
+        printf("gs,%d,%d\n", table->enabled, table->count);
+        for (uint8_t i = 0; i < table->count; i++)
+        {
+            printf("gs,%d,%d,%.3f,%.4f,%.3f\n", i, table->point[i].speed,
+                   table->point[i].kp_q16 / 65536.0f,
+                   table->point[i].ki_q16 / 65536.0f,
+                   table->point[i].kd_q16 / 65536.0f);
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef __GAINSCHED_H
+#define __GAINSCHED_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 速度环增益调度模块接口说明
+ *
+ * 调度表保存在 param.gain_sched（见 Param.h），以 |目标速度| 为调度
+ * 变量在相邻断点间线性插值出 Kp/Ki/Kd，超出表范围时取端点值。
+ *
+ * 调度开启时以调度表为准：@pid、自整定写入的增益，以及自适应关闭时
+ * 留下的增益，都在下一周期被表插值结果覆盖（自适应开启期间不调度）。
+ * 要保留整定结果，先关闭调度或把它写入断点。
+ *
+ * - GainSched_Tick(target)                      控制中断中每周期调用（速度环计算之前）
+ * - GainSched_Set_Point(i, speed, kp, ki, kd)   设置/追加断点，返回0表示参数无效
+ * - GainSched_Clear()                           清空调度表
+ * - GainSched_Enable(en)                        开关调度（表为空时无法开启）
+ * - GainSched_IsEnabled()                       已开启返回1
+ * - GainSched_Invalidate()                      增益被其他来源改写后调用，下周期按表重算
+ * - GainSched_Request_Save()                    请求写入Flash（经 Param_Request_Save）
+ * - GainSched_Request_Report()                  请求主循环输出调度表
+ * - GainSched_Poll()                            主循环中处理输出请求
+ * ========================================================== */
+
+void GainSched_Tick(int16_t target);
+uint8_t GainSched_Set_Point(uint8_t index, int16_t speed, float kp, float ki, float kd);
+void GainSched_Clear(void);
+void GainSched_Enable(uint8_t enable);
+uint8_t GainSched_IsEnabled(void);
+void GainSched_Invalidate(void);
+void GainSched_Request_Save(void);
+void GainSched_Request_Report(void);
+void GainSched_Poll(void);
+
+#endif
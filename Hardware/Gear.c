@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include "Gear.h"
+#include "Serial.h"
+
+/* ==========================================================
+ * 电子齿轮与电子凸轮（Gear.c）
+ *
+ * 配置由串口接收中断写入、位置环（控制中断）读取。串口中断优先级
+ * 更高，写入不会被读取打断，读取方按版本号检查：复制期间版本号
+ * 变化说明被打断，重新复制，保证位置环用到的是同一次写入的配置。
+ *
+ * 齿轮：增量 d × 分子 + 余数 按向下取整除以分母，商累加到目标，
+ * 新余数保留（0 ~ 分母-1），目标始终等于 起点 + floor(主轴位移×分子/分母)。
+ *
+ * 凸轮：主轴相位 0 ~ 周期-1 与圈数按增量维护，段号与段内位置
+ * 由 相位×点数 / 周期 得到，都是整数运算，不随运行时间漂移。
+ * 三次插值的切线取相邻两点差的一半（Catmull-Rom），经过表中各点，
+ * 速度连续；跨周期时按升程延拓表值。
+ * ========================================================== */
+
+// 速度单位换算：每周期位移（脉冲/5ms）→ Encoder_Get_Speed 单位（每ms脉冲数×1.85），Q8
+#define GEAR_SPEED_Q8           95
+
+// 配置（串口中断写）
+static volatile uint8_t cfg_version = 0;
+static uint8_t cfg_mode = GEAR_RATIO;
+static int32_t cfg_num = 1;
+static uint16_t cfg_den = 1;
+static uint16_t gear_kp_q8 = GEAR_KP_Q8;
+
+static int32_t cam_table[CAM_MAX_POINTS];
+static uint8_t cam_points = 0;
+static uint32_t cam_period = 0;
+static int32_t cam_rise = 0;
+static uint8_t cam_cubic = 1;
+
+// 运行状态（位置环）
+static uint8_t gear_version = 0;            // 已生效的配置版本
+static uint8_t gear_mode = GEAR_RATIO;
+static int32_t gear_num = 1;
+static uint16_t gear_den = 1;
+static uint8_t gear_engaged = 0;
+static int32_t gear_last_master = 0;
+static int32_t gear_target = 0;
+static int32_t gear_prev_target = 0;
+static int32_t gear_rem = 0;                // 齿轮余数
+static uint32_t cam_phase = 0;
+static int32_t cam_cycles = 0;
+static int32_t cam_base = 0;                // 目标 = cam_base + 圈数×升程 + 插值
+
+// 统计
+static int32_t gear_error = 0;
+static int32_t gear_max_error = 0;
+static volatile uint8_t gear_report = 0;    // bit0 状态，bit1 凸轮表
+
+
+/**
+ * @brief 向下取整除法（C 的除法向0取整）
+ */
+static int32_t Gear_Floor_Div(int64_t a, uint32_t b, int32_t *rem)
+{
+    int64_t q = a / b;
+    int64_t r = a - q * b;
+    if (r < 0)
+    {
+        q--;
+        r += b;
+    }
+    *rem = (int32_t)r;
+    return (int32_t)q;
+}
+
+
+/**
+ * @brief 凸轮表第 i 点（i 可为 -1 ~ 点数+1，越界部分按升程延拓）
+ */
+static int32_t Cam_Y(int32_t i)
+{
+    if (i < 0)
+        return cam_table[i + cam_points] - cam_rise;
+    if (i >= cam_points)
+        return cam_table[i - cam_points] + cam_rise;
+    return cam_table[i];
+}
+
+
+/**
+ * @brief 按主轴相位插值从轴位置（不含圈数升程）
+ */
+static int32_t Cam_Eval(uint32_t phase)
+{
+    uint64_t x = (uint64_t)phase * cam_points;
+    int32_t seg = (int32_t)(x / cam_period);
+    int64_t u = ((x - (uint64_t)seg * cam_period) << 16) / cam_period;    // 段内位置 Q16
+    int32_t y0 = Cam_Y(seg);
+    int32_t y1 = Cam_Y(seg + 1);
+
+    if (!cam_cubic)
+        return y0 + (int32_t)(((int64_t)(y1 - y0) * u) >> 16);
+
+    int32_t d = y1 - y0;
+    int32_t m0 = (y1 - Cam_Y(seg - 1)) / 2;
+    int32_t m1 = (Cam_Y(seg + 2) - y0) / 2;
+    int32_t a2 = 3 * d - 2 * m0 - m1;
+    int32_t a3 = -2 * d + m0 + m1;
+    return y0 + (int32_t)(((((((int64_t)a3 * u) >> 16) + a2) * u >> 16) + m0) * u >> 16);
+}
+
+
+/**
+ * @brief 以当前目标为起点重新开始（进入模式2或切换方式时）
+ */
+static void Gear_Rebase(int32_t master)
+{
+    gear_last_master = master;
+    gear_rem = 0;
+    cam_phase = 0;
+    cam_cycles = 0;
+    if (gear_mode == GEAR_CAM)
+        cam_base = gear_target - Cam_Eval(0);
+}
+
+
+uint8_t Gear_Set_Ratio(int32_t num, uint16_t den)
+{
+    if (den == 0 || num < -GEAR_NUM_MAX || num > GEAR_NUM_MAX)
+        return 0;
+    cfg_num = num;
+    cfg_den = den;
+    cfg_mode = GEAR_RATIO;
+    cfg_version++;
+    return 1;
+}
+
+
+/**
+ * @brief 设置凸轮形状（未选用凸轮时）
+ * @param points 点数（2 ~ CAM_MAX_POINTS）
+ * @param period 主轴周期（点数 ~ CAM_PERIOD_MAX 脉冲）
+ * @param rise 每周期升程
+ * @param cubic 1：三次插值；0：线性插值
+ */
+uint8_t Gear_Set_Cam_Shape(uint8_t points, uint32_t period, int32_t rise, uint8_t cubic)
+{
+    if (cfg_mode == GEAR_CAM || points < 2 || points > CAM_MAX_POINTS ||
+        period < points || period > CAM_PERIOD_MAX || rise < -CAM_POS_MAX || rise > CAM_POS_MAX)
+        return 0;
+    cam_points = points;
+    cam_period = period;
+    cam_rise = rise;
+    cam_cubic = cubic;
+    return 1;
+}
+
+
+uint8_t Gear_Set_Cam_Point(uint8_t index, int32_t pos)
+{
+    if (cfg_mode == GEAR_CAM || index >= CAM_MAX_POINTS || pos < -CAM_POS_MAX || pos > CAM_POS_MAX)
+        return 0;
+    cam_table[index] = pos;
+    return 1;
+}
+
+
+uint8_t Gear_Select_Cam(void)
+{
+    if (cam_points < 2)
+        return 0;
+    cfg_mode = GEAR_CAM;
+    cfg_version++;
+    return 1;
+}
+
+
+void Gear_Set_Gain(uint16_t kp_q8)
+{
+    gear_kp_q8 = kp_q8;
+}
+
+
+/**
+ * @brief 计算从轴目标与速度目标（位置环中调用，周期 GEAR_TICK_MS）
+ * @param master 主轴（电机1）累计位置
+ * @param slave 从轴（电机2）累计位置
+ * @param speed_ref 输出从轴速度目标（Encoder_Get_Speed 的单位）
+ * @return 跟随误差（目标 - 从轴位置）
+ */
+int32_t Gear_Tick(int32_t master, int32_t slave, int16_t *speed_ref)
+{
+    // 配置变化：复制期间被串口中断改写则重新复制
+    while (gear_version != cfg_version)
+    {
+        uint8_t version = cfg_version;
+        gear_mode = cfg_mode;
+        gear_num = cfg_num;
+        gear_den = cfg_den;
+        gear_version = version;
+        if (gear_engaged)
+            Gear_Rebase(master);
+    }
+
+    if (!gear_engaged)
+    {
+        gear_engaged = 1;
+        gear_target = slave;
+        gear_prev_target = slave;
+        gear_max_error = 0;
+        Gear_Rebase(master);
+    }
+
+    int32_t d = (int32_t)((uint32_t)master - (uint32_t)gear_last_master);
+    gear_last_master = master;
+
+    if (gear_mode == GEAR_RATIO)
+    {
+        gear_target += Gear_Floor_Div((int64_t)d * gear_num + gear_rem, gear_den, &gear_rem);
+    }
+    else
+    {
+        int32_t phase;
+        cam_cycles += Gear_Floor_Div((int64_t)cam_phase + d, cam_period, &phase);
+        cam_phase = phase;
+        gear_target = cam_base + (int32_t)((int64_t)cam_cycles * cam_rise) + Cam_Eval(cam_phase);
+    }
+
+    int32_t err = gear_target - slave;
+    gear_error = err;
+    if (err > gear_max_error) gear_max_error = err;
+    if (-err > gear_max_error) gear_max_error = -err;
+
+    int64_t ref = ((int64_t)(gear_target - gear_prev_target) * GEAR_SPEED_Q8 +
+                   (int64_t)err * gear_kp_q8 + 128) >> 8;
+    gear_prev_target = gear_target;
+    *speed_ref = ref > INT16_MAX ? INT16_MAX : ref < INT16_MIN ? INT16_MIN : (int16_t)ref;
+    return err;
+}
+
+
+void Gear_Release(void)
+{
+    gear_engaged = 0;
+}
+
+
+void Gear_Reset_Stats(void)
+{
+    gear_max_error = 0;
+}
+
+
+void Gear_Request_Report(uint8_t cam)
+{
+    gear_report |= cam ? 0x02 : 0x01;
+}
+
+
+/**
+ * @brief 输出报告（主循环中调用）
+ *
+ * 格式：gear,<方式>,<分子>,<分母>,<增益Q8>,<从轴目标>,<跟随误差>,<最大跟随误差>\n
+ *       cam,<点数>,<主轴周期>,<升程>,<三次插值>\n，之后每点一行 cam,<序号>,<位置>\n
+ */
+void Gear_PollReport(void)
+{
+    uint8_t report = gear_report;
+    if (!report)
+        return;
+    gear_report = 0;
+
+    Serial_Telemetry_Enable(0);
+    if (report & 0x01)
+    {
+        printf("gear,%u,%ld,%u,%u,%ld,%ld,%ld\n", cfg_mode, (long)cfg_num, cfg_den, gear_kp_q8,
+               (long)gear_target, (long)gear_error, (long)gear_max_error);
+    }
+    if (report & 0x02)
+    {
+        printf("cam,%u,%lu,%ld,%u\n", cam_points, (unsigned long)cam_period, (long)cam_rise, cam_cubic);
+        for (uint8_t i = 0; i < cam_points; i++)
+        {
+            printf("cam,%u,%ld\n", i, (long)cam_table[i]);
+        }
+    }
+    Serial_Telemetry_Enable(1);
+}
@@ -0,0 +1,62 @@
+#ifndef __GEAR_H
+#define __GEAR_H
+
+#include <stdint.h>
+
+/* ==========================================================
+ * 电子齿轮与电子凸轮接口说明（模式2：电机2跟随电机1）
+ *
+ * 位置环（200Hz）每周期由电机1（主轴）32位累计位置计算电机2（从轴）
+ * 的目标位置，从轴按目标位置闭环：
+ *
+ *   齿轮  目标 = 从轴起点 + (主轴位移 × 分子) / 分母
+ *         按主轴增量累加，余数保留到下一周期，任意长时间运行无累积误差；
+ *         主轴计数跨越 ±2^31 回绕时增量仍正确
+ *   凸轮  主轴按周期 <周期> 脉冲分为 <点数> 段，表中为各分段点的从轴位置，
+ *         段内线性或三次（Catmull-Rom）插值；每过一个周期从轴附加 <升程>，
+ *         升程为0时从轴往复，不为0时为分度/追剪类连续运动
+ *
+ * 进入模式2或切换方式时以当前位置为起点，从轴不跳变；主轴相位从凸轮表
+ * 第0点开始。
+ *
+ * 从轴输出：速度目标 = 目标位置变化率（前馈）+ 跟随误差 × 增益（Q8），
+ * 由位置环经摩擦模型换算为电机2指令（见 Timer.c）。跟随误差 = 目标 - 从轴位置。
+ *
+ * 配置可在任意时刻由串口命令修改，下一个位置环周期生效；凸轮表只能在
+ * 未选用凸轮时修改。
+ *
+ * - Gear_Set_Ratio(num, den)           选用齿轮方式并设置比例，返回0表示不合法
+ * - Gear_Set_Cam_Shape(n, period, rise, cubic)  凸轮点数、主轴周期、升程、插值方式
+ * - Gear_Set_Cam_Point(i, pos)         凸轮表第i点的从轴位置
+ * - Gear_Select_Cam()                  选用凸轮方式，返回0表示凸轮表未设置
+ * - Gear_Set_Gain(kp)                  跟随误差增益（Q8，速度单位/脉冲）
+ * - Gear_Tick(master, slave, ref)      位置环中调用，返回跟随误差
+ * - Gear_Release()                     离开模式2，下次调用 Gear_Tick 时重新建立起点
+ * - Gear_Reset_Stats()                 清零最大跟随误差
+ * - Gear_Request_Report(cam)           命令 @gear%? / @cam%?
+ * - Gear_PollReport()                  主循环中调用
+ * ========================================================== */
+
+#define GEAR_RATIO              0       // 电子齿轮
+#define GEAR_CAM                1       // 电子凸轮
+
+#define GEAR_TICK_MS            5       // Gear_Tick 调用周期（位置环 200Hz）
+#define GEAR_KP_Q8              16      // 默认跟随误差增益
+#define GEAR_NUM_MAX            65535   // 比例分子范围 ±GEAR_NUM_MAX，分母 1~65535
+
+#define CAM_MAX_POINTS          32
+#define CAM_POS_MAX             (1L << 24)  // 凸轮表位置与升程范围 ±CAM_POS_MAX
+#define CAM_PERIOD_MAX          (1L << 24)  // 主轴周期（脉冲）
+
+uint8_t Gear_Set_Ratio(int32_t num, uint16_t den);
+uint8_t Gear_Set_Cam_Shape(uint8_t points, uint32_t period, int32_t rise, uint8_t cubic);
+uint8_t Gear_Set_Cam_Point(uint8_t index, int32_t pos);
+uint8_t Gear_Select_Cam(void);
+void Gear_Set_Gain(uint16_t kp_q8);
+int32_t Gear_Tick(int32_t master, int32_t slave, int16_t *speed_ref);
+void Gear_Release(void);
+void Gear_Reset_Stats(void);
+void Gear_Request_Report(uint8_t cam);
+void Gear_PollReport(void);
+
+#endif
@@ -1,8 +1,8 @@
 #include "stm32f10x.h"
-#include "Delay.h"
+#include "Key.h"
+#include "Sched.h"
 
-uint32_t GetSystemTick(void);   // ★新增注释：获取系统节拍计数（ms单位）
-volatile uint32_t system_tick = 0;  // ★修改：定义系统节拍计数变量（由SysTick中断更新）
+static uint32_t last_press_time = 0;   // 最近一次有效按下时刻（ms），可扩展长按功能
 
 // =====================================================
 // 函数名称：Key_Init
@@ -27,47 +27,46 @@ void Key_Init(void)
 
 // =====================================================
 // 函数名称：Key_GetNum
-// 功能描述：检测按键是否被按下（包含简单消抖）
+// 功能描述：检测按键是否被按下（非阻塞消抖）
+//           须以固定周期（KEY_SCAN_MS）调用，电平连续 KEY_DEBOUNCE_COUNT
+//           次与稳定状态不同才认为翻转，不再延时等待
 // 参数说明：无
 // 返回值：1 = 检测到有效按下，0 = 未按下
 // =====================================================
 uint8_t Key_GetNum(void)
 {
-    static uint8_t last_state = 1;         // ★修改：记录上次状态（1=未按下，0=按下）
-    static uint32_t last_press_time = 0;   // ★新增注释：记录上次按下时刻（ms）
+    static uint8_t stable_state = 1;       // 消抖后的稳定状态（1=未按下，0=按下）
+    static uint8_t change_count = 0;       // 与稳定状态不同的连续采样次数
     uint8_t current_state = GPIO_ReadInputDataBit(GPIOA, GPIO_Pin_0);
-    uint32_t current_time = GetSystemTick();
 
-    // ---------- 检测按键按下（从 1 → 0） ----------
-    if (last_state == 1 && current_state == 0)
+    if (current_state == stable_state)
     {
-        // ★新增注释：进行简单消抖（延时50ms）
-        Delay_ms(50);
-
-        // 再次确认是否仍然按下
-        if (GPIO_ReadInputDataBit(GPIOA, GPIO_Pin_0) == 0)
-        {
-            last_state = 0;
-            last_press_time = current_time;   // ★新增注释：记录按下时间（可扩展长按功能）
-            return 1;                         // 检测到有效按下
-        }
+        change_count = 0;
+        return 0;
     }
 
-    if (last_state == 0 && current_state == 1)
+    if (++change_count < KEY_DEBOUNCE_COUNT)
     {
-        last_state = 1;  // ★新增注释：更新状态为未按下
+        return 0;
     }
 
-    return 0; // ★新增注释：默认返回未按下
+    change_count = 0;
+    stable_state = current_state;
+    if (stable_state == 0)                  // 从 1 → 0：有效按下
+    {
+        last_press_time = Sched_Now();
+        return 1;
+    }
+    return 0;
 }
 
 // =====================================================
-// 函数名称：GetSystemTick
-// 功能描述：返回系统节拍计数值
+// 函数名称：Key_Get_PressTime
+// 功能描述：返回最近一次有效按下的时刻
 // 参数说明：无
-// 返回值：系统运行的毫秒计数（通常由SysTick中断自增）
+// 返回值：调度节拍（ms）
 // =====================================================
-uint32_t GetSystemTick(void)
+uint32_t Key_Get_PressTime(void)
 {
-    return system_tick;
+    return last_press_time;
 }
@@ -5,7 +5,10 @@
 
 // 模块名称：Key（按键驱动模块）
 // 功能说明：实现单个按键的初始化与消抖检测
-// 依赖模块：Delay、SysTick
+// 依赖模块：Sched（节拍计时）
+
+#define KEY_SCAN_MS         10      // 扫描周期（ms）
+#define KEY_DEBOUNCE_COUNT  3       // 连续相同采样次数，消抖时间约30ms
 
 // 按键初始化函数：配置GPIOA引脚为上拉输入模式
 void Key_Init(void);
@@ -14,4 +17,7 @@ void Key_Init(void);
 // 返回值：1 = 检测到按键有效按下，0 = 未按下
 uint8_t Key_GetNum(void);
 
+// 最近一次有效按下时刻（ms）
+uint32_t Key_Get_PressTime(void);
+
 #endif
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include "Link.h"
+#include "Cobs.h"
+
+/* ==========================================================
+ * 二进制命令通道（Link.c）
+ *
+ * 在串口接收处理中逐字节调用：0x00 进入帧，再遇 0x00 时解码、校验、
+ * 按序号执行并立即应答，与 ASCII 命令一样在接收中断中完成，
+ * 不引入额外的队列与延迟。
+ *
+ * 帧长超过 LINK_MAX_PACKET 时放弃该帧并回到 ASCII 解析，结束分隔符
+ * 丢失时最多吞掉一帧长度的 ASCII 字节。
+ * ========================================================== */
+
+#define LINK_RX_SIZE        COBS_MAX_ENCODED(LINK_MAX_PACKET)
+
+typedef struct
+{
+    uint8_t valid;
+    uint8_t seq;
+    uint8_t cmd;
+    uint8_t status;         // LINK_ACK / LINK_NACK
+    uint8_t len;
+    uint8_t data[LINK_MAX_REPLY];   // ACK 的应答负载或 NACK 的错误码
+} Link_Result;
+
+static uint8_t link_rx[LINK_RX_SIZE];
+static uint8_t link_rx_len = 0;
+static uint8_t link_in_frame = 0;
+
+static uint8_t link_expect = 0;                     // 期望序号
+static uint8_t link_gap_reported = 0;               // 当前缺口已回复过 NACK SEQ
+static Link_Result link_history[LINK_WINDOW];       // 最近执行结果，按 序号 % LINK_WINDOW 存放
+static Link_Stats link_stats;
+static volatile uint8_t link_report = 0;
+
+
+/**
+ * @brief 编码并发送一个应答包
+ */
+static void Link_Reply(uint8_t seq, uint8_t status, uint8_t cmd, const uint8_t *data, uint8_t len)
+{
+    uint8_t pkt[LINK_MAX_PACKET + 1];
+    uint8_t frame[COBS_MAX_ENCODED(LINK_MAX_PACKET + 1) + 2];
+    uint8_t n = 0;
+
+    pkt[n++] = seq;
+    pkt[n++] = status;
+    pkt[n++] = cmd;
+    for (uint8_t i = 0; i < len; i++) pkt[n++] = data[i];
+    uint16_t crc = Cobs_Crc16(pkt, n);
+    pkt[n++] = crc & 0xFF;
+    pkt[n++] = crc >> 8;
+
+    frame[0] = 0;
+    uint8_t m = 1 + Cobs_Encode(pkt, n, frame + 1);
+    frame[m++] = 0;
+
+    if (status == LINK_ACK) link_stats.acks++;
+    else                    link_stats.nacks++;
+    if (!Link_Port_Send(frame, m))
+    {
+        link_stats.tx_dropped++;
+    }
+}
+
+
+/**
+ * @brief 处理一个完整帧（不含分隔符）
+ */
+static void Link_Process(void)
+{
+    uint8_t pkt[LINK_RX_SIZE];
+    uint8_t reply[LINK_MAX_REPLY];
+    uint8_t reply_len = 0;
+
+    link_stats.frames++;
+    uint16_t n = Cobs_Decode(link_rx, link_rx_len, pkt);
+    if (n < 4 || Cobs_Crc16(pkt, n - 2) != (pkt[n - 2] | (uint16_t)pkt[n - 1] << 8))
+    {
+        link_stats.crc_errors++;
+        link_gap_reported = 0;      // 可能是上位机重发的缺口请求再次损坏，后续请求需要重新报告
+        if (n >= 2)
+        {
+            uint8_t err = LINK_ERR_CRC;
+            Link_Reply(pkt[0], LINK_NACK, pkt[1], &err, 1);
+        }
+        return;
+    }
+
+    uint8_t seq = pkt[0];
+    uint8_t cmd = pkt[1];
+    uint8_t behind = (uint8_t)(link_expect - seq);
+
+    if (cmd == LINK_CMD_SYNC)
+    {
+        for (uint8_t i = 0; i < LINK_WINDOW; i++) link_history[i].valid = 0;
+        link_expect = seq;
+        behind = 0;
+    }
+    else if (behind >= 1 && behind <= LINK_WINDOW)
+    {
+        // 重复请求：已执行过，只重发结果
+        const Link_Result *r = &link_history[seq % LINK_WINDOW];
+        if (!r->valid || r->seq != seq || r->cmd != cmd)
+            return;
+        link_stats.duplicates++;
+        Link_Reply(seq, r->status, cmd, r->data, r->len);
+        return;
+    }
+    else if (behind != 0)
+    {
+        // 同一个缺口只报告一次，已在途的后续请求不再逐个 NACK，避免上位机多次重发
+        link_stats.out_of_order++;
+        if (!link_gap_reported)
+        {
+            uint8_t nack[2] = { LINK_ERR_SEQ, link_expect };
+            link_gap_reported = 1;
+            Link_Reply(seq, LINK_NACK, cmd, nack, 2);
+        }
+        return;
+    }
+
+    uint8_t err = 0;
+    if (cmd != LINK_CMD_SYNC)
+    {
+        err = Link_Port_Execute(cmd, pkt + 2, n - 4, reply, &reply_len);
+    }
+    if (err == LINK_ERR_BUSY)
+    {
+        // 未执行：不推进序号、不记入结果，重发的同一请求按新请求处理
+        Link_Reply(seq, LINK_NACK, cmd, &err, 1);
+        return;
+    }
+    link_expect = seq + 1;
+    link_gap_reported = 0;
+
+    Link_Result *r = &link_history[seq % LINK_WINDOW];
+    r->valid = 1;
+    r->seq = seq;
+    r->cmd = cmd;
+    if (err)
+    {
+        reply[0] = err;
+        reply_len = 1;
+    }
+    else if (reply_len > LINK_MAX_REPLY)
+    {
+        reply_len = LINK_MAX_REPLY;
+    }
+    r->status = err ? LINK_NACK : LINK_ACK;
+    r->len = reply_len;
+    for (uint8_t i = 0; i < reply_len; i++) r->data[i] = reply[i];
+    Link_Reply(seq, r->status, cmd, reply, reply_len);
+}
+
+
+/**
+ * @brief 接收一个字节（串口接收处理中调用）
+ * @return 1：属于二进制帧（含分隔符）；0：交给 ASCII 命令解析
+ */
+uint8_t Link_Rx_Byte(uint8_t b)
+{
+    if (!link_in_frame)
+    {
+        if (b != 0)
+            return 0;
+        link_in_frame = 1;
+        link_rx_len = 0;
+        return 1;
+    }
+
+    if (b == 0)
+    {
+        // 连续的分隔符视为新帧开始
+        if (link_rx_len > 0)
+        {
+            Link_Process();
+            link_in_frame = 0;
+        }
+        return 1;
+    }
+
+    if (link_rx_len < LINK_RX_SIZE)
+    {
+        link_rx[link_rx_len++] = b;
+    }
+    else
+    {
+        link_stats.crc_errors++;
+        link_in_frame = 0;      // 超长，不是有效帧
+    }
+    return 1;
+}
+
+
+void Link_Get_Stats(Link_Stats *stats)
+{
+    *stats = link_stats;
+}
+
+
+void Link_Request_Report(void)
+{
+    link_report = 1;
+}
+
+
+/**
+ * @brief 输出统计（主循环中调用）
+ *
+ * 格式：link,<帧>,<ACK>,<NACK>,<CRC错>,<重复>,<乱序>,<发送丢弃>,<期望序号>\n
+ */
+void Link_PollReport(void)
+{
+    if (!link_report)
+        return;
+    link_report = 0;
+
+    Link_Stats s = link_stats;
+    printf("link,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%u\n", (unsigned long)s.frames, (unsigned long)s.acks,
+           (unsigned long)s.nacks, (unsigned long)s.crc_errors, (unsigned long)s.duplicates,
+           (unsigned long)s.out_of_order, (unsigned long)s.tx_dropped, link_expect);
+}
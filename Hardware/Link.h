@@ -0,0 +1,86 @@
+#ifndef __LINK_H
+#define __LINK_H
+
+#include <stdint.h>
+
+/* ==========================================================
+ * 二进制命令通道接口说明（COBS 帧 + CRC + 序号应答）
+ *
+ * 与 ASCII 命令共用 USART1：一帧以 0x00 开始、以 0x00 结束，中间为
+ * COBS 编码的数据包，0x00 之外的字节仍交给 ASCII 命令解析。
+ *
+ * 请求包：<序号> <命令> <负载...> <CRC低> <CRC高>
+ * 应答包：<序号> <ACK|NACK> <命令> <负载或错误码...> <CRC低> <CRC高>
+ *   CRC 为 CRC-16/CCITT-FALSE，覆盖 CRC 之前的全部字节；多字节数值均为小端。
+ *
+ * 序号按请求依次加一（模256），下位机只执行等于期望序号的请求，
+ * 保证命令按发送顺序生效且只执行一次：
+ *   - 落后期望序号 LINK_WINDOW 以内：重复请求（上位机未收到应答而重发），
+ *     不再执行，回复当时的结果（含应答负载）
+ *   - 超前：中间有请求丢失或损坏，回复 NACK LINK_ERR_SEQ，负载为期望序号，
+ *     上位机从该序号起重发（go-back-N）；同一缺口只回复一次，直到期望的
+ *     请求到达或再收到损坏的帧
+ *   - LINK_CMD_SYNC 任意序号都接受，以其下一个作为期望序号，会话开始时发送
+ *   - 命令暂时不能执行（LINK_ERR_BUSY，如 PVT 队列满）：回复 NACK 但不推进
+ *     期望序号、不记入结果，上位机稍后以同一序号重发
+ * 上位机可连续发出至多 LINK_WINDOW 个未应答的请求，不必逐条等待往返。
+ *
+ * 只依赖 stdint/stdio 与 Cobs，上位机测试（Tools/link_host.c）直接编译本文件；
+ * 命令执行与发送由下面的 Link_Port_* 接口提供（固件中在 Serial.c 实现）。
+ *
+ * - Link_Rx_Byte(b)           接收中断中逐字节调用，返回1表示字节属于二进制帧
+ * - Link_Get_Stats(s)         读取统计
+ * - Link_Request_Report()     命令 @link%?
+ * - Link_PollReport()         有报告请求时输出统计（主循环中调用）
+ * ========================================================== */
+
+// 命令
+#define LINK_CMD_PING       0x00    // 无负载，直接应答
+#define LINK_CMD_SPEED      0x01    // int16 目标速度
+#define LINK_CMD_PID        0x02    // float Kp、Ki、Kd（速度环）
+#define LINK_CMD_STATUS     0x03    // 应答负载：int16 目标速度、uint8 控制模式
+#define LINK_CMD_PVT        0x04    // uint16 dt、int32 位置、int32 速度，见 Pvt.h；无负载为查询
+                                    // 应答负载：uint8 队列剩余空间、uint8 PVT 状态
+#define LINK_CMD_TEXT       0x10    // 负载为一条 ASCII 命令（不含换行），按命令表执行
+#define LINK_CMD_SYNC       0x7F    // 同步序号
+
+// 应答
+#define LINK_ACK            0x06
+#define LINK_NACK           0x15
+
+// 错误码（1、2 与 Fmt 相同）
+#define LINK_ERR_EMPTY      1       // 缺少参数
+#define LINK_ERR_RANGE      2       // 参数超出范围
+#define LINK_ERR_CRC        3       // 校验错误（应答中的序号与命令可能不可靠）
+#define LINK_ERR_CMD        4       // 未知命令
+#define LINK_ERR_LENGTH     5       // 负载长度不符
+#define LINK_ERR_SEQ        6       // 序号超前，负载为期望序号
+#define LINK_ERR_BUSY       7       // 暂时不能执行（未执行，稍后重发同一序号）
+
+#define LINK_MAX_PAYLOAD    32
+#define LINK_MAX_PACKET     (2 + LINK_MAX_PAYLOAD + 2)
+#define LINK_WINDOW         8       // 最多未应答请求数，也是重复检测范围
+#define LINK_MAX_REPLY      3       // 应答负载上限，按序号保存以便重发
+
+typedef struct
+{
+    uint32_t frames;        // 收到的帧
+    uint32_t acks;
+    uint32_t nacks;
+    uint32_t crc_errors;    // 校验错误或解码失败
+    uint32_t duplicates;    // 重复请求（未执行，重发应答）
+    uint32_t out_of_order;  // 序号超前
+    uint32_t tx_dropped;    // 发送缓冲不足未发出的应答
+} Link_Stats;
+
+// 平台接口
+uint8_t Link_Port_Execute(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                          uint8_t *reply, uint8_t *reply_len);     // 返回0或错误码，应答至多 LINK_MAX_REPLY 字节
+uint8_t Link_Port_Send(const uint8_t *frame, uint8_t len);         // 整帧写入发送缓冲，失败返回0
+
+uint8_t Link_Rx_Byte(uint8_t b);
+void Link_Get_Stats(Link_Stats *stats);
+void Link_Request_Report(void);
+void Link_PollReport(void);
+
+#endif
@@ -0,0 +1,383 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include "Measure.h"
+#include "MemInfo.h"
+#include "Serial.h"
+#include "Defer.h"
+#include "Fmt.h"
+
+/* ==========================================================
+ * 变量测量与标定模块（Measure.c）
+ *
+ * 采样在控制中断中只做各项的对齐读取并拷贝到快照，格式化与发送
+ * 交给 PendSV 下半部（DEFER_MEASURE）。上一帧尚未发出时跳过本次
+ * 采样并计数，不会在中断中等待串口。
+ *
+ * 采集表、暂存写入由串口接收中断修改，接收中断优先级高于控制中断，
+ * 修改时关中断；提交期间不接受新的暂存写入。
+ * 单项读写耗时固定，采样耗时随项数线性增长，上限为 MEAS_MAX_ENTRIES
+ * 项，实际耗时见 @sched%? 中 meas 任务一行。
+ * ========================================================== */
+
+#define MEAS_FLASH_BASE     0x08000000
+#define MEAS_RAM_BASE       0x20000000
+
+// ARMCC 链接器生成的段符号，取地址即为对应数值
+extern uint32_t STACK$$Base;
+extern uint32_t STACK$$Limit;
+extern uint32_t HEAP$$Base;
+extern uint32_t HEAP$$Limit;
+extern uint32_t Image$$RW_IRAM1$$Base;
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit;
+extern uint32_t Load$$LR$$LR_IROM1$$Limit;
+
+typedef struct
+{
+    uint32_t addr;
+    uint8_t size;           // 0为空项
+} Measure_Entry;
+
+typedef struct
+{
+    uint32_t addr;
+    uint32_t value;
+    uint8_t size;
+} Measure_Write;
+
+static Measure_Entry meas_list[MEAS_MAX_ENTRIES];
+static uint8_t meas_bytes = 0;                  // 采集表总字节数
+static volatile uint16_t meas_period = 0;       // 采集周期（ms），0为停止
+static uint16_t meas_countdown = 0;
+static uint32_t meas_ms = 0;                    // 节拍计数（1ms）
+
+// 快照（上半部写，下半部读）
+static uint8_t meas_snap[MEAS_MAX_BYTES];
+static uint8_t meas_snap_len = 0;
+static uint32_t meas_snap_ms = 0;
+static volatile uint8_t meas_snap_ready = 0;
+
+// 暂存写入
+static Measure_Write meas_writes[MEAS_MAX_WRITES];
+static uint8_t meas_write_count = 0;
+static volatile uint8_t meas_commit = 0;        // 已提交，等待控制节拍写入
+static volatile uint8_t meas_write_done = 0;    // 已写入项数+1，0为无待回复
+
+// 单次读取
+static uint32_t meas_read_addr = 0;
+static uint8_t meas_read_size = 0;
+static volatile uint8_t meas_read_pending = 0;
+
+// 统计
+static uint32_t meas_frames = 0;
+static uint32_t meas_skipped = 0;       // 上一帧未发出而跳过的采样
+static uint32_t meas_dropped = 0;       // 发送缓冲不足丢弃的帧
+static volatile uint8_t meas_report = 0;
+
+
+/**
+ * @brief 检查大小与对齐
+ */
+static uint8_t Measure_Size_Ok(uint32_t addr, uint8_t size)
+{
+    return (size == 1 || size == 2 || size == 4) && (addr & (size - 1)) == 0;
+}
+
+
+/**
+ * @brief 可读范围：SRAM 与本程序 Flash
+ */
+static uint8_t Measure_Readable(uint32_t addr, uint8_t size)
+{
+    if (!Measure_Size_Ok(addr, size))
+        return 0;
+    if (addr >= MEAS_RAM_BASE && addr + size <= MEM_RAM_END)
+        return 1;
+    return addr >= MEAS_FLASH_BASE && addr + size <= (uint32_t)&Load$$LR$$LR_IROM1$$Limit;
+}
+
+
+/**
+ * @brief 可写范围：RW/ZI 段中除栈与堆以外的部分
+ */
+static uint8_t Measure_Writable(uint32_t addr, uint8_t size)
+{
+    uint32_t end = addr + size;
+
+    if (!Measure_Size_Ok(addr, size))
+        return 0;
+    if (addr < (uint32_t)&Image$$RW_IRAM1$$Base || end > (uint32_t)&Image$$RW_IRAM1$$ZI$$Limit)
+        return 0;
+    if (end > (uint32_t)&STACK$$Base && addr < (uint32_t)&STACK$$Limit)
+        return 0;
+    if (end > (uint32_t)&HEAP$$Base && addr < (uint32_t)&HEAP$$Limit)
+        return 0;
+    return 1;
+}
+
+
+/**
+ * @brief 单次对齐读取（1/2/4字节各为一条加载指令，不会读到半更新的值）
+ */
+static uint32_t Measure_Load(uint32_t addr, uint8_t size)
+{
+    switch (size)
+    {
+        case 1:  return *(volatile uint8_t *)addr;
+        case 2:  return *(volatile uint16_t *)addr;
+        default: return *(volatile uint32_t *)addr;
+    }
+}
+
+
+static void Measure_Store(uint32_t addr, uint8_t size, uint32_t value)
+{
+    switch (size)
+    {
+        case 1:  *(volatile uint8_t *)addr = value;  break;
+        case 2:  *(volatile uint16_t *)addr = value; break;
+        default: *(volatile uint32_t *)addr = value; break;
+    }
+}
+
+
+/**
+ * @brief 采集下半部（PendSV）：格式化快照并写入发送缓冲
+ */
+static void Measure_Send(void)
+{
+    char line[2 + 10 + 1 + MEAS_MAX_BYTES * 2 + 1];
+    uint8_t n = 0;
+
+    if (!meas_snap_ready)
+        return;
+
+    line[n++] = 'm';
+    line[n++] = ',';
+    n += Fmt_Uint(line + n, meas_snap_ms);
+    line[n++] = ',';
+    for (uint8_t i = 0; i < meas_snap_len; i++)
+    {
+        Fmt_Hex_Fixed(line + n, meas_snap[i], 2);
+        n += 2;
+    }
+    line[n++] = '\n';
+
+    if (Serial_Send_Frame(line, n))
+        meas_frames++;
+    else
+        meas_dropped++;
+    meas_snap_ready = 0;
+}
+
+
+void Measure_Init(void)
+{
+    Defer_Register(DEFER_MEASURE, Measure_Send);
+}
+
+
+/**
+ * @brief 控制中断中每1ms调用：先执行已提交的写入，再按周期采样
+ *
+ * 写入在采样之前，同一节拍的采样帧已反映新参数。
+ */
+void Measure_Tick(void)
+{
+    meas_ms++;
+
+    if (meas_commit)
+    {
+        __disable_irq();
+        for (uint8_t i = 0; i < meas_write_count; i++)
+        {
+            Measure_Store(meas_writes[i].addr, meas_writes[i].size, meas_writes[i].value);
+        }
+        __enable_irq();
+        meas_write_done = meas_write_count + 1;
+        meas_write_count = 0;
+        meas_commit = 0;
+    }
+
+    if (meas_period == 0)
+        return;
+    if (meas_countdown > 1)
+    {
+        meas_countdown--;
+        return;
+    }
+    meas_countdown = meas_period;
+
+    if (meas_snap_ready)
+    {
+        meas_skipped++;
+        return;
+    }
+
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MEAS_MAX_ENTRIES; i++)
+    {
+        const Measure_Entry *e = &meas_list[i];
+        if (e->size == 0 || n + e->size > MEAS_MAX_BYTES)
+            continue;
+        uint32_t value = Measure_Load(e->addr, e->size);
+        for (uint8_t k = 0; k < e->size; k++)
+        {
+            meas_snap[n++] = value >> (8 * k);      // 小端
+        }
+    }
+    meas_snap_len = n;
+    meas_snap_ms = meas_ms;
+    meas_snap_ready = 1;
+    Defer_Post(DEFER_MEASURE);
+}
+
+
+/**
+ * @brief 定义采集表项
+ * @param index 序号（0 ~ MEAS_MAX_ENTRIES-1），帧内按序号顺序排列
+ * @param addr 变量地址
+ * @param size 1/2/4，0为删除该项
+ * @return 1：成功；0：地址不可读、未对齐或超出总字节数
+ */
+uint8_t Measure_Set_Entry(uint8_t index, uint32_t addr, uint8_t size)
+{
+    if (index >= MEAS_MAX_ENTRIES)
+        return 0;
+    if (size != 0 && !Measure_Readable(addr, size))
+        return 0;
+    if (meas_bytes - meas_list[index].size + size > MEAS_MAX_BYTES)
+        return 0;
+
+    __disable_irq();
+    meas_bytes = meas_bytes - meas_list[index].size + size;
+    meas_list[index].addr = addr;
+    meas_list[index].size = size;
+    __enable_irq();
+    return 1;
+}
+
+
+void Measure_Clear(void)
+{
+    __disable_irq();
+    meas_period = 0;
+    for (uint8_t i = 0; i < MEAS_MAX_ENTRIES; i++)
+    {
+        meas_list[i].size = 0;
+    }
+    meas_bytes = 0;
+    __enable_irq();
+}
+
+
+/**
+ * @brief 开始/停止周期采集
+ * @param period_ms 采集周期（ms），0停止
+ */
+void Measure_Start(uint16_t period_ms)
+{
+    __disable_irq();
+    meas_countdown = 1;
+    meas_period = period_ms;
+    __enable_irq();
+}
+
+
+/**
+ * @brief 请求单次读取，结果由 Measure_PollReport 回复
+ * @return 1：已接受；0：地址不可读或未对齐
+ */
+uint8_t Measure_Read(uint32_t addr, uint8_t size)
+{
+    if (!Measure_Readable(addr, size))
+        return 0;
+    meas_read_addr = addr;
+    meas_read_size = size;
+    meas_read_pending = 1;
+    return 1;
+}
+
+
+/**
+ * @brief 暂存一项写入，提交前不生效
+ * @return 1：已暂存；0：地址不可写、暂存已满或上一次提交尚未完成
+ */
+uint8_t Measure_Stage_Write(uint32_t addr, uint8_t size, uint32_t value)
+{
+    if (meas_commit || meas_write_count >= MEAS_MAX_WRITES || !Measure_Writable(addr, size))
+        return 0;
+
+    meas_writes[meas_write_count].addr = addr;
+    meas_writes[meas_write_count].size = size;
+    meas_writes[meas_write_count].value = value;
+    meas_write_count++;
+    return 1;
+}
+
+
+/**
+ * @brief 提交或放弃暂存的写入
+ * @param commit 1：在下一个控制节拍一次写完；0：放弃
+ */
+void Measure_Commit(uint8_t commit)
+{
+    if (meas_commit)
+        return;
+    if (commit)
+        meas_commit = 1;
+    else
+        meas_write_count = 0;
+}
+
+
+void Measure_Request_Report(void)
+{
+    meas_report = 1;
+}
+
+
+/**
+ * @brief 输出单次读取结果、写入确认与采集统计（主循环中调用）
+ *
+ * 格式：mr,<地址>,<值hex>\n
+ *       mw,ok,<项数>\n
+ *       meas,<周期ms>,<项数>,<字节数>,<帧数>,<跳过>,<丢弃>\n
+ *       meas,<序号>,<地址>,<大小>\n（每个已定义项）
+ */
+void Measure_PollReport(void)
+{
+    if (meas_read_pending)
+    {
+        meas_read_pending = 0;
+        printf("mr,%08lX,%0*lX\n", (unsigned long)meas_read_addr, meas_read_size * 2,
+               (unsigned long)Measure_Load(meas_read_addr, meas_read_size));
+    }
+
+    if (meas_write_done)
+    {
+        printf("mw,ok,%u\n", meas_write_done - 1);
+        meas_write_done = 0;
+    }
+
+    if (!meas_report)
+        return;
+    meas_report = 0;
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MEAS_MAX_ENTRIES; i++)
+    {
+        if (meas_list[i].size) count++;
+    }
+
+    Serial_Telemetry_Enable(0);
+    printf("meas,%u,%u,%u,%lu,%lu,%lu\n", meas_period, count, meas_bytes,
+           (unsigned long)meas_frames, (unsigned long)meas_skipped, (unsigned long)meas_dropped);
+    for (uint8_t i = 0; i < MEAS_MAX_ENTRIES; i++)
+    {
+        if (meas_list[i].size)
+        {
+            printf("meas,%u,%08lX,%u\n", i, (unsigned long)meas_list[i].addr, meas_list[i].size);
+        }
+    }
+    Serial_Telemetry_Enable(1);
+}
@@ -0,0 +1,56 @@
+#ifndef __MEASURE_H
+#define __MEASURE_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 变量测量与标定模块接口说明（参照 XCP/CCP 的地址访问方式）
+ *
+ * 下位机不维护变量名表，上位机从本次构建的链接 map 文件（Image Symbol
+ * Table，需勾选 Local Symbols 以包含 static 变量）查得地址与大小，
+ * 按地址访问，新增观测变量无需修改固件。
+ *
+ * 命令（地址为十六进制，大小为1/2/4字节且按大小对齐）：
+ *   @mlist%<序号>,<地址>,<大小>   定义采集表第<序号>项；@mlist%c 清空
+ *   @mdaq%<周期ms>                开始周期采集，0停止；@mdaq%? 查询
+ *   @mread%<地址>,<大小>          单次读取，回复 mr,<地址>,<值hex>
+ *   @mwrite%<地址>,<大小>,<值hex> 暂存一项写入；@mwrite%c 提交；@mwrite%x 放弃
+ *
+ * 采集表在控制中断中与速度环同一节拍采样（见 Timer.c 的 meas 任务），
+ * 各项为对齐的单次读取，同一帧内的数值属于同一控制周期。
+ * 帧格式：m,<毫秒>,<各项原始字节hex，小端，按序号顺序>\n
+ *
+ * 暂存的写入在提交后的下一个控制节拍内关中断一次写完，速度环不会
+ * 看到只更新了一部分的参数组；完成后回复 mw,ok,<项数>。
+ *
+ * 读取范围限于 SRAM 与本程序 Flash，写入限于 RW/ZI 段（不含栈），
+ * 不访问外设寄存器（读 DR、SR 等有副作用）。
+ *
+ * - Measure_Init()             登记 PendSV 发送处理函数
+ * - Measure_Tick()             控制中断中每1ms调用：提交写入、按周期采样
+ * - Measure_Set_Entry(...)     定义采集表项，返回0表示地址或大小不合法
+ * - Measure_Clear()            清空采集表并停止采集
+ * - Measure_Start(period)      开始/停止周期采集
+ * - Measure_Read(addr, size)   请求单次读取
+ * - Measure_Stage_Write(...)   暂存一项写入，返回0表示不合法或暂存已满
+ * - Measure_Commit(commit)     1提交、0放弃暂存的写入
+ * - Measure_Request_Report()   请求输出采集表与统计
+ * - Measure_PollReport()       主循环中调用，输出读取结果、写入确认与报告
+ * ========================================================== */
+
+#define MEAS_MAX_ENTRIES    12      // 采集表项数
+#define MEAS_MAX_BYTES      32      // 采集表总字节数（限制单帧长度与采样耗时）
+#define MEAS_MAX_WRITES     8       // 一次提交的最大写入项数
+
+void Measure_Init(void);
+void Measure_Tick(void);
+uint8_t Measure_Set_Entry(uint8_t index, uint32_t addr, uint8_t size);
+void Measure_Clear(void);
+void Measure_Start(uint16_t period_ms);
+uint8_t Measure_Read(uint32_t addr, uint8_t size);
+uint8_t Measure_Stage_Write(uint32_t addr, uint8_t size, uint32_t value);
+void Measure_Commit(uint8_t commit);
+void Measure_Request_Report(void);
+void Measure_PollReport(void);
+
+#endif
@@ -0,0 +1,127 @@
+#include "stm32f10x.h"
+#include "MemInfo.h"
+#include "CpuLoad.h"
+#include "Serial.h"
+#include <stdio.h>
+
+/* ==========================================================
+ * 存储器余量统计模块（MemInfo.c）
+ *
+ * 栈只有一个（MSP，启动文件中 Stack_Size），主循环与所有中断共用，
+ * 从 STACK$$Limit 向下增长。MemInfo_Paint 在 main 开头把栈底到当前
+ * SP（留少量余量）之间填满图案，扫描时从栈底向上找第一个被改写的
+ * 字，其上即为历史最大用量。图案可能恰好被写入相同值，结果偏小
+ * 至多一个字。
+ *
+ * 栈高水位只说明"最深到过哪里"，不说明是谁用的；中断嵌套链和各
+ * 中断进入时的栈位置由 CpuLoad 在打点时一并记录，对照即可判断
+ * 最深的栈来自主循环任务还是中断嵌套。
+ * ========================================================== */
+
+#define MEM_PAINT           0xDEADBEEF
+#define MEM_PAINT_MARGIN    16              // 当前SP以下保留不填充的字节数
+#define MEM_FLASH_SIZE_REG  0x1FFFF7E0      // 闪存容量寄存器（KB）
+
+// ARMCC 链接器生成的段符号，取地址即为对应数值
+extern uint32_t STACK$$Base;
+extern uint32_t STACK$$Limit;
+extern uint32_t HEAP$$Base;
+extern uint32_t HEAP$$Limit;
+extern uint32_t Image$$ER_IROM1$$Length;
+extern uint32_t Image$$RW_IRAM1$$RW$$Length;
+extern uint32_t Image$$RW_IRAM1$$ZI$$Length;
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit;
+extern uint32_t Load$$LR$$LR_IROM1$$Limit;
+
+static volatile uint8_t mem_report = 0;
+
+
+/**
+ * @brief 填充栈图案（main 开头调用，此时尚未开启任何中断）
+ */
+void MemInfo_Paint(void)
+{
+    uint32_t *p = &STACK$$Base;
+    uint32_t *end = (uint32_t *)(__get_MSP() - MEM_PAINT_MARGIN);
+
+    while (p < end)
+    {
+        *p++ = MEM_PAINT;
+    }
+}
+
+
+/**
+ * @brief 栈历史最大用量
+ * @return 字节数
+ */
+uint32_t MemInfo_Stack_Peak(void)
+{
+    const uint32_t *p = &STACK$$Base;
+    const uint32_t *limit = &STACK$$Limit;
+
+    while (p < limit && *p == MEM_PAINT)
+    {
+        p++;
+    }
+    return (uint32_t)limit - (uint32_t)p;
+}
+
+
+void MemInfo_Request_Report(void)
+{
+    mem_report = 1;
+}
+
+
+/**
+ * @brief 输出存储器统计（主循环任务中调用）
+ *
+ * 格式：mem,flash,<已用>,<容量>\n
+ *       mem,ram,<RW>,<ZI>,<映像外剩余>\n          （栈和堆计入ZI）
+ *       mem,stack,<大小>,<历史最大>,<当前>\n
+ *       mem,heap,<大小>\n
+ *       mem,nest,<最大嵌套层数>,<上下文链>\n
+ *       mem,isr,<上下文>,<进入时栈用量>\n         （仅已进入过的中断）
+ * 以上单位均为字节。
+ */
+void MemInfo_PollReport(void)
+{
+    if (!mem_report)
+        return;
+    mem_report = 0;
+
+    Serial_Telemetry_Enable(0);
+    uint32_t stack_top = (uint32_t)&STACK$$Limit;
+    uint32_t stack_size = stack_top - (uint32_t)&STACK$$Base;
+
+    printf("mem,flash,%lu,%lu\n",
+           (unsigned long)((uint32_t)&Load$$LR$$LR_IROM1$$Limit - FLASH_BASE),
+           (unsigned long)(*(const uint16_t *)MEM_FLASH_SIZE_REG) * 1024);
+    printf("mem,ram,%lu,%lu,%lu\n",
+           (unsigned long)(uint32_t)&Image$$RW_IRAM1$$RW$$Length,
+           (unsigned long)(uint32_t)&Image$$RW_IRAM1$$ZI$$Length,
+           (unsigned long)(MEM_RAM_END - (uint32_t)&Image$$RW_IRAM1$$ZI$$Limit));
+    printf("mem,stack,%lu,%lu,%lu\n", (unsigned long)stack_size,
+           (unsigned long)MemInfo_Stack_Peak(), (unsigned long)(stack_top - __get_MSP()));
+    printf("mem,heap,%lu\n", (unsigned long)((uint32_t)&HEAP$$Limit - (uint32_t)&HEAP$$Base));
+
+    uint8_t chain[CPU_STACK_DEPTH];
+    uint8_t depth = CpuLoad_Get_Nesting(chain);
+    printf("mem,nest,%u,", depth);
+    for (uint8_t i = 0; i <= depth; i++)
+    {
+        printf(i ? ">%s" : "%s", CpuLoad_Ctx_Name(chain[i]));
+    }
+    printf("\n");
+
+    for (uint8_t ctx = CPU_CTX_CONTROL; ctx < CPU_CTX_COUNT; ctx++)
+    {
+        uint32_t sp = CpuLoad_Get_Entry_SP(ctx);
+        if (sp)
+        {
+            printf("mem,isr,%s,%lu\n", CpuLoad_Ctx_Name(ctx), (unsigned long)(stack_top - sp));
+        }
+    }
+    Serial_Telemetry_Enable(1);
+}
@@ -0,0 +1,28 @@
+#ifndef __MEMINFO_H
+#define __MEMINFO_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 存储器余量统计模块接口说明
+ *
+ * 上电时把主栈未用部分填充固定图案，之后扫描图案被覆盖的最深
+ * 位置得到栈高水位；结合 CpuLoad 记录的中断嵌套链和各中断进入
+ * 时的栈位置，以及链接器给出的各段大小，评估新增缓冲区的空间。
+ *
+ * - MemInfo_Paint()            填充栈图案（main 开头、开中断之前调用）
+ * - MemInfo_Stack_Peak()       栈历史最大用量（字节）
+ * - MemInfo_Request_Report()   请求输出统计
+ * - MemInfo_PollReport()       有报告请求时输出（主循环任务中调用）
+ *
+ * 各段大小取自 ARMCC 链接器符号，默认执行域名 ER_IROM1 / RW_IRAM1。
+ * ========================================================== */
+
+#define MEM_RAM_END         0x20005000      // 20KB SRAM 末地址
+
+void MemInfo_Paint(void);
+uint32_t MemInfo_Stack_Peak(void);
+void MemInfo_Request_Report(void);
+void MemInfo_PollReport(void);
+
+#endif
@@ -1,14 +1,46 @@
 #include "stm32f10x.h"
 #include "Motor.h"
+#include "CpuLoad.h"
 
 //定义全局电机状态变量
 int32_t last_position1 = 0;
 int32_t target_position2 = 0;
 extern uint8_t current_mode;  // 当前控制模式：1-速度模式，2-位置模式等
 
+// 单个电机输出通道：H桥两路方向输入 + 占空比抖动状态
+typedef struct
+{
+    uint16_t pin_fwd;         // 正转时置高的方向引脚（IN1）
+    uint16_t pin_rev;         // 反转时置高的方向引脚（IN2）
+    int8_t dir;               // 当前已输出的方向：1正转，-1反转，0停止
+    uint8_t stop_mode;        // 零指令时的停止方式
+    uint8_t dead_count;       // 换向死区剩余内环周期数
+    uint16_t dither_acc;      // Σ-Δ 小数累加器（Q8），每输出一帧推进一次
+    uint32_t duty_q8;         // 当前占空比（计数值，Q8），由内环逐帧抖动写出
+    uint8_t refresh;          // 死区刚结束，下个内环周期需重新输出
+    volatile int32_t command; // 指令（Q8），由 Motor_Set_Speed_Fine 写入
+    int32_t applied;          // 已输出的指令（Q8），内环按斜率限制逼近 command
+} Motor_Channel;
+
+static Motor_Channel motor_ch[2] =
+{
+    { GPIO_Pin_12, GPIO_Pin_13, 0, MOTOR_STOP_COAST, 0, 0, 0, 0, 0, 0 },
+    { GPIO_Pin_14, GPIO_Pin_15, 0, MOTOR_STOP_COAST, 0, 0, 0, 0, 0, 0 },
+};
+
+static uint8_t motor_dead_time = 10;          // 换向死区（内环周期数，100us）
+static volatile uint32_t motor_bsrr_pending;  // 待提交的方向引脚BSRR字（两电机合并）
+static volatile uint8_t motor_commit_skip;    // 提交前还需等待的更新事件数
+
+// 占空比帧缓冲：每个PWM周期一帧 {CCR3, CCR4}，
+// 由 TIM2 更新事件触发 DMA 突发传输循环写入比较寄存器
+static volatile uint16_t motor_pwm_frames[MOTOR_DITHER_FRAMES][2];
+
 // =====================================================
 // 函数名称：PWM_Init
 // 功能描述：初始化TIM2通道3/4 PWM输出以及电机方向控制GPIO
+//           PWM频率20kHz（3600级），占空比由DMA按帧循环刷新，
+//           内环逐帧Σ-Δ抖动写入，长期平均分辨率达 1/256 级
 // 参数说明：无
 // 返回值：无
 // =====================================================
@@ -17,6 +49,7 @@ void PWM_Init(void)
     //使能GPIOA/B及AFIO时钟
     RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA | RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
     RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
 
     GPIO_InitTypeDef GPIO_InitStructure;
 
@@ -39,8 +72,8 @@ void PWM_Init(void)
     TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
     TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
     TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseStructure.TIM_Period = 1000 - 1;    // PWM周期
-    TIM_TimeBaseStructure.TIM_Prescaler = 72 - 1;   // 1MHz计数频率
+    TIM_TimeBaseStructure.TIM_Period = MOTOR_PWM_PERIOD - 1;  // 72MHz / 3600 = 20kHz
+    TIM_TimeBaseStructure.TIM_Prescaler = 0;                  // 不分频，保证最高分辨率
     TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
     TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
 
@@ -55,78 +88,320 @@ void PWM_Init(void)
     TIM_OC3Init(TIM2, &TIM_OCInitStructure);  // 电机1
     TIM_OC4Init(TIM2, &TIM_OCInitStructure);  // 电机2
 
+    // 开启比较值与自动重装载预装载：新占空比在更新事件时生效，
+    // 方向引脚也在更新中断中提交，两者处于同一时刻
+    TIM_OC3PreloadConfig(TIM2, TIM_OCPreload_Enable);
+    TIM_OC4PreloadConfig(TIM2, TIM_OCPreload_Enable);
+    TIM_ARRPreloadConfig(TIM2, ENABLE);
+
+    // DMA1通道2（TIM2_UP）：每次更新事件经 DMAR 突发写入 CCR3、CCR4
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_DeInit(DMA1_Channel2);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&TIM2->DMAR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)motor_pwm_frames;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = MOTOR_DITHER_FRAMES * 2;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel2, &DMA_InitStructure);
+    DMA_Cmd(DMA1_Channel2, ENABLE);
+
+    TIM_DMAConfig(TIM2, TIM_DMABase_CCR3, TIM_DMABurstLength_2Transfers);
+    TIM_DMACmd(TIM2, TIM_DMA_Update, ENABLE);
+
+    // 更新中断仅在方向待提交时临时开启（见 Motor_Set_Speed）
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel = TIM2_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_Init(&NVIC_InitStructure);
+
     //启动定时器
     TIM_Cmd(TIM2, ENABLE);
 }
 
 
+// 函数名称：Motor_Dither_Write
+// 功能描述：按一阶Σ-Δ把当前占空比写入从 frame 起的 count 帧
+// 参数说明：index - 通道下标（0或1）
+//           frame - 起始帧号
+//           count - 帧数
+// 返回值：无
+// 说明：整数部分每帧相同，小数部分累加溢出时该帧加1个计数。
+//       内环只写DMA接下来读取的帧，累加器与实际输出的帧同步推进，
+//       长期平均值与Q8指令严格一致。
+
+static void Motor_Dither_Write(uint8_t index, uint8_t frame, uint8_t count)
+{
+    uint32_t duty_q8 = motor_ch[index].duty_q8;
+    uint16_t base = duty_q8 >> 8;
+    uint16_t frac = duty_q8 & 0xFF;
+    uint16_t acc = motor_ch[index].dither_acc;
+
+    while(count--)
+    {
+        uint16_t duty = base;
+        acc += frac;
+        if(acc >= 256)
+        {
+            acc -= 256;
+            duty++;
+        }
+        motor_pwm_frames[frame][index] = duty;
+        if(++frame >= MOTOR_DITHER_FRAMES) frame = 0;
+    }
+    motor_ch[index].dither_acc = acc;
+}
+
+
+// 函数名称：Motor_Next_Frame
+// 功能描述：DMA下一次更新事件将读取的帧号
+// 参数说明：无
+// 返回值：帧号（0 ~ MOTOR_DITHER_FRAMES-1）
+// 说明：CNDTR 为本轮剩余传输数（每帧2个半字）；为奇数时突发正在进行，取下一帧。
+
+static uint8_t Motor_Next_Frame(void)
+{
+    uint16_t done = MOTOR_DITHER_FRAMES * 2 - DMA1_Channel2->CNDTR;
+    uint8_t frame = (done + 1) >> 1;
+    return (frame >= MOTOR_DITHER_FRAMES) ? 0 : frame;
+}
+
+
 // 函数名称：Motor_Set_Speed
 // 功能描述：设置指定电机的转速与方向
 // 参数说明：motor_num - 电机编号（1或2）
-//           speed - 速度值，正数正转，负数反转，0停止
+//           speed - 速度值，正数正转，负数反转，0按停止方式处理
 // 返回值：无
+// 说明：只登记指令，由内环 Motor_Duty_Tick 按斜率限制输出。
 
 void Motor_Set_Speed(uint8_t motor_num, int16_t speed)
+{
+    Motor_Set_Speed_Fine(motor_num, (int32_t)speed << 8);
+}
+
+
+// 函数名称：Motor_Set_Speed_Fine
+// 功能描述：以Q8定点精度设置电机速度（小数部分由抖动体现）
+// 参数说明：motor_num - 电机编号（1或2）
+//           speed_q8  - 速度值（Q8，±1000<<8 对应满占空比）
+// 返回值：无
+// 说明：任意上下文可调用，只登记指令（单字写入），输出由内环完成。
+
+void Motor_Set_Speed_Fine(uint8_t motor_num, int32_t speed_q8)
 {
     // 限幅处理 
-    if(speed > 1000) speed = 1000;
-    if(speed < -1000) speed = -1000;
+    if(speed_q8 > (1000 << 8)) speed_q8 = 1000 << 8;
+    if(speed_q8 < -(1000 << 8)) speed_q8 = -(1000 << 8);
 
     // 位置模式特殊限制
     if(current_mode == 2)  // 位置模式
     {
         // 限制最大速度
-        if(speed > 200) speed = 200;
-        if(speed < -200) speed = -200;
+        if(speed_q8 > (200 << 8)) speed_q8 = 200 << 8;
+        if(speed_q8 < -(200 << 8)) speed_q8 = -(200 << 8);
+    }
+    // 不再做死区截断：摩擦由 Friction 模块按标定模型前馈补偿，
+    // 高分辨率抖动使小占空比也能产生成比例的力矩
+
+    if(motor_num != 1 && motor_num != 2) return;
+    motor_ch[motor_num - 1].command = speed_q8;
+}
+
+
+// 函数名称：Motor_Output
+// 功能描述：按指令输出占空比与方向（仅内环调用）
+// 参数说明：index    - 通道下标（0或1）
+//           speed_q8 - 指令（Q8）
+// 返回值：1-本周期处于换向死区
+// 说明：方向引脚只暂存为BSRR字，由 TIM2 更新中断在新占空比
+//       生效的更新事件一次性写入；占空比由内环逐帧抖动写入DMA帧缓冲。
+//       反向切换时先插入死区（两路输入均为低、占空比为0）。
+
+static uint8_t Motor_Output(uint8_t index, int32_t speed_q8)
+{
+    Motor_Channel *ch = &motor_ch[index];
 
-        // 死区处理：避免微小振荡
-        if(speed > 0 && speed < 120) speed = 0;
-        else if(speed < 0 && speed > -120) speed = 0;
+    int8_t dir = (speed_q8 > 0) ? 1 : ((speed_q8 < 0) ? -1 : 0);
+    uint32_t magnitude = (speed_q8 < 0) ? -speed_q8 : speed_q8;              // 占空比取正
+    uint32_t duty = magnitude * MOTOR_PWM_PERIOD / 1000;                      // 换算为计数值（Q8）
+
+    // 正反向直接切换：先经过死区，期间两路输入为低、不输出占空比
+    uint8_t in_dead = 0;
+    if(dir != 0 && ch->dir == -dir && motor_dead_time > 0)
+    {
+        ch->dead_count = motor_dead_time;
     }
-    else  // 速度模式
+    if(ch->dead_count > 0)
     {
-        if(speed > 0 && speed < 30) speed = 0;
-        else if(speed < 0 && speed > -30) speed = 0;
+        ch->dead_count--;
+        in_dead = 1;
+        dir = 0;
+        duty = 0;
     }
 
-    // 设置电机1
-    if(motor_num == 1)
+    uint32_t bits;
+    if(dir > 0)
     {
-        if(speed == 0)
-        {
-            GPIO_ResetBits(GPIOB, GPIO_Pin_12 | GPIO_Pin_13);  // 停止
-        }
-        else if(speed > 0)
-        {
-            GPIO_SetBits(GPIOB, GPIO_Pin_12);
-            GPIO_ResetBits(GPIOB, GPIO_Pin_13);  // 正转
-        }
-        else
-        {
-            GPIO_ResetBits(GPIOB, GPIO_Pin_12);
-            GPIO_SetBits(GPIOB, GPIO_Pin_13);    // 反转
-            speed = -speed;                       // 占空比取正
-        }
-        TIM_SetCompare3(TIM2, speed);  // 设置占空比
+        bits = ch->pin_fwd | ((uint32_t)ch->pin_rev << 16);         // 正转
+    }
+    else if(dir < 0)
+    {
+        bits = ch->pin_rev | ((uint32_t)ch->pin_fwd << 16);         // 反转
+    }
+    else if(ch->stop_mode == MOTOR_STOP_BRAKE && !in_dead)
+    {
+        bits = ch->pin_fwd | ch->pin_rev;                            // 两路均高：短路制动
+        duty = (uint32_t)MOTOR_PWM_PERIOD << 8;                      // 使能端常高
     }
-    // 设置电机2
-    else if(motor_num == 2)
+    else
     {
-        if(speed == 0)
+        bits = ((uint32_t)(ch->pin_fwd | ch->pin_rev)) << 16;       // 两路均低：惰行
+    }
+    ch->dir = dir;
+
+    // 先登记新占空比（本周期即写入DMA下一帧），再登记方向
+    ch->duty_q8 = duty;
+
+    // 合并进待提交字：先清除本电机对应的置位/复位位
+    // 比较值有预装载：更新事件 T 由DMA写入的新占空比在 T+1 才生效，
+    // 方向因此在开启中断后的第二个更新事件提交，与新占空比同时生效；
+    // 开启中断前清除残留的更新标志，否则中断立即进入、在周期中间改方向
+    uint32_t mask = (uint32_t)(ch->pin_fwd | ch->pin_rev) * 0x00010001u;
+    __disable_irq();
+    uint32_t pending = (motor_bsrr_pending & ~mask) | bits;
+    if(pending != motor_bsrr_pending)
+    {
+        motor_bsrr_pending = pending;
+        motor_commit_skip = 1;
+        TIM2->SR = (uint16_t)~TIM_IT_Update;
+        TIM2->DIER |= TIM_IT_Update;
+    }
+    __enable_irq();
+    return in_dead;
+}
+
+
+// 函数名称：Motor_Duty_Tick
+// 功能描述：占空比内环，控制时基每100us调用一次（见 Timer.c）
+// 参数说明：无
+// 返回值：无
+// 说明：已输出指令每周期最多变化 MOTOR_SLEW_Q8，速度环1ms一次的指令
+//       阶跃被分摊到若干个PWM周期，限制H桥电流冲击；换向死区也按
+//       内环周期计时。指令未变化的周期不重新计算方向与占空比，
+//       但每周期都写入DMA随后读取的 MOTOR_FRAMES_PER_TICK 帧，
+//       抖动按实际输出的帧推进。
+
+void Motor_Duty_Tick(void)
+{
+    uint8_t frame = Motor_Next_Frame();
+
+    for(uint8_t i = 0; i < 2; i++)
+    {
+        Motor_Channel *ch = &motor_ch[i];
+        int32_t step = ch->command - ch->applied;
+
+        if(step > MOTOR_SLEW_Q8) step = MOTOR_SLEW_Q8;
+        if(step < -MOTOR_SLEW_Q8) step = -MOTOR_SLEW_Q8;
+        if(step != 0 || ch->dead_count != 0 || ch->refresh)
         {
-            GPIO_ResetBits(GPIOB, GPIO_Pin_14 | GPIO_Pin_15);
+            ch->applied += step;
+            ch->refresh = Motor_Output(i, ch->applied);
         }
-        else if(speed > 0)
+        Motor_Dither_Write(i, frame, MOTOR_FRAMES_PER_TICK);
+    }
+}
+
+
+// 函数名称：TIM2_IRQHandler
+// 功能描述：PWM更新事件中断，提交暂存的方向引脚（单次BSRR写入）
+// 参数说明：无
+// 返回值：无
+// 说明：仅在方向待提交时开启，提交后立即关闭，平时不占用CPU。
+//       第一个更新事件只等待（新占空比在此写入预装载），第二个更新事件提交。
+
+void TIM2_IRQHandler(void)
+{
+    CPULOAD_ENTER(CPU_CTX_PWM);
+    if(TIM2->SR & TIM_IT_Update)
+    {
+        TIM2->SR = (uint16_t)~TIM_IT_Update;
+        if(motor_commit_skip)
         {
-            GPIO_SetBits(GPIOB, GPIO_Pin_14);
-            GPIO_ResetBits(GPIOB, GPIO_Pin_15);
+            motor_commit_skip--;
         }
         else
         {
-            GPIO_ResetBits(GPIOB, GPIO_Pin_14);
-            GPIO_SetBits(GPIOB, GPIO_Pin_15);
-            speed = -speed;
+            GPIOB->BSRR = motor_bsrr_pending;
+            TIM2->DIER &= (uint16_t)~TIM_IT_Update;
         }
-        TIM_SetCompare4(TIM2, speed);
     }
+    CPULOAD_EXIT();
+}
+
+
+// 函数名称：Motor_Set_StopMode
+// 功能描述：设置零指令时的停止方式
+// 参数说明：motor_num - 电机编号（1或2）
+//           mode - MOTOR_STOP_COAST 惰行 / MOTOR_STOP_BRAKE 短路制动
+// 返回值：无
+
+void Motor_Set_StopMode(uint8_t motor_num, uint8_t mode)
+{
+    if(motor_num == 1 || motor_num == 2)
+    {
+        motor_ch[motor_num - 1].stop_mode = mode;
+    }
+}
+
+
+// 函数名称：Motor_Set_DeadTime
+// 功能描述：设置正反转切换死区
+// 参数说明：ticks - 死区长度（内环周期数，100us），0表示不插入死区
+// 返回值：无
+
+void Motor_Set_DeadTime(uint8_t ticks)
+{
+    motor_dead_time = ticks;
+}
+
+
+// 函数名称：Motor_Stop_All
+// 功能描述：立即使两个电机惰行（方向引脚全部拉低，占空比清零）
+// 参数说明：无
+// 返回值：无
+
+void Motor_Stop_All(void)
+{
+    __disable_irq();
+    motor_bsrr_pending = (uint32_t)(GPIO_Pin_12 | GPIO_Pin_13 | GPIO_Pin_14 | GPIO_Pin_15) << 16;
+    GPIOB->BSRR = motor_bsrr_pending;
+    motor_ch[0].dir = motor_ch[1].dir = 0;
+    motor_ch[0].dead_count = motor_ch[1].dead_count = 0;
+    motor_ch[0].dither_acc = motor_ch[1].dither_acc = 0;
+    motor_ch[0].command = motor_ch[1].command = 0;
+    motor_ch[0].applied = motor_ch[1].applied = 0;
+    motor_ch[0].refresh = motor_ch[1].refresh = 0;
+    motor_ch[0].duty_q8 = motor_ch[1].duty_q8 = 0;
+    __enable_irq();
+
+    Motor_Dither_Write(0, 0, MOTOR_DITHER_FRAMES);
+    Motor_Dither_Write(1, 0, MOTOR_DITHER_FRAMES);
+}
+
+
+// 函数名称：Motor_Is_Idle
+// 功能描述：判断两个电机是否均无驱动输出（停止、制动或处于换向死区）
+// 参数说明：无
+// 返回值：1-均无输出，0-至少一个电机正在驱动
+
+uint8_t Motor_Is_Idle(void)
+{
+    return motor_ch[0].dir == 0 && motor_ch[1].dir == 0;
 }
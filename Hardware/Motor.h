@@ -7,6 +7,21 @@
 // 模块名称：Motor（电机驱动模块）
 // 功能说明：提供电机PWM初始化和速度控制接口
 
+// PWM参数：72MHz / 3600 = 20kHz，超出听觉范围
+#define MOTOR_PWM_PERIOD     3600
+// 抖动帧数：等于每个控制周期（1ms）内的PWM周期数
+#define MOTOR_DITHER_FRAMES  20
+// 每个占空比内环周期（100us）DMA读取的帧数
+#define MOTOR_FRAMES_PER_TICK 2
+
+// 占空比内环斜率限制：每个内环周期（100us）指令最多变化量（Q8），
+// 即每ms 500，0到满量程约2ms；速度环每周期输出变化小于500时不受影响
+#define MOTOR_SLEW_Q8        (50 << 8)
+
+// 零指令停止方式
+#define MOTOR_STOP_COAST   0   // 惰行：H桥两路输入均为低
+#define MOTOR_STOP_BRAKE   1   // 制动：H桥两路输入均为高，使能端常高
+
 // 初始化PWM及电机相关GPIO
 void PWM_Init(void);
 
@@ -15,6 +30,25 @@ void PWM_Init(void);
 // 参数 speed     : 速度值，正数正转，负数反转，0停止
 void Motor_Set_Speed(uint8_t motor_num, int16_t speed);
 
+// 以Q8精度设置电机速度（speed_q8 = speed << 8），小数部分经Σ-Δ抖动输出
+// 两者都只登记指令，下一个内环周期起按斜率限制输出
+void Motor_Set_Speed_Fine(uint8_t motor_num, int32_t speed_q8);
+
+// 占空比内环（10kHz，控制时基中断调用）
+void Motor_Duty_Tick(void);
+
+// 设置零指令停止方式（MOTOR_STOP_COAST / MOTOR_STOP_BRAKE）
+void Motor_Set_StopMode(uint8_t motor_num, uint8_t mode);
+
+// 设置正反转切换死区（内环周期数，100us，0为不插入）
+void Motor_Set_DeadTime(uint8_t ticks);
+
+// 立即停止两个电机（惰行）
+void Motor_Stop_All(void);
+
+// 两个电机均无驱动输出（占空比为0）时返回1
+uint8_t Motor_Is_Idle(void);
+
 // 电机处理函数（可扩展为闭环控制等）
 void Motor_Process(void);
 
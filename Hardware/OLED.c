@@ -1,5 +1,6 @@
 #include "stm32f10x.h"
 #include "OLED_Font.h"
+#include "Fmt.h"
 
 /*引脚配置*/
 #define OLED_W_SCL(x)		GPIO_WriteBit(GPIOB, GPIO_Pin_8, (BitAction)(x))
@@ -163,17 +164,20 @@ void OLED_ShowString(uint8_t Line, uint8_t Column, char *String)
 }
 
 /**
-  * @brief  OLED次方函数
-  * @retval 返回值等于X的Y次方
+  * @brief  OLED显示一段定长字符（数字显示共用）
+  * @param  Line 起始行位置，范围：1~4
+  * @param  Column 起始列位置，范围：1~16
+  * @param  Chars 字符缓冲，不要求结束符
+  * @param  Length 字符数
+  * @retval 无
   */
-uint32_t OLED_Pow(uint32_t X, uint32_t Y)
+static void OLED_ShowChars(uint8_t Line, uint8_t Column, const char *Chars, uint8_t Length)
 {
-	uint32_t Result = 1;
-	while (Y--)
+	uint8_t i;
+	for (i = 0; i < Length; i++)
 	{
-		Result *= X;
+		OLED_ShowChar(Line, Column + i, Chars[i]);
 	}
-	return Result;
 }
 
 /**
@@ -186,11 +190,9 @@ uint32_t OLED_Pow(uint32_t X, uint32_t Y)
   */
 void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
 {
-	uint8_t i;
-	for (i = 0; i < Length; i++)							
-	{
-		OLED_ShowChar(Line, Column + i, Number / OLED_Pow(10, Length - i - 1) % 10 + '0');
-	}
+	char Digits[10];
+	Fmt_Uint_Fixed(Digits, Number, Length);
+	OLED_ShowChars(Line, Column, Digits, Length);
 }
 
 /**
@@ -203,7 +205,7 @@ void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
   */
 void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Length)
 {
-	uint8_t i;
+	char Digits[10];
 	uint32_t Number1;
 	if (Number >= 0)
 	{
@@ -215,10 +217,8 @@ void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Le
 		OLED_ShowChar(Line, Column, '-');
 		Number1 = -Number;
 	}
-	for (i = 0; i < Length; i++)							
-	{
-		OLED_ShowChar(Line, Column + i + 1, Number1 / OLED_Pow(10, Length - i - 1) % 10 + '0');
-	}
+	Fmt_Uint_Fixed(Digits, Number1, Length);
+	OLED_ShowChars(Line, Column + 1, Digits, Length);
 }
 
 /**
@@ -231,19 +231,9 @@ void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Le
   */
 void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
 {
-	uint8_t i, SingleNumber;
-	for (i = 0; i < Length; i++)							
-	{
-		SingleNumber = Number / OLED_Pow(16, Length - i - 1) % 16;
-		if (SingleNumber < 10)
-		{
-			OLED_ShowChar(Line, Column + i, SingleNumber + '0');
-		}
-		else
-		{
-			OLED_ShowChar(Line, Column + i, SingleNumber - 10 + 'A');
-		}
-	}
+	char Digits[8];
+	Fmt_Hex_Fixed(Digits, Number, Length);
+	OLED_ShowChars(Line, Column, Digits, Length);
 }
 
 /**
@@ -259,7 +249,7 @@ void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Leng
 	uint8_t i;
 	for (i = 0; i < Length; i++)							
 	{
-		OLED_ShowChar(Line, Column + i, Number / OLED_Pow(2, Length - i - 1) % 2 + '0');
+		OLED_ShowChar(Line, Column + i, ((Number >> (Length - i - 1)) & 1) + '0');
 	}
 }
 
@@ -0,0 +1,250 @@
+#include "stm32f10x.h"
+#include "Observer.h"
+#include "Serial.h"
+#include "Delay.h"
+#include <stdio.h>
+
+/* ==========================================================
+ * 编码器状态观测器模块（Observer.c）
+ *
+ * 原速度为每周期计数差分，量化为整数脉冲；速度环微分项再对其
+ * 差分，相当于对量化数据取二阶差分，噪声很大。本模块用常加速度
+ * 模型的 α-β-γ 滤波（稳态卡尔曼滤波的定点形式）平滑估计：
+ *     预测  x' = x + v + a/2，v' = v + a
+ *     残差  r  = z - x'
+ *     修正  x = x' + α·r，v = v' + β·r，a = a + 2γ·r
+ * 周期 T 取1个控制周期，速度单位为 脉冲/周期。
+ *
+ * 定点格式：位置 Q16（int64，避免累计位置溢出），速度、加速度、
+ * 增益均为 Q16。每轴每周期4次64位乘法，无除法。
+ *
+ * 增益可直接设置，也可由衰减记忆因子 θ（0~1）按临界阻尼取值：
+ *     α = 1 - θ³，β = 1.5(1-θ)²(1+θ)，γ = 0.5(1-θ)³
+ * θ 越大越平滑、滞后越大。
+ * ========================================================== */
+
+#define OBS_AXES            2
+#define OBS_SPEED_SCALE     121242      // 1.85（Q16），与 Encoder_Get_Speed 一致
+#define OBS_THETA_DEFAULT   52429       // 0.8
+
+typedef struct
+{
+    int64_t x;              // 位置（Q16）
+    int32_t v;              // 速度（Q16，脉冲/周期）
+    int32_t a;              // 加速度（Q16，脉冲/周期²）
+    int32_t alpha;          // 增益（Q16）
+    int32_t beta;
+    int32_t gamma2;         // 2γ（Q16）
+    uint8_t rebase;         // 下次更新时将位置对齐到测量值
+} Observer_Axis;
+
+static Observer_Axis obs_axis[OBS_AXES];
+static volatile uint8_t obs_feedback = 0;
+static volatile uint8_t obs_report = 0;
+static uint32_t obs_max_cycles = 0;         // 单轴单次更新最大周期数
+
+
+/**
+ * @brief 取轴状态，编号无效时返回空
+ */
+static Observer_Axis *Observer_Axis_Get(uint8_t num)
+{
+    if (num < 1 || num > OBS_AXES)
+        return 0;
+    return &obs_axis[num - 1];
+}
+
+
+/**
+ * @brief 初始化观测器：默认 θ=0.8，首次更新时对齐到测量位置
+ */
+void Observer_Init(void)
+{
+    for (uint8_t i = 1; i <= OBS_AXES; i++)
+    {
+        Observer_Set_Theta(i, OBS_THETA_DEFAULT);
+        obs_axis[i - 1].v = 0;
+        obs_axis[i - 1].a = 0;
+        obs_axis[i - 1].rebase = 1;
+    }
+}
+
+
+/**
+ * @brief 观测器单步更新（控制中断中每周期调用）
+ * @param num 电机编号（1、2）
+ * @param pos 编码器累计位置（脉冲）
+ */
+void Observer_Update(uint8_t num, int32_t pos)
+{
+    Observer_Axis *axis = Observer_Axis_Get(num);
+    if (!axis)
+        return;
+
+    uint32_t start = DWT_CYCCNT;
+    int64_t z = (int64_t)pos << 16;
+
+    if (axis->rebase)
+    {
+        // 只对齐位置，保留速度与加速度估计，避免清零后速度跳变
+        axis->rebase = 0;
+        axis->x = z;
+        return;
+    }
+
+    // 预测
+    int64_t xp = axis->x + axis->v + (axis->a >> 1);
+    int32_t vp = axis->v + axis->a;
+
+    // 残差限幅到 ±32767 脉冲，防止异常跳变导致溢出
+    int64_t r64 = z - xp;
+    if (r64 > 0x7FFFFFFFLL) r64 = 0x7FFFFFFFLL;
+    if (r64 < -0x7FFFFFFFLL) r64 = -0x7FFFFFFFLL;
+    int32_t r = (int32_t)r64;
+
+    // 修正
+    axis->x = xp + (((int64_t)axis->alpha * r) >> 16);
+    axis->v = vp + (int32_t)(((int64_t)axis->beta * r) >> 16);
+    axis->a = axis->a + (int32_t)(((int64_t)axis->gamma2 * r) >> 16);
+
+    uint32_t cycles = DWT_CYCCNT - start;
+    if (cycles > obs_max_cycles) obs_max_cycles = cycles;
+}
+
+
+int32_t Observer_Get_Position(uint8_t num)
+{
+    Observer_Axis *axis = Observer_Axis_Get(num);
+    return axis ? (int32_t)((axis->x + 32768) >> 16) : 0;
+}
+
+
+/**
+ * @brief 获取估计速度
+ * @return 与 Encoder_Get_Speed 相同单位（脉冲差×1.85）
+ */
+int16_t Observer_Get_Speed(uint8_t num)
+{
+    Observer_Axis *axis = Observer_Axis_Get(num);
+    if (!axis)
+        return 0;
+
+    // 四舍五入：直接右移向负无穷取整，会给速度环带来 -0.5 的固定偏差
+    int32_t speed = (int32_t)(((int64_t)axis->v * OBS_SPEED_SCALE + (1LL << 31)) >> 32);
+    if (speed > 32767) speed = 32767;
+    if (speed < -32768) speed = -32768;
+    return (int16_t)speed;
+}
+
+
+int32_t Observer_Get_Accel_Q16(uint8_t num)
+{
+    Observer_Axis *axis = Observer_Axis_Get(num);
+    return axis ? axis->a : 0;
+}
+
+
+static void Observer_Apply_Gains(uint8_t num, int32_t alpha, int32_t beta, int32_t gamma)
+{
+    Observer_Axis *axis = Observer_Axis_Get(num);
+    if (!axis)
+        return;
+
+    axis->alpha = alpha;
+    axis->beta = beta;
+    axis->gamma2 = gamma * 2;
+}
+
+
+/**
+ * @brief 直接设置滤波增益
+ * @param alpha、beta、gamma Q16，须在稳定域 0<α≤1，0<β<2，0<γ<β 内
+ * @return 1：已设置；0：编号无效或超出稳定域（发散后加速度溢出），增益不变
+ */
+uint8_t Observer_Set_Gains(uint8_t num, int32_t alpha, int32_t beta, int32_t gamma)
+{
+    if (!Observer_Axis_Get(num) || alpha <= 0 || alpha > 65536 || beta <= 0 || beta >= 131072 ||
+        gamma <= 0 || gamma >= beta)
+        return 0;
+
+    Observer_Apply_Gains(num, alpha, beta, gamma);
+    return 1;
+}
+
+
+/**
+ * @brief 按衰减记忆因子设置增益（临界阻尼）
+ * @param theta Q16，取值 0~65535
+ */
+void Observer_Set_Theta(uint8_t num, int32_t theta)
+{
+    if (theta < 0) theta = 0;
+    if (theta > 65535) theta = 65535;
+
+    int32_t one_minus = 65536 - theta;                                      // 1-θ
+    int32_t sq = (int32_t)(((int64_t)one_minus * one_minus) >> 16);         // (1-θ)²
+    int32_t cube = (int32_t)(((int64_t)sq * one_minus) >> 16);              // (1-θ)³
+    int32_t theta3 = (int32_t)(((((int64_t)theta * theta) >> 16) * theta) >> 16);
+
+    int32_t alpha = 65536 - theta3;
+    int32_t beta = (int32_t)(((int64_t)sq * 3 * (65536 + theta)) >> 17);
+    int32_t gamma = cube >> 1;
+
+    Observer_Apply_Gains(num, alpha, beta, gamma);
+}
+
+
+/**
+ * @brief 编码器累计位置清零后调用，下一周期位置重新对齐
+ */
+void Observer_Rebase(uint8_t num)
+{
+    Observer_Axis *axis = Observer_Axis_Get(num);
+    if (axis)
+    {
+        axis->rebase = 1;
+    }
+}
+
+
+void Observer_Use_Feedback(uint8_t enable)
+{
+    obs_feedback = enable;
+}
+
+
+uint8_t Observer_Feedback_Enabled(void)
+{
+    return obs_feedback;
+}
+
+
+void Observer_Request_Report(void)
+{
+    obs_report = 1;
+}
+
+
+/**
+ * @brief 输出观测器状态（主循环中调用）
+ *
+ * 格式：obs,<反馈开关>,<最大周期数> 后接每轴
+ *       obs,<编号>,<α>,<β>,<γ>,<速度>,<加速度>\n
+ */
+void Observer_PollReport(void)
+{
+    if (!obs_report)
+        return;
+    obs_report = 0;
+
+    Serial_Telemetry_Enable(0);
+    printf("obs,%d,%lu\n", obs_feedback, (unsigned long)obs_max_cycles);
+    for (uint8_t i = 1; i <= OBS_AXES; i++)
+    {
+        Observer_Axis *axis = Observer_Axis_Get(i);
+        printf("obs,%d,%.4f,%.4f,%.5f,%d,%.4f\n", i,
+               axis->alpha / 65536.0f, axis->beta / 65536.0f, axis->gamma2 / 131072.0f,
+               Observer_Get_Speed(i), axis->a / 65536.0f);
+    }
+    Serial_Telemetry_Enable(1);
+}
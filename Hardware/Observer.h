@@ -0,0 +1,39 @@
+#ifndef __OBSERVER_H
+#define __OBSERVER_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 编码器状态观测器模块接口说明（α-β-γ 滤波）
+ *
+ * 每个控制周期由编码器累计位置估计电机1、2的位置、速度、加速度。
+ * 速度输出单位与 Encoder_Get_Speed 相同，可直接替代原始差分速度。
+ *
+ * - Observer_Init()                     初始化（默认 θ=0.8）
+ * - Observer_Update(num, pos)           控制中断中每周期调用
+ * - Observer_Get_Position(num)          估计位置（脉冲）
+ * - Observer_Get_Speed(num)             估计速度（与 Encoder_Get_Speed 同单位）
+ * - Observer_Get_Accel_Q16(num)         估计加速度（脉冲/周期²，Q16）
+ * - Observer_Set_Gains(num, α, β, γ)    直接设置增益（Q16），超出稳定域返回0
+ * - Observer_Set_Theta(num, θ)          按衰减记忆因子 θ（Q16）设置增益
+ * - Observer_Rebase(num)                编码器清零后调用，位置重新对齐
+ * - Observer_Use_Feedback(en)           速度环与遥测改用估计速度
+ * - Observer_Feedback_Enabled()         已启用返回1
+ * - Observer_Request_Report()           请求主循环输出增益与耗时
+ * - Observer_PollReport()               有报告请求时输出
+ * ========================================================== */
+
+void Observer_Init(void);
+void Observer_Update(uint8_t num, int32_t pos);
+int32_t Observer_Get_Position(uint8_t num);
+int16_t Observer_Get_Speed(uint8_t num);
+int32_t Observer_Get_Accel_Q16(uint8_t num);
+uint8_t Observer_Set_Gains(uint8_t num, int32_t alpha, int32_t beta, int32_t gamma);
+void Observer_Set_Theta(uint8_t num, int32_t theta);
+void Observer_Rebase(uint8_t num);
+void Observer_Use_Feedback(uint8_t enable);
+uint8_t Observer_Feedback_Enabled(void);
+void Observer_Request_Report(void);
+void Observer_PollReport(void);
+
+#endif
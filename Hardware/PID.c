@@ -1,24 +1,31 @@
 #include "stm32f10x.h"
 #include "stdlib.h"
+#include "PID.h"
 
 
-static float speed_output = 0.0f;        
 static float speed_kp = 2.0f;
 static float speed_ki = 0.5f;
 static float speed_kd = 0.1f;
 
-// 误差队列：error[0] 当前误差, error[1] 上次误差, error[2] 上上次误差
-static float speed_err[3] = {0, 0, 0};   
+// 速度环状态：每个电机一份，增益两电机共用（同步模式下两个速度环同时运行）
+typedef struct
+{
+    float output;
+    float err[3];       // err[0] 当前误差, err[1] 上次误差, err[2] 上上次误差
+} Speed_PID_State;
+
+static Speed_PID_State speed_pid[2];
 
 /* 位置环 PID 参数  */
 // 位置环使用纯比例控制（无积分与微分项，减少机械振荡）
 static float position_kp = 0.15f;       
 
 /**
- * @brief 增量式速度 PID 计算函数
+ * @brief 增量式速度 PID 计算函数（指定电机）
+ * @param num     电机编号（1或2）
  * @param target  目标速度值
  * @param actual  实际速度值（编码器反馈）
- * @return PWM 输出增量（int16_t）
+ * @return PWM 输出（int16_t）
  * 
  * 公式说明：
  * Δu = Kp*(e(k)-e(k-1)) + Ki*e(k) + Kd*(e(k)-2e(k-1)+e(k-2))
@@ -26,24 +33,34 @@ static float position_kp = 0.15f;
  * 增量式 PID 仅输出“变化量”，适合电机速度闭环控制，
  * 能有效抑制积分饱和与突变。
  */
-int16_t Speed_PID_Compute(int16_t target, int16_t actual)  // ★修改：原函数名 Speed_PID_Calculate
+int16_t Speed_PID_Compute_Motor(uint8_t num, int16_t target, int16_t actual)
 {
+    Speed_PID_State *s = &speed_pid[num == 2 ? 1 : 0];
+
     /* 1️更新误差序列 */
-    speed_err[2] = speed_err[1];
-    speed_err[1] = speed_err[0];
-    speed_err[0] = target - actual;   // 当前误差 e(k)
+    s->err[2] = s->err[1];
+    s->err[1] = s->err[0];
+    s->err[0] = target - actual;   // 当前误差 e(k)
     
     /* 2️增量式 PID 计算公式 */
-    speed_output += speed_kp * (speed_err[0] - speed_err[1]) +
-                    speed_ki * speed_err[0] +
-                    speed_kd * (speed_err[0] - 2 * speed_err[1] + speed_err[2]);
+    s->output += speed_kp * (s->err[0] - s->err[1]) +
+                 speed_ki * s->err[0] +
+                 speed_kd * (s->err[0] - 2 * s->err[1] + s->err[2]);
     
     /* 3️输出限幅，防止PWM过大损坏电机 */
-    if (speed_output > 800)  speed_output = 800;
-    if (speed_output < -800) speed_output = -800;
+    if (s->output > SPEED_PID_OUT_MAX)  s->output = SPEED_PID_OUT_MAX;
+    if (s->output < -SPEED_PID_OUT_MAX) s->output = -SPEED_PID_OUT_MAX;
     
     /* 4️返回控制量（PWM值） */
-    return (int16_t)speed_output;
+    return (int16_t)s->output;
+}
+
+/**
+ * @brief 电机1速度 PID（速度模式、自整定使用）
+ */
+int16_t Speed_PID_Compute(int16_t target, int16_t actual)  // ★修改：原函数名 Speed_PID_Calculate
+{
+    return Speed_PID_Compute_Motor(1, target, actual);
 }
 
 /**
@@ -82,6 +99,16 @@ void Speed_PID_SetParams(float p, float i, float d)
     // ★新增注释：允许上位机动态调参以优化响应
 }
 
+/**
+ * @brief 读取当前速度环 PID 参数（自适应、整定等模块可能已改写）
+ */
+void Speed_PID_GetParams(float *p, float *i, float *d)
+{
+    *p = speed_kp;
+    *i = speed_ki;
+    *d = speed_kd;
+}
+
 /**
  * @brief 设置位置环 PID 参数
  * @param p 比例系数
@@ -95,13 +122,16 @@ void Position_PID_SetParams(float p, float i, float d)
 }
 
 /**
- * @brief 重置速度 PID 内部状态
+ * @brief 重置速度 PID 内部状态（两个电机）
  * 
  * 在模式切换或目标速度突变时调用，
  * 清空积分累积与历史误差，防止积分饱和。
  */
 void Speed_PID_Reset(void)
 {
-    speed_err[0] = speed_err[1] = speed_err[2] = 0;
-    speed_output = 0.0f;  
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        speed_pid[i].err[0] = speed_pid[i].err[1] = speed_pid[i].err[2] = 0;
+        speed_pid[i].output = 0.0f;
+    }
 }
@@ -3,9 +3,13 @@
 
 #include "stm32f10x.h"
 
+#define SPEED_PID_OUT_MAX   800     // 速度环输出限幅（PWM）
+
 void Speed_PID_SetParams(float p, float i, float d);
+void Speed_PID_GetParams(float *p, float *i, float *d);
 void Position_PID_SetParams(float p, float i, float d);
 int16_t Speed_PID_Compute(int16_t target, int16_t actual);  
+int16_t Speed_PID_Compute_Motor(uint8_t num, int16_t target, int16_t actual);
 
 int16_t Position_PID_Compute(int32_t target, int32_t actual);
 void Speed_PID_Reset(void);
@@ -0,0 +1,144 @@
+#include "stm32f10x.h"
+#include "Param.h"
+#include "Motor.h"
+#include <string.h>
+#include <stdio.h>
+
+/* ==========================================================
+ * 参数存储模块（Param.c）
+ * 功能：
+ *  - 在 Flash 最后一页保存标定结果、增益表等运行参数
+ *  - 以魔数、版本号、长度和校验和判断数据有效性
+ * ========================================================== */
+
+Param_Data param;
+static volatile uint8_t param_save_request = 0;
+
+// Flash按字编程，结构体长度必须为4的整数倍
+typedef char Param_SizeCheck[(sizeof(Param_Data) % 4 == 0) ? 1 : -1];
+
+
+/**
+ * @brief 计算参数区校验和（不含 checksum 字段本身）
+ * @param data 参数结构体
+ * @return 32位累加校验和
+ */
+static uint32_t Param_Checksum(const Param_Data *data)
+{
+    const uint32_t *word = (const uint32_t *)data;
+    uint32_t count = (sizeof(Param_Data) - sizeof(uint32_t)) / 4;
+    uint32_t sum = 0x5A5A5A5A;
+
+    while (count--)
+    {
+        sum = (sum << 1 | sum >> 31) + *word++;   // 循环左移后累加，能发现字交换
+    }
+    return sum;
+}
+
+
+/**
+ * @brief 装入默认参数
+ * 
+ * 摩擦模型默认全零，即不做补偿；位置模式的修正脉冲在未标定时
+ * 仍使用原固定值（见 Friction_Breakaway）。
+ */
+void Param_Default(void)
+{
+    memset(&param, 0, sizeof(param));
+    param.magic = PARAM_MAGIC;
+    param.version = PARAM_VERSION;
+    param.size = sizeof(Param_Data);
+}
+
+
+/**
+ * @brief 从Flash读取参数
+ * @return 1：数据有效并已载入；0：数据无效，已装入默认值
+ */
+uint8_t Param_Load(void)
+{
+    const Param_Data *stored = (const Param_Data *)PARAM_FLASH_ADDR;
+
+    if (stored->magic != PARAM_MAGIC ||
+        stored->version != PARAM_VERSION ||
+        stored->size != sizeof(Param_Data) ||
+        stored->checksum != Param_Checksum(stored))
+    {
+        Param_Default();
+        return 0;
+    }
+
+    memcpy(&param, stored, sizeof(Param_Data));
+    return 1;
+}
+
+
+/**
+ * @brief 将当前参数写入Flash
+ * @return PARAM_SAVE_OK：写入并校验成功；PARAM_SAVE_FAIL：失败；
+ *         PARAM_SAVE_BUSY：电机有输出，未写入
+ * 
+ * 擦除一页约需20ms，期间从Flash取指的代码（含中断）都会停顿，
+ * 控制环不运行、电机保持停顿前的输出，因此只在两个电机均无输出时写入。
+ * 不可在中断中调用。
+ */
+uint8_t Param_Save(void)
+{
+    const uint32_t *word = (const uint32_t *)&param;
+    uint32_t address = PARAM_FLASH_ADDR;
+
+    if (!Motor_Is_Idle())
+        return PARAM_SAVE_BUSY;
+
+    param.magic = PARAM_MAGIC;
+    param.version = PARAM_VERSION;
+    param.size = sizeof(Param_Data);
+    param.checksum = Param_Checksum(&param);
+
+    FLASH_Unlock();
+    FLASH_ClearFlag(FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
+
+    if (FLASH_ErasePage(PARAM_FLASH_ADDR) != FLASH_COMPLETE)
+    {
+        FLASH_Lock();
+        return PARAM_SAVE_FAIL;
+    }
+
+    for (uint32_t i = 0; i < sizeof(Param_Data) / 4; i++)
+    {
+        if (FLASH_ProgramWord(address, word[i]) != FLASH_COMPLETE)
+        {
+            FLASH_Lock();
+            return PARAM_SAVE_FAIL;
+        }
+        address += 4;
+    }
+    FLASH_Lock();
+
+    return memcmp((const void *)PARAM_FLASH_ADDR, &param, sizeof(Param_Data)) == 0 ? PARAM_SAVE_OK : PARAM_SAVE_FAIL;
+}
+
+
+/**
+ * @brief 请求保存参数（任意上下文可调用，由主循环任务执行写入）
+ */
+void Param_Request_Save(void)
+{
+    param_save_request = 1;
+}
+
+
+/**
+ * @brief 处理保存请求（主循环参数任务中调用）
+ *
+ * 输出：param,save,<1成功/0失败/2电机运行中，未写入>\n
+ */
+void Param_Poll(void)
+{
+    if (!param_save_request)
+        return;
+    param_save_request = 0;
+
+    printf("param,save,%d\n", Param_Save());
+}
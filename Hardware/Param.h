@@ -0,0 +1,84 @@
+#ifndef __PARAM_H
+#define __PARAM_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 参数存储模块接口说明
+ *
+ * 运行参数集中存放于全局结构体 param，保存在 Flash 最后一页
+ * （0x0800FC00，1KB）。上电调用 Param_Load()，校验失败时装入默认值。
+ *
+ * - Param_Load()     从Flash读取参数，返回1表示有效，0表示已恢复默认
+ * - Param_Save()     擦除并写入Flash（约20ms，期间CPU停顿，需在主循环中调用；
+ *                    电机有输出时拒绝写入）
+ * - Param_Default()  装入默认参数（不写Flash）
+ * - Param_Request_Save()  请求保存（可在中断中调用）
+ * - Param_Poll()     处理保存请求（主循环参数任务中调用）
+ *
+ * 新增字段时须同步递增 PARAM_VERSION，旧数据将被丢弃并恢复默认。
+ * ========================================================== */
+
+#define PARAM_FLASH_ADDR    0x0800FC00
+#define PARAM_MAGIC         0x50415241      // "PARA"
+#define PARAM_VERSION       2
+
+// Param_Save 返回值
+#define PARAM_SAVE_FAIL     0       // 擦除/编程/校验失败
+#define PARAM_SAVE_OK       1
+#define PARAM_SAVE_BUSY     2       // 电机正在驱动，未写入
+
+// 摩擦前馈模型（每个电机、每个方向一组）
+// u_ff = coulomb + viscous * |v|，Q8定点，u单位与 Motor_Set_Speed 相同
+typedef struct
+{
+    int16_t breakaway;      // 起动（静摩擦）指令值，未标定为0
+    int16_t reserved;
+    int32_t coulomb_q8;     // 库仑摩擦补偿（Q8）
+    int32_t viscous_q8;     // 粘滞摩擦系数：每单位速度所需指令（Q8）
+} Friction_Dir;
+
+typedef struct
+{
+    Friction_Dir dir[2];    // [0] 正转，[1] 反转
+} Friction_Model;
+
+// 速度环增益调度表：按速度断点线性插值，增益为Q16定点
+#define GAIN_SCHED_POINTS   6
+
+typedef struct
+{
+    int16_t speed;          // 速度断点（取绝对值比较）
+    int16_t reserved;
+    int32_t kp_q16;
+    int32_t ki_q16;
+    int32_t kd_q16;
+} Gain_Point;
+
+typedef struct
+{
+    uint8_t count;          // 有效断点数，按速度升序排列
+    uint8_t enabled;        // 上电是否启用调度
+    uint16_t reserved;
+    Gain_Point point[GAIN_SCHED_POINTS];
+} Gain_Table;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    Friction_Model friction[2];     // 电机1、电机2摩擦模型
+    Gain_Table gain_sched;          // 电机1速度环增益调度表
+    uint32_t checksum;              // 必须为最后一个字段
+} Param_Data;
+
+extern Param_Data param;
+
+uint8_t Param_Load(void);
+uint8_t Param_Save(void);
+void Param_Default(void);
+void Param_Request_Save(void);
+void Param_Poll(void);
+
+#endif
@@ -0,0 +1,170 @@
+#include "stm32f10x.h"
+#include "Profiler.h"
+#include "Serial.h"
+#include <stdio.h>
+
+/* ==========================================================
+ * PC采样性能分析模块（Profiler.c）
+ *
+ * 采样时钟复用控制时基 TIM1（1MHz计数，100us周期）的比较通道1：
+ * 每次中断后把比较值换成 0~99 内的伪随机数，使采样时刻相对控制
+ * 中断随机分布，避免与周期性任务同步而产生偏差。采样率10kHz，
+ * 每次约40个周期。
+ *
+ * 中断入口用汇编按 EXC_RETURN 选择 MSP/PSP，取异常栈帧第7个字
+ * （压栈的PC）。PC 不在统计范围内的样本单独计数。
+ *
+ * 桶为16位以节省RAM，最热的桶约6.5秒即满（10kHz全落一桶时）。
+ * 满后若继续采样，该桶不再增加而总样本数仍在增加，占比会被
+ * 低估，因此任一桶满即停止采样，导出时标记。
+ * ========================================================== */
+
+#define PROF_DEFAULT_BASE   0x08000000
+#define PROF_DEFAULT_SHIFT  7
+
+static uint16_t prof_hist[PROF_BUCKETS];
+static uint32_t prof_base = PROF_DEFAULT_BASE;
+static uint8_t prof_shift = PROF_DEFAULT_SHIFT;
+static uint32_t prof_total = 0;             // 总样本数
+static uint32_t prof_other = 0;             // 超出统计范围的样本数
+static uint32_t prof_seed = 0x12345678;     // xorshift32 状态
+static volatile uint8_t prof_full = 0;      // 有桶已满，采样已停止
+static volatile uint8_t prof_dump = 0;
+
+void Profiler_Sample(uint32_t *frame);
+
+
+/**
+ * @brief 开始采样
+ * @param base  统计起始地址，0为Flash起始
+ * @param shift 桶宽度为 2^shift 字节，0为默认128字节
+ */
+void Profiler_Start(uint32_t base, uint8_t shift)
+{
+    Profiler_Stop();
+
+    for (uint16_t i = 0; i < PROF_BUCKETS; i++)
+    {
+        prof_hist[i] = 0;
+    }
+    prof_total = 0;
+    prof_other = 0;
+    prof_full = 0;
+    prof_base = base ? base : PROF_DEFAULT_BASE;
+    prof_shift = shift ? shift : PROF_DEFAULT_SHIFT;
+
+    // 比较通道1仅用于产生中断，不输出
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;
+    TIM_OCInitStructure.TIM_Pulse = 50;
+    TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+
+    NVIC_InitTypeDef NVIC_InitStruct;
+    NVIC_InitStruct.NVIC_IRQChannel = TIM1_CC_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 0;    // 最高抢占优先级，可采样其他中断
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
+    NVIC_Init(&NVIC_InitStruct);
+
+    TIM_ClearITPendingBit(TIM1, TIM_IT_CC1);
+    TIM_ITConfig(TIM1, TIM_IT_CC1, ENABLE);
+}
+
+
+void Profiler_Stop(void)
+{
+    TIM_ITConfig(TIM1, TIM_IT_CC1, DISABLE);
+}
+
+
+/**
+ * @brief 记录一个样本（由 TIM1_CC_IRQHandler 跳转而来）
+ * @param frame 被打断上下文的异常栈帧：r0,r1,r2,r3,r12,lr,pc,xpsr
+ */
+void Profiler_Sample(uint32_t *frame)
+{
+    TIM1->SR = (uint16_t)~TIM_IT_CC1;
+
+    uint32_t offset = (frame[6] - prof_base) >> prof_shift;
+    if (offset < PROF_BUCKETS)
+    {
+        if (++prof_hist[offset] == 0xFFFF)
+        {
+            // 本样本仍计入，之后不再中断（同 TIM_ITConfig 的写法，本中断内无需关中断）
+            TIM1->DIER &= (uint16_t)~TIM_IT_CC1;
+            prof_full = 1;
+        }
+    }
+    else
+    {
+        prof_other++;
+    }
+    prof_total++;
+
+    // 下一次比较值：xorshift32 取高16位缩放到计数周期内
+    prof_seed ^= prof_seed << 13;
+    prof_seed ^= prof_seed >> 17;
+    prof_seed ^= prof_seed << 5;
+    TIM1->CCR1 = (uint16_t)(((prof_seed >> 16) * (TIM1->ARR + 1)) >> 16);
+}
+
+
+#if defined(__CC_ARM)
+/**
+ * @brief TIM1比较中断入口：取被打断上下文的栈帧地址后尾调用 Profiler_Sample
+ */
+__asm void TIM1_CC_IRQHandler(void)
+{
+    IMPORT  Profiler_Sample
+    TST     LR, #4              ; EXC_RETURN 第2位：0=MSP，1=PSP
+    ITE     EQ
+    MRSEQ   R0, MSP
+    MRSNE   R0, PSP
+    B       Profiler_Sample     ; LR 仍为 EXC_RETURN，由 Profiler_Sample 返回时完成异常返回
+}
+#else
+void __attribute__((naked)) TIM1_CC_IRQHandler(void)
+{
+    __asm volatile(
+        "tst   lr, #4          \n"
+        "ite   eq              \n"
+        "mrseq r0, msp         \n"
+        "mrsne r0, psp         \n"
+        "b     Profiler_Sample \n");
+}
+#endif
+
+
+void Profiler_Request_Dump(void)
+{
+    prof_dump = 1;
+}
+
+
+/**
+ * @brief 导出直方图（主循环任务中调用，导出期间暂停遥测）
+ *
+ * 格式：prof,<基址>,<桶宽位数>,<桶数>,<总样本>,<范围外样本>,<桶满已停止>\n
+ *       p,<桶号>,<样本数>\n（仅非零桶）
+ *       prof,end\n
+ */
+void Profiler_PollDump(void)
+{
+    if (!prof_dump)
+        return;
+    prof_dump = 0;
+
+    Serial_Telemetry_Enable(0);
+    printf("prof,0x%08lX,%u,%u,%lu,%lu,%u\n", (unsigned long)prof_base, prof_shift, PROF_BUCKETS,
+           (unsigned long)prof_total, (unsigned long)prof_other, prof_full);
+    for (uint16_t i = 0; i < PROF_BUCKETS; i++)
+    {
+        if (prof_hist[i])
+        {
+            printf("p,%u,%u\n", i, prof_hist[i]);
+        }
+    }
+    printf("prof,end\n");
+    Serial_Telemetry_Enable(1);
+}
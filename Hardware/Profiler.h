@@ -0,0 +1,30 @@
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * PC采样性能分析模块接口说明
+ *
+ * TIM1 比较通道1以随机相位中断（最高抢占优先级），读取被打断上下文
+ * 压栈的PC，按地址落入直方图桶。导出数据由上位机工具
+ * Tools/prof_map.c 结合链接器 map 文件换算为函数热点。
+ *
+ * - Profiler_Start(base, shift)   清零并开始采样，桶 = (PC - base) >> shift
+ *                                 base 为0时取 0x08000000，shift 为0时取7（128字节/桶）
+ *                                 任一桶满（65535）时自动停止，各桶与总样本数保持一致
+ * - Profiler_Stop()               停止采样
+ * - Profiler_Request_Dump()       请求主循环导出直方图
+ * - Profiler_PollDump()           有导出请求时输出（主循环任务中调用）
+ *
+ * 与本中断同为抢占优先级0的中断（QEnc的EXTI、TIM2）无法被采样。
+ * ========================================================== */
+
+#define PROF_BUCKETS        512
+
+void Profiler_Start(uint32_t base, uint8_t shift);
+void Profiler_Stop(void);
+void Profiler_Request_Dump(void);
+void Profiler_PollDump(void);
+
+#endif
@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include "Pvt.h"
+
+/* ==========================================================
+ * PVT 轨迹点队列（Pvt.c）
+ *
+ * 队列为单生产者（串口接收中断）单消费者（控制中断）环形缓冲，
+ * 写入方只改 pvt_head，控制中断只改 pvt_tail，无需关中断。
+ * 停止命令可能来自主循环或串口中断，只记录停止时的写入位置，
+ * 由下一次 Pvt_Tick 丢弃此前的点，停止之后写入的点保留。
+ *
+ * 每段按三次 Hermite 曲线插值，t 归一化为 u∈[0,1]（Q16）：
+ *   p(u) = p0 + a1·u + a2·u² + a3·u³
+ *   a1 = m0，a2 = 3d - 2m0 - m1，a3 = -2d + m0 + m1
+ *   d = p1 - p0，m = 速度 × 段时长（两端切线，单位脉冲）
+ * 系数在段开始时算一次，每1ms只做 Horner 求值（三次 64 位乘法）。
+ * 位置范围与段长的限制保证系数不超出 int32。
+ *
+ * 速度目标为整数，位置增益默认 8/256，误差不足 32 脉冲时比例项取整为0，
+ * 保持终点时会停在几十脉冲之外。目标先按 Q8 合成，加上上周期的余数
+ * 再取整，余数留到下周期，整数目标的平均值等于 Q8 值，保持时误差
+ * 按比例收敛到零附近。
+ * ========================================================== */
+
+// 速度单位换算：Encoder_Get_Speed 为每ms脉冲数×1.85，1脉冲/s = 0.00185，Q20
+#define PVT_SPEED_Q20       1940
+
+typedef struct
+{
+    uint16_t dt;
+    int32_t pos;
+    int32_t vel;
+} Pvt_Point;
+
+static Pvt_Point pvt_queue[PVT_QUEUE_SIZE];
+static volatile uint8_t pvt_head = 0;       // 写入位置（仅 Pvt_Push 修改）
+static volatile uint8_t pvt_tail = 0;       // 读取位置（仅 Pvt_Tick 修改）
+static volatile uint8_t pvt_stop_req = 0;
+static volatile uint8_t pvt_stop_at = 0;    // 停止时的写入位置
+static volatile uint8_t pvt_go = 0;
+
+static uint8_t pvt_state = PVT_IDLE;
+static uint16_t pvt_kp_q8 = PVT_KP_Q8;
+static int32_t pvt_origin = 0;              // 轨迹起点（编码器位置）
+static int32_t pvt_end_pos = 0;             // 当前段终点（相对起点）
+static int32_t pvt_end_vel = 0;
+static int32_t pvt_frac = 0;                // 速度目标取整余数（Q8）
+
+// 当前段
+static int32_t seg_p0, seg_a1, seg_a2, seg_a3;
+static uint16_t seg_dt = 1;
+static uint16_t seg_t = 0;
+
+// 统计与事件（控制中断写，主循环读后清零）
+static uint32_t pvt_segments = 0;
+static uint32_t pvt_underruns = 0;
+static int32_t pvt_max_error = 0;
+static uint8_t pvt_low = 0;                 // 已报告低水位，队列回升后重新报告
+static volatile uint8_t pvt_low_event = 0;
+static volatile uint8_t pvt_underrun_event = 0;
+static volatile uint8_t pvt_report = 0;
+
+
+static uint8_t Pvt_Queued(void)
+{
+    return (pvt_head - pvt_tail) & (PVT_QUEUE_SIZE - 1);
+}
+
+
+/**
+ * @brief 从当前段终点到 (p1, v1) 计算新段的插值系数
+ */
+static void Pvt_Load(uint16_t dt, int32_t p1, int32_t v1)
+{
+    int32_t d = p1 - pvt_end_pos;
+    int32_t m0 = (int32_t)((int64_t)pvt_end_vel * dt / 1000);
+    int32_t m1 = (int32_t)((int64_t)v1 * dt / 1000);
+
+    seg_p0 = pvt_end_pos;
+    seg_a1 = m0;
+    seg_a2 = 3 * d - 2 * m0 - m1;
+    seg_a3 = -2 * d + m0 + m1;
+    seg_dt = dt;
+    seg_t = 0;
+    pvt_end_pos = p1;
+    pvt_end_vel = v1;
+}
+
+
+/**
+ * @brief 取出队首的点作为下一段
+ */
+static void Pvt_Next(void)
+{
+    const Pvt_Point *pt = &pvt_queue[pvt_tail];
+    Pvt_Load(pt->dt, pt->pos, pt->vel);
+    pvt_tail = (pvt_tail + 1) & (PVT_QUEUE_SIZE - 1);
+    pvt_segments++;
+}
+
+
+/**
+ * @brief 空闲或保持时是否可以开始：开始命令、队列满或时长达到预填充
+ */
+static uint8_t Pvt_Ready(void)
+{
+    uint8_t n = Pvt_Queued();
+    uint32_t total = 0;
+
+    if (n == 0)
+        return 0;
+    if (pvt_go || n == PVT_QUEUE_SIZE - 1)
+        return 1;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        total += pvt_queue[(pvt_tail + i) & (PVT_QUEUE_SIZE - 1)].dt;
+    }
+    return total >= PVT_PREFILL_MS;
+}
+
+
+/**
+ * @brief 写入一个轨迹点（串口接收中断中调用）
+ * @return 1：已写入；0：队列已满
+ *
+ * 参数范围由调用方检查（dt 1~PVT_MAX_DT，位置 ±PVT_POS_MAX，速度 ±PVT_VEL_MAX）。
+ */
+uint8_t Pvt_Push(uint16_t dt, int32_t pos, int32_t vel)
+{
+    uint8_t next = (pvt_head + 1) & (PVT_QUEUE_SIZE - 1);
+    if (next == pvt_tail)
+        return 0;
+
+    pvt_queue[pvt_head].dt = dt;
+    pvt_queue[pvt_head].pos = pos;
+    pvt_queue[pvt_head].vel = vel;
+    pvt_head = next;
+    return 1;
+}
+
+
+void Pvt_Start(void)
+{
+    pvt_go = 1;
+}
+
+
+void Pvt_Stop(void)
+{
+    pvt_stop_at = pvt_head;
+    pvt_stop_req = 1;
+}
+
+
+void Pvt_Set_Gain(uint16_t kp_q8)
+{
+    pvt_kp_q8 = kp_q8;
+}
+
+
+/**
+ * @brief 推进轨迹并计算速度目标（速度环中每1ms调用）
+ * @param pos 电机1当前位置（编码器累计脉冲）
+ * @param speed_ref 输出速度目标（Encoder_Get_Speed 的单位）
+ * @return 1：轨迹运行或保持中，使用 *speed_ref；0：空闲
+ */
+uint8_t Pvt_Tick(int32_t pos, int16_t *speed_ref)
+{
+    int32_t p, v = 0;
+
+    if (pvt_stop_req)
+    {
+        pvt_tail = pvt_stop_at;
+        pvt_stop_req = 0;
+        pvt_go = 0;
+        pvt_state = PVT_IDLE;
+    }
+
+    if (pvt_state == PVT_IDLE || pvt_state == PVT_HOLD)
+    {
+        if (Pvt_Ready())
+        {
+            // 从空闲开始时以当前位置为起点；保持中则从保持点接着运行
+            if (pvt_state == PVT_IDLE)
+            {
+                pvt_origin = pos;
+                pvt_end_pos = 0;
+                pvt_max_error = 0;
+                pvt_frac = 0;
+            }
+            pvt_end_vel = 0;
+            pvt_go = 0;
+            Pvt_Next();
+            pvt_state = PVT_RUN;
+        }
+        else if (pvt_state == PVT_IDLE)
+        {
+            return 0;
+        }
+    }
+    else if (++seg_t >= seg_dt)
+    {
+        if (pvt_state == PVT_RUN && Pvt_Queued())
+        {
+            Pvt_Next();
+        }
+        else if (pvt_state == PVT_RUN && pvt_end_vel != 0)
+        {
+            // 欠载：从当前速度匀减速到0，位移为 v·T/2
+            Pvt_Load(PVT_STOP_MS, pvt_end_pos + (int32_t)((int64_t)pvt_end_vel * PVT_STOP_MS / 2000), 0);
+            pvt_state = PVT_STOPPING;
+            pvt_underruns++;
+            pvt_underrun_event = 1;
+        }
+        else
+        {
+            pvt_state = PVT_HOLD;
+        }
+    }
+
+    if (pvt_state == PVT_HOLD)
+    {
+        p = pvt_end_pos;
+    }
+    else
+    {
+        int64_t u = ((uint32_t)seg_t << 16) / seg_dt;
+        p = seg_p0 + (int32_t)(((((((int64_t)seg_a3 * u) >> 16) + seg_a2) * u >> 16) + seg_a1) * u >> 16);
+        int64_t dp = seg_a1 + (((2 * (int64_t)seg_a2 + ((3 * (int64_t)seg_a3 * u) >> 16)) * u) >> 16);
+        dp = dp * 1000 / seg_dt;                // 脉冲/s；短段大位移时超出32位，先限幅
+        v = dp > INT32_MAX ? INT32_MAX : dp < -INT32_MAX ? -INT32_MAX : (int32_t)dp;
+    }
+
+    // 速度前馈 + 位置误差比例修正（Q8），加余数取整
+    int32_t err = pvt_origin + p - pos;
+    if (err > pvt_max_error) pvt_max_error = err;
+    if (-err > pvt_max_error) pvt_max_error = -err;
+    int64_t ref_q8 = (((int64_t)v * PVT_SPEED_Q20 + (1L << 11)) >> 12) + (int64_t)err * pvt_kp_q8 + pvt_frac;
+    int64_t ref = (ref_q8 + 128) >> 8;
+    if (ref > INT16_MAX) ref = INT16_MAX;
+    if (ref < INT16_MIN) ref = INT16_MIN;
+    pvt_frac = (int32_t)(ref_q8 - (ref << 8));
+    if (pvt_frac > 128 || pvt_frac < -128)
+        pvt_frac = 0;                       // 限幅时不累积余数
+    *speed_ref = (int16_t)ref;
+
+    if (pvt_state == PVT_RUN && Pvt_Queued() < PVT_LOW_WATER)
+    {
+        if (!pvt_low)
+        {
+            pvt_low = 1;
+            pvt_low_event = 1;
+        }
+    }
+    else
+    {
+        pvt_low = 0;
+    }
+    return 1;
+}
+
+
+uint8_t Pvt_IsActive(void)
+{
+    return pvt_state != PVT_IDLE || Pvt_Queued() != 0;
+}
+
+
+uint8_t Pvt_Free(void)
+{
+    return (PVT_QUEUE_SIZE - 1) - Pvt_Queued();
+}
+
+
+void Pvt_Get_Stats(Pvt_Stats *stats)
+{
+    stats->state = pvt_state;
+    stats->queued = Pvt_Queued();
+    stats->segments = pvt_segments;
+    stats->underruns = pvt_underruns;
+    stats->max_error = pvt_max_error;
+}
+
+
+void Pvt_Request_Report(void)
+{
+    pvt_report = 1;
+}
+
+
+/**
+ * @brief 输出事件与报告（主循环中调用）
+ *
+ * 格式：pvt,low,<剩余空间>\n               运行中队列降到低水位以下
+ *       pvt,underrun,<次数>\n              欠载，已减速停止
+ *       pvt,<状态>,<点数>,<剩余空间>,<已执行点数>,<欠载次数>,<最大误差>,<增益Q8>\n
+ */
+void Pvt_PollReport(void)
+{
+    if (pvt_low_event)
+    {
+        pvt_low_event = 0;
+        printf("pvt,low,%u\n", Pvt_Free());
+    }
+    if (pvt_underrun_event)
+    {
+        pvt_underrun_event = 0;
+        printf("pvt,underrun,%lu\n", (unsigned long)pvt_underruns);
+    }
+    if (!pvt_report)
+        return;
+    pvt_report = 0;
+
+    Pvt_Stats s;
+    Pvt_Get_Stats(&s);
+    printf("pvt,%u,%u,%u,%lu,%lu,%ld,%u\n", s.state, s.queued, Pvt_Free(), (unsigned long)s.segments,
+           (unsigned long)s.underruns, (long)s.max_error, pvt_kp_q8);
+}
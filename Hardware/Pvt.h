@@ -0,0 +1,81 @@
+#ifndef __PVT_H
+#define __PVT_H
+
+#include <stdint.h>
+
+/* ==========================================================
+ * PVT 轨迹点队列接口说明（位置-速度-时间，三次 Hermite 插值）
+ *
+ * 上位机连续下发带时间间隔的轨迹点，下位机在速度环中每1ms按三次
+ * Hermite 插值得到位置与速度参考：速度作前馈，位置误差经比例增益修正，
+ * 合成电机1速度环的目标（Q8 合成后带余数取整，低速与保持时不丢小数）。轨迹时刻只由控制节拍决定，与串口到达时刻无关，
+ * 链路延迟抖动不会传到电机上，只要队列不空。
+ *
+ * 轨迹点：<dt>,<位置>,<速度>
+ *   dt    距上一点的时间（ms，1~PVT_MAX_DT），第一点为从起点出发的时间
+ *   位置  相对轨迹起点的脉冲数（起点为开始运行时电机1的位置）
+ *   速度  到达该点时的速度（脉冲/s）
+ *
+ * 运行：
+ *   - 队列中的点总时长达到 PVT_PREFILL_MS、队列已满或收到开始命令时
+ *     从静止开始运行
+ *   - 轨迹以速度0的点结束时停在该点并保持位置，之后下发的点在预填充后接着运行
+ *   - 欠载（当前段结束时队列为空且末速度不为0）：在 PVT_STOP_MS 内匀减速
+ *     停下并保持，欠载计数加一，主循环输出 pvt,underrun,<次数>
+ *   - 停止命令清空队列，回到普通速度控制
+ *
+ * 流量控制：队列满时 Pvt_Push 返回0，不写入；二进制通道据此回复
+ * NACK LINK_ERR_BUSY 且不推进序号（见 Link.h），ACK 负载带剩余空间，
+ * 上位机据此控制在途点数；运行中队列降到 PVT_LOW_WATER 以下时
+ * 输出一次 pvt,low,<剩余空间>。
+ *
+ * 只依赖 stdint/stdio，上位机测试（Tools/link_host.c）直接编译本文件。
+ *
+ * - Pvt_Push(dt, pos, vel)      写入一个点（串口接收中断中调用），队列满返回0
+ * - Pvt_Start()                 不等预填充立即开始
+ * - Pvt_Stop()                  停止并清空队列
+ * - Pvt_Set_Gain(kp)            位置误差增益（Q8，速度单位/脉冲）
+ * - Pvt_Tick(pos, speed_ref)    速度环中每1ms调用，运行中返回1并写出速度目标
+ * - Pvt_IsActive()              运行、保持中或队列非空
+ * - Pvt_Free()                  队列剩余空间
+ * - Pvt_Get_Stats(s)            读取状态与统计
+ * - Pvt_Request_Report()        命令 @pvt%?
+ * - Pvt_PollReport()            主循环中调用：输出报告与低水位/欠载事件
+ * ========================================================== */
+
+#define PVT_QUEUE_SIZE      16          // 必须为2的幂，可存 PVT_QUEUE_SIZE-1 个点
+#define PVT_MAX_DT          60000       // 单段最长时间（ms）
+#define PVT_POS_MAX         (1L << 24)  // 位置范围 ±PVT_POS_MAX（脉冲）
+#define PVT_VEL_MAX         1000000L    // 速度范围 ±PVT_VEL_MAX（脉冲/s）
+#define PVT_PREFILL_MS      50          // 自动开始所需的队列时长
+#define PVT_LOW_WATER       4           // 低水位（点数）
+#define PVT_STOP_MS         100         // 欠载时的减速时间
+#define PVT_KP_Q8           8           // 默认位置增益
+
+// 状态
+#define PVT_IDLE            0           // 未运行，速度环跟随 @speed% 目标
+#define PVT_RUN             1           // 按队列插值
+#define PVT_STOPPING        2           // 欠载减速
+#define PVT_HOLD            3           // 停在最后一点，保持位置
+
+typedef struct
+{
+    uint8_t state;
+    uint8_t queued;         // 队列中的点数
+    uint32_t segments;      // 已开始执行的点数
+    uint32_t underruns;
+    int32_t max_error;      // 本次运行的最大跟踪误差（脉冲）
+} Pvt_Stats;
+
+uint8_t Pvt_Push(uint16_t dt, int32_t pos, int32_t vel);
+void Pvt_Start(void);
+void Pvt_Stop(void);
+void Pvt_Set_Gain(uint16_t kp_q8);
+uint8_t Pvt_Tick(int32_t pos, int16_t *speed_ref);
+uint8_t Pvt_IsActive(void);
+uint8_t Pvt_Free(void);
+void Pvt_Get_Stats(Pvt_Stats *stats);
+void Pvt_Request_Report(void);
+void Pvt_PollReport(void);
+
+#endif
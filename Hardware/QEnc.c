@@ -0,0 +1,286 @@
+#include "stm32f10x.h"
+#include "QEnc.h"
+#include "Delay.h"
+#include "CpuLoad.h"
+
+/* ==========================================================
+ * 软件正交解码模块（QEnc.c）
+ * 功能：
+ *  - 以 EXTI 双边沿中断跟踪 A/B 相电平
+ *  - 以 (上次AB<<2 | 本次AB) 为索引查表得到 -1/0/+1，实现4倍频计数
+ *  - A/B 同时跳变视为非法（中间沿丢失），计入错误计数
+ *
+ * 中断内只读一次 GPIOB->IDR 并直接写 EXTI->PR，避免库函数开销。
+ * ========================================================== */
+
+typedef struct
+{
+    volatile int32_t count;         // 累计计数
+    volatile uint32_t errors;       // 非法跳变次数
+    volatile uint32_t min_interval; // 相邻边沿最小间隔（周期数）
+    volatile uint32_t last_edge;    // 上次边沿时刻（DWT_CYCCNT）
+    int32_t prev_count;             // 上次读取速度时的计数
+    uint8_t state;                  // 上次AB电平
+    uint8_t shift;                  // A相在IDR中的位号（B相为shift+1）
+} QEnc_Axis;
+
+static QEnc_Axis qenc_axis[2];
+
+#if QENC_PROFILE
+static volatile uint32_t qenc_max_isr_cycles = 0;
+#endif
+
+// 状态转移表：索引 = 上次AB<<2 | 本次AB，A为低位
+// 正转序列 00→01→11→10→00 计 +1，反向计 -1，不变或非法计 0
+static const int8_t qenc_table[16] =
+{
+     0, +1, -1,  0,
+    -1,  0,  0, +1,
+    +1,  0,  0, -1,
+     0, -1, +1,  0
+};
+
+// 非法跳变（A、B同时变化）对应的索引：3、6、9、12
+#define QENC_ILLEGAL_MASK   ((1u << 3) | (1u << 6) | (1u << 9) | (1u << 12))
+
+
+/**
+ * @brief 单个轴的边沿处理（由各 EXTI 中断调用）
+ * @param axis 轴状态
+ * 
+ * 内联展开于中断函数中，执行路径无分支跳转到库函数。
+ */
+static __INLINE void QEnc_Edge(QEnc_Axis *axis)
+{
+    uint32_t now = DWT_CYCCNT;
+    uint8_t ab = (GPIOB->IDR >> axis->shift) & 0x03;
+    uint8_t index = (axis->state << 2) | ab;
+
+    axis->count += qenc_table[index];
+    axis->state = ab;
+
+    if (QENC_ILLEGAL_MASK & (1u << index))
+    {
+        axis->errors++;
+    }
+
+    // 记录最小边沿间隔，用于换算最大边沿频率
+    uint32_t interval = now - axis->last_edge;
+    if (interval < axis->min_interval)
+    {
+        axis->min_interval = interval;
+    }
+    axis->last_edge = now;
+}
+
+
+/**
+ * @brief 初始化软件正交解码（轴3：PB0/PB1，轴4：PB10/PB11）
+ * 
+ * - 引脚上拉输入，EXTI 上升沿与下降沿均触发
+ * - 抢占优先级0：高于串口(1)与控制定时器(2)，保证不漏沿
+ */
+void QEnc_Init(void)
+{
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
+
+    GPIO_InitTypeDef GPIO_InitStructure;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IPU;           // 上拉输入
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0 | GPIO_Pin_1 | GPIO_Pin_10 | GPIO_Pin_11;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource0);
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource1);
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource10);
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource11);
+
+    // 以当前电平作为初始状态，避免上电第一个沿误计数
+    qenc_axis[0].shift = 0;
+    qenc_axis[1].shift = 10;
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        qenc_axis[i].state = (GPIOB->IDR >> qenc_axis[i].shift) & 0x03;
+        qenc_axis[i].count = 0;
+        qenc_axis[i].prev_count = 0;
+        qenc_axis[i].errors = 0;
+        qenc_axis[i].min_interval = 0xFFFFFFFF;
+        qenc_axis[i].last_edge = DWT_CYCCNT;
+    }
+
+    EXTI_InitTypeDef EXTI_InitStructure;
+    EXTI_InitStructure.EXTI_Line = EXTI_Line0 | EXTI_Line1 | EXTI_Line10 | EXTI_Line11;
+    EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising_Falling;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&EXTI_InitStructure);
+
+    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+
+    NVIC_InitStructure.NVIC_IRQChannel = EXTI0_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = EXTI1_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = EXTI15_10_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+
+/**
+ * @brief 边沿中断出口：耗时统计与CPU负载记账
+ * @param start 中断入口时刻（DWT_CYCCNT）
+ * 
+ * 边沿中断处于最高抢占级，不使用 CPULOAD_ENTER/EXIT（每次关中断打点），
+ * 改为出口一次累加，见 CpuLoad_Charge_Exti。
+ */
+static __INLINE void QEnc_Isr_Exit(uint32_t start)
+{
+    uint32_t cycles = DWT_CYCCNT - start;
+#if QENC_PROFILE
+    if (cycles > qenc_max_isr_cycles) qenc_max_isr_cycles = cycles;
+#endif
+    CPULOAD_CHARGE_EXTI(cycles);
+}
+
+
+/**
+ * @brief 轴3 A相（PB0）边沿中断
+ */
+void EXTI0_IRQHandler(void)
+{
+    uint32_t start = DWT_CYCCNT;
+    EXTI->PR = EXTI_Line0;          // 写1清除挂起位
+    QEnc_Edge(&qenc_axis[0]);
+    QEnc_Isr_Exit(start);
+}
+
+
+/**
+ * @brief 轴3 B相（PB1）边沿中断
+ */
+void EXTI1_IRQHandler(void)
+{
+    uint32_t start = DWT_CYCCNT;
+    EXTI->PR = EXTI_Line1;
+    QEnc_Edge(&qenc_axis[0]);
+    QEnc_Isr_Exit(start);
+}
+
+
+/**
+ * @brief 轴4 A/B相（PB10/PB11）边沿中断
+ * 
+ * 两线共用一个中断入口，一次清除两条线的挂起位后统一解码，
+ * 若A、B几乎同时跳变，也只会按最终电平处理一次。
+ */
+void EXTI15_10_IRQHandler(void)
+{
+    uint32_t start = DWT_CYCCNT;
+    EXTI->PR = EXTI_Line10 | EXTI_Line11;
+    QEnc_Edge(&qenc_axis[1]);
+    QEnc_Isr_Exit(start);
+}
+
+
+/**
+ * @brief 获取累计计数
+ * @param num 轴编号（3或4）
+ * @return 从清零以来的累计计数（4倍频）
+ */
+int32_t QEnc_Get_Count(uint8_t num)
+{
+    return (num == 3) ? qenc_axis[0].count : qenc_axis[1].count;
+}
+
+
+/**
+ * @brief 获取计数变化量（用于速度计算）
+ * @param num 轴编号（3或4）
+ * @return 自上次调用以来的计数变化
+ */
+int16_t QEnc_Get_Delta(uint8_t num)
+{
+    QEnc_Axis *axis = (num == 3) ? &qenc_axis[0] : &qenc_axis[1];
+    int32_t current_count = axis->count;   // 32位读取为原子操作
+    int16_t delta = (int16_t)(current_count - axis->prev_count);
+
+    axis->prev_count = current_count;
+    return delta;
+}
+
+
+/**
+ * @brief 清零累计计数
+ * @param num 轴编号（3或4）
+ */
+void QEnc_Clear_Count(uint8_t num)
+{
+    QEnc_Axis *axis = (num == 3) ? &qenc_axis[0] : &qenc_axis[1];
+
+    __disable_irq();
+    axis->count = 0;
+    axis->prev_count = 0;
+    __enable_irq();
+}
+
+
+/**
+ * @brief 获取非法跳变次数
+ * @param num 轴编号（3或4）
+ * @return A/B同时变化的次数，非零说明边沿频率超出中断处理能力或存在干扰
+ */
+uint32_t QEnc_Get_ErrorCount(uint8_t num)
+{
+    return (num == 3) ? qenc_axis[0].errors : qenc_axis[1].errors;
+}
+
+
+/**
+ * @brief 获取实测最大边沿频率
+ * @param num 轴编号（3或4）
+ * @return 边沿/秒，由运行以来最小边沿间隔换算；尚无边沿时返回0
+ */
+uint32_t QEnc_Get_MaxEdgeRate(uint8_t num)
+{
+    uint32_t interval = (num == 3) ? qenc_axis[0].min_interval : qenc_axis[1].min_interval;
+
+    if (interval == 0xFFFFFFFF)
+        return 0;
+    if (interval == 0)
+        interval = 1;
+    return SystemCoreClock / interval;
+}
+
+
+/**
+ * @brief 获取单次边沿中断的最大执行周期数
+ * @return 周期数（72MHz下 72周期 = 1us）；未开启QENC_PROFILE时返回0
+ */
+uint32_t QEnc_Get_MaxIsrCycles(void)
+{
+#if QENC_PROFILE
+    return qenc_max_isr_cycles;
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * @brief 清零最大边沿频率与中断耗时统计
+ * 
+ * 非法跳变次数单调累计，不在此清零（与串口错误计数一致）。
+ * 各字段为32位单次写入，无需关中断。
+ */
+void QEnc_Reset_Stats(void)
+{
+    qenc_axis[0].min_interval = 0xFFFFFFFF;
+    qenc_axis[1].min_interval = 0xFFFFFFFF;
+#if QENC_PROFILE
+    qenc_max_isr_cycles = 0;
+#endif
+}
@@ -0,0 +1,40 @@
+#ifndef __QENC_H
+#define __QENC_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 软件正交解码模块接口说明（EXTI 查表 4 倍频）
+ *
+ * TIM3/TIM4 已被 Encoder_Init 占用，附加轴由 EXTI 双边沿中断解码：
+ *  - 轴3：PB0(A) / PB1(B)   → EXTI0 / EXTI1
+ *  - 轴4：PB10(A) / PB11(B) → EXTI15_10
+ *
+ * - QEnc_Init()                  初始化引脚、EXTI 与 NVIC
+ * - QEnc_Get_Count(num)          获取累计计数（num = 3 或 4）
+ * - QEnc_Get_Delta(num)          获取自上次调用以来的计数变化量
+ * - QEnc_Clear_Count(num)        清零累计计数
+ * - QEnc_Get_ErrorCount(num)     非法跳变（A/B同时变化）次数，>0 说明丢沿
+ * - QEnc_Get_MaxEdgeRate(num)    实测最大边沿频率（边沿/秒）
+ * - QEnc_Get_MaxIsrCycles()      单次边沿中断最大耗时（周期数，需QENC_PROFILE）
+ * - QEnc_Reset_Stats()           清零最大边沿频率与中断耗时（非法跳变次数不清零）
+ *
+ * 以上统计由 @sched%? 查询输出（sched,qenc 行），@sched%r 一并清零。
+ *
+ * 上层通过 Encoder_Get_Speed / Encoder_Get_Position /
+ * Encoder_Clear_TotalCount 以编号 3、4 访问，与硬件编码器接口一致。
+ * ========================================================== */
+
+// 置1后在中断内统计执行周期数（约增加6个周期/边沿）
+#define QENC_PROFILE    1
+
+void QEnc_Init(void);
+int32_t QEnc_Get_Count(uint8_t num);
+int16_t QEnc_Get_Delta(uint8_t num);
+void QEnc_Clear_Count(uint8_t num);
+uint32_t QEnc_Get_ErrorCount(uint8_t num);
+uint32_t QEnc_Get_MaxEdgeRate(uint8_t num);
+uint32_t QEnc_Get_MaxIsrCycles(void);
+void QEnc_Reset_Stats(void);
+
+#endif
@@ -1,10 +1,63 @@
 #include "stm32f10x.h"
 #include <stdio.h>
-#include <string.h>
 #include <stdlib.h>
 #include "PID.h"
+#include "Friction.h"
+#include "Autotune.h"
+#include "SysId.h"
+#include "Adaptive.h"
+#include "GainSched.h"
+#include "Observer.h"
+#include "Timer.h"
+#include "Serial.h"
+#include "Sched.h"
+#include "CpuLoad.h"
+#include "Profiler.h"
+#include "MemInfo.h"
+#include "Fmt.h"
+#include "Baud.h"
+#include "Telemetry.h"
+#include "Measure.h"
+#include "Link.h"
+#include "Pvt.h"
+#include "Gear.h"
+#include "Sync.h"
+#include "Drive.h"
+#include <string.h>
 
 extern int16_t target_speed;   // 目标速度（外部变量）
+extern uint8_t current_mode;   // 当前控制模式
+
+static volatile uint8_t telemetry_enabled = 1;  // 周期遥测开关
+static volatile uint8_t telemetry_hold = 0;     // 波特率协商期间暂停遥测（与报告暂停相互独立）
+static volatile uint32_t rx_error_total = 0;    // 累计接收错误，单调递增，不随统计清零（供 Baud 使用）
+
+// 发送环形缓冲：printf 只写缓冲，由DMA1通道4成段发出，每段完成一次中断，
+// 控制中断中的遥测不再等待串口移位，高波特率下也不会逐字节中断
+#define SERIAL_TX_SIZE      256     // 必须为2的幂
+static volatile uint8_t tx_buffer[SERIAL_TX_SIZE];
+static volatile uint16_t tx_head = 0;   // 写入位置（仅写入方修改）
+static volatile uint16_t tx_tail = 0;   // 发送位置（仅DMA完成中断修改）
+static volatile uint16_t tx_dma_len = 0;    // 正在发送的段长，0为DMA空闲
+
+// 接收环形缓冲：DMA1通道5循环写入，IDLE（一帧结束）、半满、全满时
+// 中断处理新到的字节，中断次数与命令长度无关
+#define SERIAL_RX_SIZE      256     // 必须为2的幂；2M波特率下半个缓冲约0.64ms，容得下较长的中断延迟
+#define SERIAL_RX_HALF      (SERIAL_RX_SIZE / 2)
+static uint8_t rx_ring[SERIAL_RX_SIZE];
+static uint16_t rx_read = 0;            // 已处理位置（仅接收处理修改）
+static uint8_t rx_flag_debt = 0;        // 已按写位置计入、HT/TC 标志尚未读到的半区边界数
+static Serial_RxStats rx_stats;
+
+// 命令拼接状态：一条命令可能跨越多次中断
+static char cmd_buffer[32];             // 命令接收缓冲
+static uint8_t cmd_index = 0;           // 缓冲写入位置
+static uint8_t receiving_cmd = 0;       // 是否正在接收命令
+
+static uint8_t Serial_Tx_Put(uint8_t ch);
+static void Serial_Tx_Kick(void);
+static void Serial_Tx_Write(const char *s, uint8_t len);
+static uint8_t Serial_Tx_Block(const uint8_t *data, uint8_t len);
 
 /* ==========================================================
  * 串口模块 Serial.c
@@ -17,13 +70,13 @@ extern int16_t target_speed;   // 目标速度（外部变量）
 
 
 /**
- * @brief 串口初始化函数（USART1, 115200bps）
+ * @brief 串口初始化函数（USART1, 默认115200bps）
  * 
  * 配置说明：
  *  - PA9  → TX（推挽复用输出）
  *  - PA10 → RX（上拉输入）
  *  - 无硬件流控，8位数据，1位停止，无校验
- *  - 开启接收中断（USART_IT_RXNE）
+ *  - 接收走DMA1通道5循环缓冲，开启空闲线与错误中断
  */
 void Serial_Init(void)
 {
@@ -45,7 +98,7 @@ void Serial_Init(void)
 
     // 串口参数配置
     USART_InitTypeDef USART_InitStructure;
-    USART_InitStructure.USART_BaudRate = 115200;
+    USART_InitStructure.USART_BaudRate = BAUD_DEFAULT;    // 运行中可经 @baud% 协商提高
     USART_InitStructure.USART_WordLength = USART_WordLength_8b;
     USART_InitStructure.USART_StopBits = USART_StopBits_1;
     USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -53,10 +106,42 @@ void Serial_Init(void)
     USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
     USART_Init(USART1, &USART_InitStructure);
 
-    // 开启接收中断
-    USART_ITConfig(USART1, USART_IT_RXNE, ENABLE);
+    // DMA1通道5（USART1_RX）：循环接收到 rx_ring，半满/全满中断
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_DeInit(DMA1_Channel5);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)rx_ring;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize = SERIAL_RX_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;     // 低于PWM抖动DMA（通道2）
+    DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel5, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel5, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    DMA_Cmd(DMA1_Channel5, ENABLE);
+    USART_DMACmd(USART1, USART_DMAReq_Rx, ENABLE);
+
+    // DMA1通道4（USART1_TX）：普通模式，每次发送缓冲中连续的一段
+    DMA_DeInit(DMA1_Channel4);
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)tx_buffer;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize = 1;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_Init(DMA1_Channel4, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel4, DMA_IT_TC, ENABLE);
+    USART_DMACmd(USART1, USART_DMAReq_Tx, ENABLE);
+
+    // 开启空闲线与错误中断（ORE/FE/NE），不再逐字节中断
+    USART_ITConfig(USART1, USART_IT_IDLE, ENABLE);
+    USART_ITConfig(USART1, USART_IT_ERR, ENABLE);
 
-    // NVIC 配置（中断优先级）
+    // NVIC 配置（中断优先级）：DMA通道5与USART1同一抢占级，接收处理不会重入
     NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
     NVIC_InitTypeDef NVIC_InitStructure;
     NVIC_InitStructure.NVIC_IRQChannel = USART1_IRQn;
@@ -64,99 +149,1145 @@ void Serial_Init(void)
     NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
     NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
     NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel5_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 1;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel4_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
 
     // 使能串口
     USART_Cmd(USART1, ENABLE);
 }
 
+/* 上位机命令表：前缀匹配后将 '%' 之后的参数串交给处理函数 */
+typedef struct
+{
+    const char *prefix;                 // 命令前缀（含 '@' 与 '%'）
+    uint8_t (*handler)(const char *arg);    // 处理函数（参数非空时调用），返回 FMT_OK 或错误码
+} Serial_Command;
+
+/**
+ * @brief 跳过参数分隔符 ',' 后解析下一个整数
+ * @return FMT_OK；缺少分隔符时 FMT_ERR_EMPTY；其余同 Fmt_Parse_Int
+ */
+static uint8_t Serial_Next_Int(const char **p, int32_t min, int32_t max, int32_t *value)
+{
+    if (**p != ',')
+        return FMT_ERR_EMPTY;
+    (*p)++;
+    return Fmt_Parse_Int(p, min, max, value);
+}
+
 /**
- * @brief USART1 中断处理函数
- * 
- * 功能：解析上位机发来的速度控制指令。
- * 支持命令格式：@speed%数值
- * 示例：
- *     @speed%100   → 设置目标速度为100
+ * @brief 解析一个浮点数并前移指针
+ * @return FMT_OK；没有数字时 FMT_ERR_EMPTY；非有限值时 FMT_ERR_RANGE
  */
-void USART1_IRQHandler(void)
+static uint8_t Serial_Parse_Float(const char **p, float *value)
+{
+    char *end;
+    double v = strtod(*p, &end);
+
+    if (end == *p)
+        return FMT_ERR_EMPTY;
+    if (v != v || v > 1e30 || v < -1e30)
+        return FMT_ERR_RANGE;
+    *p = end;
+    *value = (float)v;
+    return FMT_OK;
+}
+
+/**
+ * @brief 跳过参数分隔符 ',' 后解析下一个浮点数
+ */
+static uint8_t Serial_Next_Float(const char **p, float *value)
+{
+    if (**p != ',')
+        return FMT_ERR_EMPTY;
+    (*p)++;
+    return Serial_Parse_Float(p, value);
+}
+
+// @speed%<n>：设置目标速度（PVT 轨迹运行时不生效，停止轨迹后恢复）
+static uint8_t Cmd_Speed(const char *arg)
+{
+    int32_t speed;
+    uint8_t err = Fmt_Parse_Int(&arg, INT16_MIN, INT16_MAX, &speed);
+    if (err) return err;
+
+    target_speed = speed;      // 更新目标速度
+    Speed_PID_Reset();         // ★修改：保持快速响应逻辑
+    return FMT_OK;
+}
+
+// @calib%<电机>：启动摩擦标定（仅速度模式）
+static uint8_t Cmd_Calib(const char *arg)
+{
+    int32_t num;
+    uint8_t err = Fmt_Parse_Int(&arg, 1, 2, &num);
+    if (err) return err;
+
+    if (current_mode != 1 || Autotune_IsRunning() || SysId_IsRunning() || Pvt_IsActive() ||
+        !Friction_Calib_Start(num))
+        return FMT_ERR_RANGE;       // 非速度模式、其他状态机运行中或标定已在进行
+    return FMT_OK;
+}
+
+// @tune%<速度>[,<规则>[,<继电幅值>]]：速度环继电自整定（仅速度模式）
+static uint8_t Cmd_Tune(const char *arg)
+{
+    int32_t speed, rule = TUNE_RULE_ZN_PID, relay = 0;
+
+    uint8_t err = Fmt_Parse_Int(&arg, INT16_MIN, INT16_MAX, &speed);
+    if (!err && *arg == ',') err = Serial_Next_Int(&arg, TUNE_RULE_ZN_PID, TUNE_RULE_NO_OVERSHOOT, &rule);
+    if (!err && *arg == ',') err = Serial_Next_Int(&arg, 0, INT16_MAX, &relay);
+    if (err) return err;
+
+    if (current_mode != 1 || speed == 0 || Autotune_IsRunning() || Friction_Calib_IsRunning() ||
+        SysId_IsRunning() || Pvt_IsActive() || Adaptive_IsEnabled())
+        return FMT_ERR_RANGE;       // 非速度模式、工作点为0、其他状态机运行中或自适应接管增益
+
+    target_speed = speed;   // 整定完成后以工作点速度继续运行
+    Autotune_Start(speed, rule, relay);
+    return FMT_OK;
+}
+
+// @ident%<电机>,<偏置>,<幅值>[,<保持周期>]：PRBS系统辨识（仅速度模式）
+static uint8_t Cmd_Ident(const char *arg)
+{
+    int32_t num, offset, amp, hold = 5;
+
+    uint8_t err = Fmt_Parse_Int(&arg, 1, 2, &num);
+    if (!err) err = Serial_Next_Int(&arg, INT16_MIN, INT16_MAX, &offset);
+    if (!err) err = Serial_Next_Int(&arg, 0, INT16_MAX, &amp);
+    if (!err && *arg == ',') err = Serial_Next_Int(&arg, 1, 255, &hold);
+    if (err) return err;
+
+    if (current_mode != 1 || SysId_IsRunning() || Friction_Calib_IsRunning() || Autotune_IsRunning() ||
+        Pvt_IsActive())
+        return FMT_ERR_RANGE;       // 非速度模式或其他状态机运行中
+
+    SysId_Start(num, offset, amp, hold);
+    return FMT_OK;
+}
+
+// @pid%<Kp>,<Ki>,<Kd>：直接设置速度环增益（增量式系数）
+static uint8_t Cmd_Pid(const char *arg)
+{
+    float p, i, d;
+
+    uint8_t err = Serial_Parse_Float(&arg, &p);
+    if (!err) err = Serial_Next_Float(&arg, &i);
+    if (!err) err = Serial_Next_Float(&arg, &d);
+    if (err) return err;
+
+    Speed_PID_SetParams(p, i, d);
+    GainSched_Invalidate();     // 调度开启时以调度表为准
+    return FMT_OK;
+}
+
+// @sched%? 查询多速率调度统计（含串口接收与QEnc解码统计）；@sched%r 清零统计
+static uint8_t Cmd_Sched(const char *arg)
+{
+    if (*arg == 'r')
+    {
+        Timer_Reset_Stats();
+    }
+    Timer_Request_Report();
+    return FMT_OK;
+}
+
+// @task%? 查询主循环任务统计与负载
+static uint8_t Cmd_Task(const char *arg)
+{
+    Sched_Request_Report();
+    return FMT_OK;
+}
+
+// @cpu%? 查询各上下文CPU占用；@cpu%r 清零峰值
+static uint8_t Cmd_Cpu(const char *arg)
+{
+    if (*arg == 'r')
+    {
+        CpuLoad_Reset_Peak();
+    }
+    CpuLoad_Request_Report();
+    return FMT_OK;
+}
+
+// @mem%? 查询栈高水位、中断嵌套与各段大小
+static uint8_t Cmd_Mem(const char *arg)
+{
+    MemInfo_Request_Report();
+    return FMT_OK;
+}
+
+// @prof%s[,<起始地址hex>,<桶宽位数>] 开始PC采样；@prof%x 停止；@prof%d 导出直方图
+static uint8_t Cmd_Prof(const char *arg)
 {
-    // 静态变量：用于存储一条完整命令
-    static char cmd_buffer[32];       // 命令接收缓冲
-    static uint8_t cmd_index = 0;     // 缓冲写入位置
-    static uint8_t receiving_cmd = 0; // 是否正在接收命令
+    uint32_t base = 0;
+    int32_t shift = 0;
+    uint8_t err = FMT_OK;
 
-    // 检查中断标志
-    if (USART_GetITStatus(USART1, USART_IT_RXNE))
+    switch (*arg++)
     {
-        char received_char = USART_ReceiveData(USART1); // 读取接收到的字符
+        case 's':
+            if (*arg == ',')
+            {
+                arg++;
+                err = Fmt_Parse_Hex(&arg, &base);
+                if (!err) err = Serial_Next_Int(&arg, 0, 24, &shift);
+                if (err) return err;
+            }
+            Profiler_Start(base, shift);
+            break;
+        case 'x': Profiler_Stop();         break;
+        case 'd': Profiler_Request_Dump(); break;
+        default: break;
+    }
+    return err;
+}
+
+// @adapt%<开关>[,<闭环时间常数ms>[,<遗忘因子‰>]]：在线自适应速度环；@adapt%? 查询状态
+static uint8_t Cmd_Adapt(const char *arg)
+{
+    int32_t en, tcl = 0, lambda = 0;
+
+    if (*arg == '?')
+    {
+        Adaptive_Request_Report();
+        return FMT_OK;
+    }
+    uint8_t err = Fmt_Parse_Int(&arg, 0, 1, &en);
+    if (!err && *arg == ',') err = Serial_Next_Int(&arg, 0, UINT16_MAX, &tcl);
+    if (!err && *arg == ',') err = Serial_Next_Int(&arg, 0, 1000, &lambda);
+    if (err) return err;
+
+    Adaptive_Enable(en, tcl, lambda * 65536L / 1000);
+    Adaptive_Request_Report();
+    return FMT_OK;
+}
+
+// @gs%<序号>,<速度>,<Kp>,<Ki>,<Kd>：设置增益调度断点
+// @gs%e<0|1> 开关调度，@gs%c 清空，@gs%s 保存到Flash（电机有输出时拒绝，见 param,save 回复），@gs%? 查询
+static uint8_t Cmd_GainSched(const char *arg)
+{
+    int32_t value;
+    uint8_t err;
 
-        // 命令起始符检测
-        if (received_char == '@')
+    switch (*arg)
+    {
+        case 'e':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 0, 1, &value);
+            if (err) return err;
+            GainSched_Enable(value);
+            break;
+        case 'c': GainSched_Clear();        break;
+        case 's': GainSched_Request_Save(); return FMT_OK;
+        case '?':                           break;
+        default:
         {
-            receiving_cmd = 1;
-            cmd_index = 0;
-            cmd_buffer[cmd_index++] = received_char;
+            int32_t index, speed;
+            err = Fmt_Parse_Int(&arg, 0, UINT8_MAX, &index);
+            if (!err) err = Serial_Next_Int(&arg, INT16_MIN, INT16_MAX, &speed);
+            float p, i, d;
+            if (!err) err = Serial_Next_Float(&arg, &p);
+            if (!err) err = Serial_Next_Float(&arg, &i);
+            if (!err) err = Serial_Next_Float(&arg, &d);
+            if (err) return err;
+            if (!GainSched_Set_Point(index, speed, p, i, d)) return FMT_ERR_RANGE;
+            break;
+        }
+    }
+    GainSched_Request_Report();
+    return FMT_OK;
+}
+
+// @obs%<电机>,<θ‰>：按衰减记忆因子设置观测器增益
+// @obs%<电机>,<α>,<β>,<γ>：直接设置增益；@obs%f<0|1> 速度环改用估计速度；@obs%? 查询
+static uint8_t Cmd_Observer(const char *arg)
+{
+    int32_t value;
+    uint8_t err;
+
+    if (*arg == 'f')
+    {
+        arg++;
+        err = Fmt_Parse_Int(&arg, 0, 1, &value);
+        if (err) return err;
+        Observer_Use_Feedback(value);
+    }
+    else if (*arg != '?')
+    {
+        err = Fmt_Parse_Int(&arg, 1, 2, &value);
+        if (err) return err;
+        float first, beta, gamma;
+        err = Serial_Next_Float(&arg, &first);
+        if (err) return err;
+        if (*arg != ',')
+        {
+            if (first < 0 || first >= 1000) return FMT_ERR_RANGE;
+            Observer_Set_Theta(value, (int32_t)(first * 65536.0f / 1000.0f));
         }
-        else if (receiving_cmd)
+        else
         {
-            // ★修改：合并判断逻辑，增强健壮性
-            if (received_char == '\r' || received_char == '\n')
-            {
-                if (cmd_index > 0)
-                {
-                    cmd_buffer[cmd_index] = '\0'; // 封闭字符串
-
-                    // 匹配 "@speed%" 指令
-                    if (strncmp(cmd_buffer, "@speed%", 7) == 0)
-                    {
-                        char *num_str = cmd_buffer + 7; // 提取数值部分
-                        if (*num_str != '\0')
-                        {
-                            target_speed = atoi(num_str);  // 更新目标速度
-                            Speed_PID_Reset();             // ★修改：保持快速响应逻辑
-                        }
-                    }
-                }
-                receiving_cmd = 0;
-                cmd_index = 0;
-            }
-            else if (cmd_index < sizeof(cmd_buffer) - 1)
+            err = Serial_Next_Float(&arg, &beta);
+            if (!err) err = Serial_Next_Float(&arg, &gamma);
+            if (err) return err;
+            // 先按浮点值限定范围，避免换算 Q16 时溢出；稳定域由 Observer_Set_Gains 检查
+            if (first <= 0 || first > 1 || beta <= 0 || beta >= 2 || gamma <= 0 || gamma >= beta ||
+                !Observer_Set_Gains(value, (int32_t)(first * 65536.0f), (int32_t)(beta * 65536.0f),
+                                    (int32_t)(gamma * 65536.0f)))
+                return FMT_ERR_RANGE;
+        }
+    }
+    Observer_Request_Report();
+    return FMT_OK;
+}
+
+// @baud%<速率> 请求切换波特率；@baud%ok 以新速率确认；@baud%? 查询
+static uint8_t Cmd_Baud(const char *arg)
+{
+    int32_t rate;
+
+    if (*arg == '?')
+    {
+        Baud_Request_Report();
+        return FMT_OK;
+    }
+    if (Fmt_Match(arg, "ok"))
+    {
+        Baud_Confirm();
+        return FMT_OK;
+    }
+    uint8_t err = Fmt_Parse_Int(&arg, 1, INT32_MAX, &rate);
+    if (err) return err;
+    return Baud_Request(rate) ? FMT_OK : FMT_ERR_RANGE;
+}
+
+// @tel%<通道>,<死区> 设置遥测死区；@tel%h<毫秒> 心跳周期；@tel%b<毫秒> 突发时长；@tel%? 查询
+static uint8_t Cmd_Tel(const char *arg)
+{
+    int32_t ch, value;
+    uint8_t err = FMT_OK;
+
+    switch (*arg)
+    {
+        case 'h':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 1, UINT16_MAX, &value);
+            if (!err) Telemetry_Set_Heartbeat(value);
+            break;
+        case 'b':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 0, UINT16_MAX, &value);
+            if (!err) Telemetry_Set_Burst(value);
+            break;
+        case '?':
+            break;
+        default:
+            err = Fmt_Parse_Int(&arg, 0, TELEM_CHANNELS - 1, &ch);
+            if (!err) err = Serial_Next_Int(&arg, 0, UINT16_MAX, &value);
+            if (!err) Telemetry_Set_Deadband(ch, value);
+            break;
+    }
+    if (err) return err;
+    Telemetry_Request_Report();
+    return FMT_OK;
+}
+
+/**
+ * @brief 跳过 ',' 后解析十六进制地址/数值
+ */
+static uint8_t Serial_Next_Hex(const char **p, uint32_t *value)
+{
+    if (**p != ',')
+        return FMT_ERR_EMPTY;
+    (*p)++;
+    return Fmt_Parse_Hex(p, value);
+}
+
+// @mlist%<序号>,<地址hex>,<大小>：定义测量采集表项（大小0删除）；@mlist%c 清空
+static uint8_t Cmd_MeasList(const char *arg)
+{
+    int32_t index, size;
+    uint32_t addr;
+
+    if (*arg == 'c')
+    {
+        Measure_Clear();
+        return FMT_OK;
+    }
+    uint8_t err = Fmt_Parse_Int(&arg, 0, MEAS_MAX_ENTRIES - 1, &index);
+    if (!err) err = Serial_Next_Hex(&arg, &addr);
+    if (!err) err = Serial_Next_Int(&arg, 0, 4, &size);
+    if (err) return err;
+    return Measure_Set_Entry(index, addr, size) ? FMT_OK : FMT_ERR_RANGE;
+}
+
+// @mdaq%<周期ms>：开始周期采集（0停止）；@mdaq%? 查询采集表与统计
+static uint8_t Cmd_MeasDaq(const char *arg)
+{
+    int32_t period;
+
+    if (*arg != '?')
+    {
+        uint8_t err = Fmt_Parse_Int(&arg, 0, 1000, &period);
+        if (err) return err;
+        Measure_Start(period);
+    }
+    Measure_Request_Report();
+    return FMT_OK;
+}
+
+// @mread%<地址hex>,<大小>：单次读取
+static uint8_t Cmd_MeasRead(const char *arg)
+{
+    int32_t size;
+    uint32_t addr;
+
+    uint8_t err = Fmt_Parse_Hex(&arg, &addr);
+    if (!err) err = Serial_Next_Int(&arg, 1, 4, &size);
+    if (err) return err;
+    return Measure_Read(addr, size) ? FMT_OK : FMT_ERR_RANGE;
+}
+
+// @mwrite%<地址hex>,<大小>,<值hex>：暂存写入；@mwrite%c 提交；@mwrite%x 放弃
+static uint8_t Cmd_MeasWrite(const char *arg)
+{
+    int32_t size;
+    uint32_t addr, value;
+
+    if (*arg == 'c' || *arg == 'x')
+    {
+        Measure_Commit(*arg == 'c');
+        return FMT_OK;
+    }
+    uint8_t err = Fmt_Parse_Hex(&arg, &addr);
+    if (!err) err = Serial_Next_Int(&arg, 1, 4, &size);
+    if (!err) err = Serial_Next_Hex(&arg, &value);
+    if (err) return err;
+    return Measure_Stage_Write(addr, size, value) ? FMT_OK : FMT_ERR_RANGE;
+}
+
+// @link%? 查询二进制命令通道统计
+static uint8_t Cmd_Link(const char *arg)
+{
+    Link_Request_Report();
+    return FMT_OK;
+}
+
+// @pvt%<dt>,<位置>,<速度>：写入轨迹点，队列满时回复错误码7（LINK_ERR_BUSY）
+// @pvt%g 立即开始；@pvt%x 停止并清空（之后以速度0保持）；@pvt%k<增益Q8> 位置增益；@pvt%? 查询
+static uint8_t Cmd_Pvt(const char *arg)
+{
+    int32_t dt, pos, vel, kp;
+    uint8_t err;
+
+    switch (*arg)
+    {
+        case 'g':
+            Pvt_Start();
+            return FMT_OK;
+        case 'x':
+            Pvt_Stop();
+            target_speed = 0;
+            return FMT_OK;
+        case 'k':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 0, UINT16_MAX, &kp);
+            if (err) return err;
+            Pvt_Set_Gain(kp);
+            break;
+        case '?':
+            break;
+        default:
+            err = Fmt_Parse_Int(&arg, 1, PVT_MAX_DT, &dt);
+            if (!err) err = Serial_Next_Int(&arg, -PVT_POS_MAX, PVT_POS_MAX, &pos);
+            if (!err) err = Serial_Next_Int(&arg, -PVT_VEL_MAX, PVT_VEL_MAX, &vel);
+            if (err) return err;
+            return Pvt_Push(dt, pos, vel) ? FMT_OK : LINK_ERR_BUSY;
+    }
+    Pvt_Request_Report();
+    return FMT_OK;
+}
+
+// @gear%<分子>,<分母>：模式2电机2按比例跟随电机1；@gear%k<增益Q8> 跟随增益
+// @gear%r 清零最大跟随误差；@gear%? 查询
+static uint8_t Cmd_Gear(const char *arg)
+{
+    int32_t num, den, kp;
+    uint8_t err;
+
+    switch (*arg)
+    {
+        case 'k':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 0, UINT16_MAX, &kp);
+            if (err) return err;
+            Gear_Set_Gain(kp);
+            break;
+        case 'r': Gear_Reset_Stats(); break;
+        case '?':                     break;
+        default:
+            err = Fmt_Parse_Int(&arg, -GEAR_NUM_MAX, GEAR_NUM_MAX, &num);
+            if (!err) err = Serial_Next_Int(&arg, 1, UINT16_MAX, &den);
+            if (err) return err;
+            Gear_Set_Ratio(num, den);
+            break;
+    }
+    Gear_Request_Report(0);
+    return FMT_OK;
+}
+
+// @cam%s<点数>,<主轴周期>,<升程>[,<三次插值0|1>]：凸轮形状；@cam%<序号>,<位置>：表值
+// @cam%e 选用凸轮（之后不能改表，@gear%分子,分母 退回齿轮方式）；@cam%? 查询
+static uint8_t Cmd_Cam(const char *arg)
+{
+    int32_t index, pos, period, rise, cubic = 1;
+    uint8_t err;
+
+    switch (*arg)
+    {
+        case 's':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 2, CAM_MAX_POINTS, &index);
+            if (!err) err = Serial_Next_Int(&arg, 2, CAM_PERIOD_MAX, &period);
+            if (!err) err = Serial_Next_Int(&arg, -CAM_POS_MAX, CAM_POS_MAX, &rise);
+            if (!err && *arg == ',') err = Serial_Next_Int(&arg, 0, 1, &cubic);
+            if (err) return err;
+            if (!Gear_Set_Cam_Shape(index, period, rise, cubic)) return FMT_ERR_RANGE;
+            return FMT_OK;
+        case 'e':
+            if (!Gear_Select_Cam()) return FMT_ERR_RANGE;
+            Gear_Request_Report(0);
+            return FMT_OK;
+        case '?':
+            Gear_Request_Report(1);
+            return FMT_OK;
+        default:
+            err = Fmt_Parse_Int(&arg, 0, CAM_MAX_POINTS - 1, &index);
+            if (!err) err = Serial_Next_Int(&arg, -CAM_POS_MAX, CAM_POS_MAX, &pos);
+            if (err) return err;
+            return Gear_Set_Cam_Point(index, pos) ? FMT_OK : FMT_ERR_RANGE;
+    }
+}
+
+// @sync%1：从速度模式进入模式3交叉耦合同步，两电机按 @speed% 目标同速运行；@sync%0 回到速度模式
+// @sync%k<增益Q8> 耦合增益（0为两轴独立，上限 SYNC_KC_MAX）；@sync%r 清零最大同步误差；@sync%? 查询
+static uint8_t Cmd_Sync(const char *arg)
+{
+    int32_t kc;
+    uint8_t err;
+
+    switch (*arg)
+    {
+        case '1':
+            if (current_mode != 1 || Friction_Calib_IsRunning() || Autotune_IsRunning() ||
+                SysId_IsRunning() || Pvt_IsActive())
+                return FMT_ERR_RANGE;
+            Sync_Start();
+            Speed_PID_Reset();
+            current_mode = 3;
+            break;
+        case '0':
+            Timer_Request_Exit(3);          // 由速度环切换，避免与本周期输出交错
+            break;
+        case 'k':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 0, SYNC_KC_MAX, &kc);
+            if (err) return err;
+            Sync_Set_Gain(kc);
+            break;
+        case 'r': Sync_Reset_Stats(); break;
+        case '?':                     break;
+        default:  return FMT_ERR_EMPTY;
+    }
+    Sync_Request_Report();
+    return FMT_OK;
+}
+
+// @drv%1：从速度模式进入模式4差速底盘（电机1左轮、电机2右轮），速度命令清零；@drv%0 回到速度模式
+// @drv%v<mm/s>,<mrad/s> 线速度、角速度；@drv%g<每米脉冲数>,<轮距mm>[,<轮速上限>] 几何参数（之后宜 @drv%z）
+// @drv%p<Hz> 位姿输出频率（0关闭）；@drv%z 位姿清零；@drv%? 查询
+static uint8_t Cmd_Drive(const char *arg)
+{
+    int32_t v, w, cpm, track, max;
+    uint8_t err;
+
+    switch (*arg)
+    {
+        case '1':
+            if (current_mode != 1 || Friction_Calib_IsRunning() || Autotune_IsRunning() ||
+                SysId_IsRunning() || Pvt_IsActive())
+                return FMT_ERR_RANGE;
+            Drive_Set_Velocity(0, 0);
+            Speed_PID_Reset();
+            current_mode = 4;
+            break;
+        case '0':
+            Timer_Request_Exit(4);          // 由速度环切换，避免与本周期输出交错
+            break;
+        case 'v':
+            arg++;
+            err = Fmt_Parse_Int(&arg, INT16_MIN, INT16_MAX, &v);
+            if (!err) err = Serial_Next_Int(&arg, INT16_MIN, INT16_MAX, &w);
+            if (err) return err;
+            Drive_Set_Velocity(v, w);
+            return FMT_OK;
+        case 'g':
+            arg++;
+            err = Fmt_Parse_Int(&arg, DRIVE_CPM_MIN, DRIVE_CPM_MAX, &cpm);
+            if (!err) err = Serial_Next_Int(&arg, DRIVE_TRACK_MIN, DRIVE_TRACK_MAX, &track);
+            if (!err && *arg == ',')
             {
-                cmd_buffer[cmd_index++] = received_char;
+                err = Serial_Next_Int(&arg, 0, INT16_MAX, &max);
+                if (!err) Drive_Set_Wheel_Max(max);
             }
-            else
+            if (err) return err;
+            Drive_Set_Geometry(cpm, track);
+            break;
+        case 'p':
+            arg++;
+            err = Fmt_Parse_Int(&arg, 0, DRIVE_STREAM_MAX_HZ, &v);
+            if (err) return err;
+            Drive_Set_Stream(v);
+            return FMT_OK;
+        case 'z': Drive_Reset_Pose(); return FMT_OK;
+        case '?':                     break;
+        default:  return FMT_ERR_EMPTY;
+    }
+    Drive_Request_Report();
+    return FMT_OK;
+}
+
+static const Serial_Command serial_commands[] =
+{
+    { "@speed%", Cmd_Speed },
+    { "@calib%", Cmd_Calib },
+    { "@tune%",  Cmd_Tune  },
+    { "@ident%", Cmd_Ident },
+    { "@pid%",   Cmd_Pid   },
+    { "@adapt%", Cmd_Adapt },
+    { "@gs%",    Cmd_GainSched },
+    { "@obs%",   Cmd_Observer },
+    { "@sched%", Cmd_Sched },
+    { "@task%",  Cmd_Task  },
+    { "@cpu%",   Cmd_Cpu   },
+    { "@prof%",  Cmd_Prof  },
+    { "@mem%",   Cmd_Mem   },
+    { "@baud%",  Cmd_Baud  },
+    { "@tel%",   Cmd_Tel   },
+    { "@mlist%", Cmd_MeasList  },
+    { "@mdaq%",  Cmd_MeasDaq   },
+    { "@mread%", Cmd_MeasRead  },
+    { "@mwrite%", Cmd_MeasWrite },
+    { "@link%",  Cmd_Link  },
+    { "@pvt%",   Cmd_Pvt   },
+    { "@gear%",  Cmd_Gear  },
+    { "@cam%",   Cmd_Cam   },
+    { "@sync%",  Cmd_Sync  },
+    { "@drv%",   Cmd_Drive },
+};
+
+/**
+ * @brief 回复参数错误（接收中断中调用，不经 printf）
+ *
+ * 格式：err,<命令前缀>,<错误码>\n，错误码见 Fmt.h（1缺少数字，2超出范围）
+ */
+static void Serial_Reject(const char *prefix, uint8_t err)
+{
+    char line[24];
+    uint8_t n = 0;
+
+    line[n++] = 'e';
+    line[n++] = 'r';
+    line[n++] = 'r';
+    line[n++] = ',';
+    while (*prefix && n < sizeof(line) - 4)
+    {
+        line[n++] = *prefix++;
+    }
+    line[n++] = ',';
+    line[n++] = '0' + err;
+    line[n++] = '\n';
+    Serial_Tx_Write(line, n);
+}
+
+/**
+ * @brief 在命令表中查找命令
+ * @param cmd 命令串
+ * @param len 输出前缀长度
+ * @return 命令表项，未找到返回 NULL
+ */
+static const Serial_Command *Serial_Find(const char *cmd, uint8_t *len)
+{
+    for (uint8_t i = 0; i < sizeof(serial_commands) / sizeof(serial_commands[0]); i++)
+    {
+        *len = Fmt_Match(cmd, serial_commands[i].prefix);
+        if (*len)
+        {
+            return &serial_commands[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 在命令表中查找并执行一条完整命令
+ * @param cmd 以 '\0' 结尾的命令串
+ */
+static void Serial_Dispatch(const char *cmd)
+{
+    uint8_t len;
+    const Serial_Command *c = Serial_Find(cmd, &len);
+
+    if (c && cmd[len] != '\0')
+    {
+        uint8_t err = c->handler(cmd + len);
+        if (err)
+        {
+            Serial_Reject(c->prefix, err);
+        }
+    }
+}
+
+/**
+ * @brief 处理一个接收字符：拼接命令，收到完整一行后按命令表分发
+ * 
+ * 整数参数越界或缺失时不执行，回复 err,<命令前缀>,<错误码>。
+ * 支持命令格式：
+ *     @speed%100   → 设置目标速度为100
+ *     @calib%1     → 标定电机1的摩擦模型
+ *     @tune%200,0  → 在速度200附近继电自整定，规则0（Z-N PID）
+ *     @ident%1,300,100,5 → 电机1以300为偏置、±100 PRBS辨识
+ *     @pid%5.0,1.5,0.5   → 设置速度环增益
+ */
+static void Serial_Rx_Char(char received_char)
+{
+    // 命令起始符检测
+    if (received_char == '@')
+    {
+        receiving_cmd = 1;
+        cmd_index = 0;
+        cmd_buffer[cmd_index++] = received_char;
+    }
+    else if (receiving_cmd)
+    {
+        // ★修改：合并判断逻辑，增强健壮性
+        if (received_char == '\r' || received_char == '\n')
+        {
+            if (cmd_index > 0)
             {
-                // 缓冲区溢出保护
-                receiving_cmd = 0;
-                cmd_index = 0;
+                cmd_buffer[cmd_index] = '\0'; // 封闭字符串
+                Serial_Dispatch(cmd_buffer);
             }
+            receiving_cmd = 0;
+            cmd_index = 0;
+        }
+        else if (cmd_index < sizeof(cmd_buffer) - 1)
+        {
+            cmd_buffer[cmd_index++] = received_char;
+        }
+        else
+        {
+            // 缓冲区溢出保护
+            receiving_cmd = 0;
+            cmd_index = 0;
         }
+    }
+}
+
+
+/**
+ * @brief 处理DMA已写入、尚未处理的字节（USART1空闲线或DMA半满/全满中断中调用）
+ *
+ * DMA写位置由剩余传输数换算，只能看出写位置模 SERIAL_RX_SIZE 的值。
+ * 两次处理之间到达超过 SERIAL_RX_SIZE 字节时，DMA 已整圈越过 rx_read、
+ * 覆盖了未处理的数据，由半满/全满标志识别：每越过一个半区边界置一个
+ * 标志，读到的标志多于 rx_read 到写位置之间的边界数即为整圈超越。
+ * 先读标志再读写位置，两次读取之间越过的边界记入 rx_flag_debt，
+ * 标志在下次处理时读到后抵消。超越时丢弃缓冲中的数据并放弃拼接中的
+ * 命令（二进制帧由校验丢弃），计入 lapped。
+ */
+static void Serial_Rx_Service(void)
+{
+    uint32_t flags = DMA1->ISR & (DMA1_FLAG_HT5 | DMA1_FLAG_TC5);
+    uint16_t head = (SERIAL_RX_SIZE - DMA_GetCurrDataCounter(DMA1_Channel5)) & (SERIAL_RX_SIZE - 1);
+    uint16_t span = (head - rx_read) & (SERIAL_RX_SIZE - 1);
+    uint8_t crossed = (rx_read + span) / SERIAL_RX_HALF - rx_read / SERIAL_RX_HALF;
+    uint8_t seen = ((flags & DMA1_FLAG_HT5) != 0) + ((flags & DMA1_FLAG_TC5) != 0);
+
+    DMA_ClearFlag(flags);
+    rx_stats.events++;
+    rx_stats.bytes += span;
+    if (span > rx_stats.max_span) rx_stats.max_span = span;
+
+    if (seen > crossed + rx_flag_debt)
+    {
+        rx_stats.lapped++;
+        rx_flag_debt = 0;
+        rx_read = head;
+        receiving_cmd = 0;
+        cmd_index = 0;
+        return;
+    }
+    rx_flag_debt = crossed + rx_flag_debt - seen;
+
+    while (rx_read != head)
+    {
+        if (!Link_Rx_Byte(rx_ring[rx_read]))
+            Serial_Rx_Char(rx_ring[rx_read]);
+        rx_read = (rx_read + 1) & (SERIAL_RX_SIZE - 1);
+    }
+}
+
+
+/**
+ * @brief USART1 中断处理函数
+ * 
+ * 接收：空闲线（一帧结束）时处理已收到的字节；ORE/FE/NE 计数。
+ * 这些标志都由"读SR再读DR"清除，此时DMA已取走数据，读DR不会丢字节。
+ * 发送由DMA1通道4完成，见 DMA1_Channel4_IRQHandler。
+ */
+void USART1_IRQHandler(void)
+{
+    CPULOAD_ENTER(CPU_CTX_USART);
+
+    uint16_t sr = USART1->SR;
+    if (sr & (USART_FLAG_IDLE | USART_FLAG_ORE | USART_FLAG_FE | USART_FLAG_NE))
+    {
+        if (sr & USART_FLAG_ORE) rx_stats.overrun++;
+        if (sr & USART_FLAG_FE)  rx_stats.framing++;
+        if (sr & USART_FLAG_NE)  rx_stats.noise++;
+        if (sr & (USART_FLAG_ORE | USART_FLAG_FE | USART_FLAG_NE)) rx_error_total++;
+        (void)USART1->DR;
+        Serial_Rx_Service();
+    }
+
+    CPULOAD_EXIT();
+}
+
+
+/**
+ * @brief DMA1通道5中断：接收缓冲半满/全满，处理长于半个缓冲的连续数据
+ *
+ * 半满/全满标志由 Serial_Rx_Service 读取后清除（用于识别整圈超越）。
+ */
+void DMA1_Channel5_IRQHandler(void)
+{
+    CPULOAD_ENTER(CPU_CTX_USART);
+
+    Serial_Rx_Service();
+
+    CPULOAD_EXIT();
+}
+
+
+/**
+ * @brief DMA1通道4中断：一段发送完成，释放缓冲并启动下一段
+ */
+void DMA1_Channel4_IRQHandler(void)
+{
+    CPULOAD_ENTER(CPU_CTX_USART);
+
+    DMA_ClearITPendingBit(DMA1_IT_GL4);
+    DMA_Cmd(DMA1_Channel4, DISABLE);
+    tx_tail = (tx_tail + tx_dma_len) & (SERIAL_TX_SIZE - 1);
+    tx_dma_len = 0;
+    Serial_Tx_Kick();
+
+    CPULOAD_EXIT();
+}
+
+
+/**
+ * @brief 读取接收统计
+ */
+void Serial_Get_RxStats(Serial_RxStats *stats)
+{
+    *stats = rx_stats;
+}
+
+
+void Serial_Reset_RxStats(void)
+{
+    Serial_RxStats zero = { 0 };
+    rx_stats = zero;
+}
+
+
+/**
+ * @brief 发送缓冲剩余空间（字节）
+ */
+uint16_t Serial_Tx_Free(void)
+{
+    return (SERIAL_TX_SIZE - 1) - ((tx_head - tx_tail) & (SERIAL_TX_SIZE - 1));
+}
+
+
+/**
+ * @brief 写入一个字节到发送缓冲
+ * @return 1：成功；0：缓冲已满
+ *
+ * 主循环与控制中断都会写入，关中断保证写指针更新的原子性。
+ */
+static uint8_t Serial_Tx_Put(uint8_t ch)
+{
+    uint8_t ok = 0;
 
-        // 清除中断标志位
-        USART_ClearITPendingBit(USART1, USART_IT_RXNE);
+    __disable_irq();
+    uint16_t next = (tx_head + 1) & (SERIAL_TX_SIZE - 1);
+    if (next != tx_tail)
+    {
+        tx_buffer[tx_head] = ch;
+        tx_head = next;
+        ok = 1;
+    }
+    __enable_irq();
+
+    if (ok)
+    {
+        Serial_Tx_Kick();
+    }
+    return ok;
+}
+
+
+/**
+ * @brief DMA空闲时启动下一段发送
+ *
+ * 每段取 tx_tail 起的连续字节（到 tx_head 或缓冲末尾），回绕部分
+ * 留给下一段。发送期间这段字节仍计为已占用，写入方不会覆盖。
+ */
+static void Serial_Tx_Kick(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (tx_dma_len == 0 && tx_tail != tx_head)
+    {
+        uint16_t len = (tx_head > tx_tail ? tx_head : SERIAL_TX_SIZE) - tx_tail;
+        USART_ClearFlag(USART1, USART_FLAG_TC);     // 供 Baud_Port_Tx_Idle 判断最后一字节已移出
+        DMA1_Channel4->CMAR = (uint32_t)&tx_buffer[tx_tail];
+        DMA_SetCurrDataCounter(DMA1_Channel4, len);
+        DMA_Cmd(DMA1_Channel4, ENABLE);
+        tx_dma_len = len;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+
+/**
+ * @brief 整段写入发送缓冲
+ * @return 1：已写入；0：空间不足，未写入任何字节
+ *
+ * 关中断一次写完，其他上下文写入的字节不会插入段中间，二进制应答帧
+ * 与遥测帧据此保持完整。
+ */
+static uint8_t Serial_Tx_Block(const uint8_t *data, uint8_t len)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (Serial_Tx_Free() < len)
+    {
+        __set_PRIMASK(primask);
+        return 0;
+    }
+    for (uint8_t i = 0; i < len; i++)
+    {
+        tx_buffer[tx_head] = data[i];
+        tx_head = (tx_head + 1) & (SERIAL_TX_SIZE - 1);
     }
+
+    __set_PRIMASK(primask);
+    Serial_Tx_Kick();
+    return 1;
+}
+
+
+/**
+ * @brief 写入一段字符到发送缓冲（缓冲满时丢弃剩余部分）
+ */
+static void Serial_Tx_Write(const char *s, uint8_t len)
+{
+    while (len-- && Serial_Tx_Put((uint8_t)*s++));
 }
 
 
 /**
  * @brief printf重定向函数
  * 
- * 说明：将标准输出（printf）映射到USART1发送端
+ * 说明：将标准输出（printf）映射到USART1发送缓冲。
+ * 缓冲满时主循环中等待DMA发完一段腾出空间；中断中调用则直接丢弃，
+ * 避免在高于USART1优先级的上下文中死等。
  */
 int fputc(int ch, FILE *f)
 {
-    USART_SendData(USART1, (uint8_t)ch);
-    while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);
+    while (!Serial_Tx_Put((uint8_t)ch))
+    {
+        if (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk)
+            break;
+    }
     return ch;
 }
 
 
 /**
- * @brief 发送调试数据到上位机
+ * @brief 发送一帧遥测（PendSV 下半部调用，见 Telemetry.c）
+ * @param line 帧内容（含换行）
+ * @param len 字节数
+ * @return 1：已写入；0：遥测暂停或发送缓冲放不下整帧，丢弃本帧
+ *
+ * 放不下时整帧丢弃，避免输出半行；整帧一次写入，不会被其他上下文的输出打断。
+ */
+uint8_t Serial_Send_Frame(const char *line, uint8_t len)
+{
+    if (!telemetry_enabled || telemetry_hold)
+        return 0;
+    return Serial_Tx_Block((const uint8_t *)line, len);
+}
+
+
+/**
+ * @brief 开关周期遥测
+ * @param enable 0暂停，1恢复
  * 
- * 格式：<当前速度,目标速度>\n
- * 例如：120,100\n
+ * 主循环输出多行报告前暂停，避免中断中的遥测行插入报告中间。
+ */
+void Serial_Telemetry_Enable(uint8_t enable)
+{
+    telemetry_enabled = enable;
+}
+
+
+/* ---------------- 波特率协商平台接口（见 Baud.h） ---------------- */
+
+/**
+ * @brief 设置波特率：USART1 在 APB2（72MHz），16倍过采样时 BRR = fPCLK2 / 波特率
+ */
+void Baud_Port_Apply(uint32_t baud)
+{
+    USART1->BRR = (uint16_t)((SystemCoreClock + baud / 2) / baud);
+}
+
+
+uint8_t Baud_Port_Tx_Idle(void)
+{
+    return tx_head == tx_tail && tx_dma_len == 0 && USART_GetFlagStatus(USART1, USART_FLAG_TC);
+}
+
+
+/**
+ * @brief 累计接收错误数：独立计数，@sched%r 清零接收统计时不回退
+ */
+uint32_t Baud_Port_Errors(void)
+{
+    return rx_error_total;
+}
+
+
+/**
+ * @brief 协商期间暂停遥测：PendSV 不会在空闲判断与改写 BRR 之间启动新的发送
+ */
+void Baud_Port_Hold_Telemetry(uint8_t hold)
+{
+    telemetry_hold = hold;
+}
+
+
+void Baud_Port_Reply(const char *line)
+{
+    printf("%s", line);
+}
+
+
+/* ---------------- 二进制命令通道平台接口（见 Link.h） ---------------- */
+
+/**
+ * @brief 执行一条二进制命令（接收中断中调用，与 ASCII 命令同一上下文）
+ * @return 0 或错误码（LINK_ERR_*，参数错误沿用 FMT_ERR_*）
  */
-void USART_Send_Data(int16_t speed1, int16_t target_speed)
+uint8_t Link_Port_Execute(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                          uint8_t *reply, uint8_t *reply_len)
+{
+    switch (cmd)
+    {
+        case LINK_CMD_PING:
+            return 0;
+
+        case LINK_CMD_SPEED:
+            if (len != 2) return LINK_ERR_LENGTH;
+            target_speed = (int16_t)(payload[0] | payload[1] << 8);
+            Speed_PID_Reset();
+            return 0;
+
+        case LINK_CMD_PID:
+        {
+            float gains[3];
+            if (len != sizeof(gains)) return LINK_ERR_LENGTH;
+            memcpy(gains, payload, sizeof(gains));      // 小端 IEEE754，与 Cortex-M3 相同
+            Speed_PID_SetParams(gains[0], gains[1], gains[2]);
+            GainSched_Invalidate();
+            return 0;
+        }
+
+        case LINK_CMD_STATUS:
+            reply[0] = (uint16_t)target_speed & 0xFF;
+            reply[1] = (uint16_t)target_speed >> 8;
+            reply[2] = current_mode;
+            *reply_len = 3;
+            return 0;
+
+        case LINK_CMD_PVT:
+        {
+            if (len == 10)
+            {
+                uint16_t dt;
+                int32_t pos, vel;
+                memcpy(&dt, payload, 2);                // 小端，与 Cortex-M3 相同
+                memcpy(&pos, payload + 2, 4);
+                memcpy(&vel, payload + 6, 4);
+                if (dt == 0 || dt > PVT_MAX_DT || pos < -PVT_POS_MAX || pos > PVT_POS_MAX ||
+                    vel < -PVT_VEL_MAX || vel > PVT_VEL_MAX)
+                    return LINK_ERR_RANGE;
+                if (!Pvt_Push(dt, pos, vel))
+                    return LINK_ERR_BUSY;               // 队列满：不推进序号，上位机稍后重发
+            }
+            else if (len != 0)
+            {
+                return LINK_ERR_LENGTH;
+            }
+            Pvt_Stats s;
+            Pvt_Get_Stats(&s);
+            reply[0] = Pvt_Free();
+            reply[1] = s.state;
+            *reply_len = 2;
+            return 0;
+        }
+
+        case LINK_CMD_TEXT:
+        {
+            char text[sizeof(cmd_buffer)];
+            uint8_t prefix_len;
+            if (len == 0 || len >= sizeof(text)) return LINK_ERR_LENGTH;
+            memcpy(text, payload, len);
+            text[len] = '\0';
+            const Serial_Command *c = Serial_Find(text, &prefix_len);
+            if (!c) return LINK_ERR_CMD;
+            if (text[prefix_len] == '\0') return LINK_ERR_EMPTY;
+            return c->handler(text + prefix_len);
+        }
+
+        default:
+            return LINK_ERR_CMD;
+    }
+}
+
+
+uint8_t Link_Port_Send(const uint8_t *frame, uint8_t len)
 {
-    printf("%d,%d\n", speed1, target_speed);
+    return Serial_Tx_Block(frame, len);
 }
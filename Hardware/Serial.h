@@ -8,14 +8,58 @@
  * 
  * 提供功能：
  *  - Serial_Init() : 初始化串口通信
- *  - USART_Send_Data() : 发送实时数据到上位机
+ *  - Serial_Send_Frame() : 发送一帧遥测（格式见 Telemetry.h）
+ *  - printf 经发送环形缓冲由DMA成段发出，不阻塞调用方
+ *  - 接收经DMA循环缓冲，空闲线/半满/全满时批量处理
  * 
  * 注意：
- *  串口波特率：115200
- *  上位机命令格式：@speed%数值
+ *  串口波特率：默认115200，可协商至2M（见 Baud.h）
+ *  上位机命令格式：@speed%数值   设置目标速度
+ *                  @calib%电机   摩擦标定（速度模式下有效）
+ *                  @tune%速度[,规则[,继电幅值]]  速度环继电自整定
+ *                  @ident%电机,偏置,幅值[,保持]  PRBS系统辨识
+ *                  @pid%Kp,Ki,Kd  设置速度环增益
+ *                  @adapt%开关[,Tcl_ms[,λ‰]]  在线自适应速度环（?查询）
+ *                  @gs%序号,速度,Kp,Ki,Kd  设置增益调度断点
+ *                  @gs%e1/e0/c/s/?  调度开关/清空/保存/查询
+ *                  @obs%电机,θ‰ 或 @obs%电机,α,β,γ  观测器增益
+ *                  @obs%f1/f0/?  速度环使用估计速度开关/查询
+ *                  @sched%?  多速率调度、采样抖动与串口接收统计（r清零）
+ *                  @task%?   主循环任务耗时、超时与负载
+ *                  @cpu%?    各中断/主循环/空闲CPU占比（r清零峰值）
+ *                  @prof%s[,基址,位数] / x / d  PC采样开始/停止/导出
+ *                  @mem%?    栈高水位、中断嵌套链与各段大小
+ *                  @baud%速率 / ok / ?  波特率协商、确认、查询
+ *                  @tel%通道,死区 / h毫秒 / b毫秒 / ?  遥测死区、心跳、突发时长、查询
+ *                  @mlist% @mdaq% @mread% @mwrite%  按地址测量与标定（见 Measure.h）
+ *                  @link%?   二进制命令通道统计
+ *                  @pvt%dt,位置,速度 / g / x / k增益 / ?  PVT轨迹点、开始、停止、位置增益、查询
+ *                  @gear%分子,分母 / k增益 / r / ?  模式2电子齿轮比例、跟随增益、清零、查询
+ *                  @cam%s点数,周期,升程[,三次] / 序号,位置 / e / ?  电子凸轮形状、表值、选用、查询
+ *                  @sync%1 / 0 / k增益 / r / ?  进入/退出模式3交叉耦合同步、耦合增益、清零、查询
+ *                  @drv%1 / 0 / v线速度,角速度 / g每米脉冲,轮距[,轮速上限] / p频率 / z / ?
+ *                                   进入/退出模式4差速底盘、速度命令、几何参数、位姿输出频率、位姿清零、查询
+ *  以 0x00 分隔的 COBS 帧为二进制命令（带校验、序号与应答，见 Link.h）
+ *  参数错误（缺少数字或超出范围）时回复 err,<命令前缀>,<1|2>；PVT 队列满时为 7
  * ========================================================== */
 
+// 接收统计
+typedef struct
+{
+    uint32_t bytes;         // 接收字节数
+    uint32_t events;        // 接收处理次数（空闲线、DMA半满/全满、错误）
+    uint16_t max_span;      // 单次处理的最大字节数
+    uint16_t overrun;       // ORE 溢出次数
+    uint16_t framing;       // FE 帧错误次数
+    uint16_t noise;         // NE 噪声次数
+    uint16_t lapped;        // DMA 整圈越过未处理数据的次数（数据被覆盖、已丢弃）
+} Serial_RxStats;
+
 void Serial_Init(void);
-void USART_Send_Data(int16_t speed1, int16_t target_speed);
+uint8_t Serial_Send_Frame(const char *line, uint8_t len);
+void Serial_Telemetry_Enable(uint8_t enable);
+uint16_t Serial_Tx_Free(void);
+void Serial_Get_RxStats(Serial_RxStats *stats);
+void Serial_Reset_RxStats(void);
 
 #endif
@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include "Sync.h"
+
+/* ==========================================================
+ * 交叉耦合同步控制（Sync.c）
+ *
+ * 起点请求来自串口中断，只置标志，由速度环在下一周期锁存两轴位置。
+ * 位移按无符号相减，编码器累计计数跨越 ±2^31 回绕时同步误差仍正确。
+ * ========================================================== */
+
+static volatile uint8_t sync_start_req = 0;
+static uint16_t sync_kc_q8 = SYNC_KC_Q8;
+static int32_t sync_origin1 = 0;
+static int32_t sync_origin2 = 0;
+
+// 统计（速度环写，主循环读）
+static int32_t sync_error = 0;
+static int32_t sync_max_error = 0;
+static int16_t sync_corr = 0;
+static volatile uint8_t sync_report = 0;
+
+
+static int16_t Sync_Sat16(int32_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : (int16_t)v;
+}
+
+
+void Sync_Start(void)
+{
+    sync_start_req = 1;
+}
+
+
+void Sync_Set_Gain(uint16_t kc_q8)
+{
+    sync_kc_q8 = kc_q8;
+}
+
+
+/**
+ * @brief 计算两轴速度目标（速度环中每1ms调用）
+ * @param pos1 电机1累计位置
+ * @param pos2 电机2累计位置
+ * @param target 公共速度目标（Encoder_Get_Speed 的单位）
+ * @param target1 输出电机1速度目标
+ * @param target2 输出电机2速度目标
+ * @return 同步误差（电机1位移 - 电机2位移）
+ */
+int32_t Sync_Tick(int32_t pos1, int32_t pos2, int16_t target, int16_t *target1, int16_t *target2)
+{
+    if (sync_start_req)
+    {
+        sync_start_req = 0;
+        sync_origin1 = pos1;
+        sync_origin2 = pos2;
+        sync_max_error = 0;
+    }
+
+    int32_t err = (int32_t)(((uint32_t)pos1 - (uint32_t)sync_origin1) - ((uint32_t)pos2 - (uint32_t)sync_origin2));
+    sync_error = err;
+    if (err > sync_max_error) sync_max_error = err;
+    if (-err > sync_max_error) sync_max_error = -err;
+
+    int64_t c = ((int64_t)err * sync_kc_q8 + 128) >> 8;
+    if (c > SYNC_CORR_MAX) c = SYNC_CORR_MAX;
+    if (c < -SYNC_CORR_MAX) c = -SYNC_CORR_MAX;
+    sync_corr = (int16_t)c;
+
+    *target1 = Sync_Sat16((int32_t)target - sync_corr);
+    *target2 = Sync_Sat16((int32_t)target + sync_corr);
+    return err;
+}
+
+
+void Sync_Reset_Stats(void)
+{
+    sync_max_error = 0;
+}
+
+
+void Sync_Request_Report(void)
+{
+    sync_report = 1;
+}
+
+
+/**
+ * @brief 输出报告（主循环中调用）
+ *
+ * 格式：sync,<耦合增益Q8>,<同步误差>,<最大同步误差>,<修正量>\n
+ */
+void Sync_PollReport(void)
+{
+    if (!sync_report)
+        return;
+    sync_report = 0;
+
+    printf("sync,%u,%ld,%ld,%d\n", sync_kc_q8, (long)sync_error, (long)sync_max_error, sync_corr);
+}
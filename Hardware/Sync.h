@@ -0,0 +1,47 @@
+#ifndef __SYNC_H
+#define __SYNC_H
+
+#include <stdint.h>
+
+/* ==========================================================
+ * 交叉耦合同步控制接口说明（模式3：两电机同速运行）
+ *
+ * 两个电机各自的速度环独立运行时，负载、摩擦与测速量化的差别会使
+ * 两轴位置差不断累积（差速底盘跑偏、双皮带错位）。模式3中两个速度环
+ * 共用 @speed% 目标，另按两轴位置差（同步误差）给出修正量：
+ *
+ *   同步误差 e = (电机1位移) - (电机2位移)，位移从进入模式3时算起
+ *   修正量   c = e × 耦合增益（Q8，速度单位/脉冲），限幅 ±SYNC_CORR_MAX
+ *   电机1目标 = 目标 - c，电机2目标 = 目标 + c
+ *
+ * 领先的一轴减速、落后的一轴加速，两个速度环都含积分，恒定的不对称
+ * 负载下同步误差收敛到0；一轴负载过大达到输出限幅时，另一轴随之减速
+ * 等待，而不是各自运行、位置差逐次累积。耦合增益为0时两轴独立运行，可用于对比。
+ *
+ * 位置差经耦合增益再进入速度环，增益过大时与速度环相互作用形成持续
+ * 振荡：仿真中默认 PID 参数、低速（10~20）下 10 起同步误差开始摆动，
+ * 12 以上振荡幅度随增益增大。@sync%k 只接受 0 ~ SYNC_KC_MAX；更换电机
+ * 或 PID 参数后先用仿真评估再调整上限。
+ *
+ * 只依赖 stdint/stdio，上位机仿真（Tools/sync_sim.c）直接编译本文件。
+ *
+ * - Sync_Start()                       进入模式3前调用，下次 Sync_Tick 以当时位置为起点
+ * - Sync_Set_Gain(kc)                  耦合增益（Q8）
+ * - Sync_Tick(pos1, pos2, target, t1, t2)  速度环中每1ms调用，返回同步误差
+ * - Sync_Reset_Stats()                 清零最大同步误差
+ * - Sync_Request_Report()              命令 @sync%?
+ * - Sync_PollReport()                  主循环中调用
+ * ========================================================== */
+
+#define SYNC_KC_Q8              8       // 默认耦合增益：误差32脉冲时每轴修正1个速度单位
+#define SYNC_KC_MAX             9       // 耦合增益上限（串口命令），见上文
+#define SYNC_CORR_MAX           200     // 修正量限幅（速度单位）
+
+void Sync_Start(void);
+void Sync_Set_Gain(uint16_t kc_q8);
+int32_t Sync_Tick(int32_t pos1, int32_t pos2, int16_t target, int16_t *target1, int16_t *target2);
+void Sync_Reset_Stats(void);
+void Sync_Request_Report(void);
+void Sync_PollReport(void);
+
+#endif
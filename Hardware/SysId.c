@@ -0,0 +1,177 @@
+#include "stm32f10x.h"
+#include "SysId.h"
+#include "Motor.h"
+#include "Serial.h"
+#include <stdio.h>
+
+/* ==========================================================
+ * 系统辨识模块（SysId.c）
+ * 功能：
+ *  - 偏置段：先以 offset 稳定运行，避开起动静摩擦
+ *  - 激励段：u = offset ± amp，符号由LFSR输出位决定
+ *  - 速度存为 int16，激励只存1位，共约2.1KB RAM
+ * ========================================================== */
+
+#define SYSID_SETTLE_TICKS  500     // 偏置段长度（周期）
+
+typedef enum
+{
+    SYSID_IDLE = 0,
+    SYSID_SETTLE,
+    SYSID_RECORD,
+} SysId_State;
+
+static volatile SysId_State sysid_state = SYSID_IDLE;
+static volatile uint8_t sysid_done = 0;
+static uint8_t sysid_motor = 1;
+static int16_t sysid_offset;
+static int16_t sysid_amp;
+static uint8_t sysid_hold;
+static uint8_t sysid_hold_count;
+static uint16_t sysid_lfsr;             // 9位LFSR：x^9 + x^5 + 1
+static uint8_t sysid_bit;               // 当前激励位
+static uint16_t sysid_timer;
+static uint16_t sysid_count;            // 已记录点数
+
+static int16_t sysid_speed[SYSID_SAMPLES];
+static uint8_t sysid_input[SYSID_SAMPLES / 8];   // 激励位（1：offset+amp）
+
+
+/**
+ * @brief LFSR 前进一步
+ * @return 输出位
+ */
+static uint8_t SysId_Lfsr_Next(void)
+{
+    uint8_t bit = ((sysid_lfsr >> 8) ^ (sysid_lfsr >> 4)) & 1;
+    sysid_lfsr = ((sysid_lfsr << 1) | bit) & 0x1FF;
+    return bit;
+}
+
+
+/**
+ * @brief 启动辨识
+ * @param num    电机编号（1或2）
+ * @param offset 偏置指令
+ * @param amp    PRBS幅值
+ * @param hold   每位保持周期数（决定激励带宽，约为时间常数的1/3~1/5）
+ */
+void SysId_Start(uint8_t num, int16_t offset, int16_t amp, uint8_t hold)
+{
+    if (sysid_state != SYSID_IDLE || (num != 1 && num != 2))
+        return;
+
+    sysid_motor = num;
+    sysid_offset = offset;
+    sysid_amp = (amp > 0) ? amp : -amp;
+    sysid_hold = (hold > 0) ? hold : 1;
+    sysid_hold_count = 0;
+    sysid_lfsr = 0x1FF;                 // 非零种子
+    sysid_timer = 0;
+    sysid_count = 0;
+    sysid_done = 0;
+    sysid_state = SYSID_SETTLE;
+}
+
+
+void SysId_Abort(void)
+{
+    if (sysid_state != SYSID_IDLE)
+    {
+        sysid_state = SYSID_IDLE;
+        Motor_Set_Speed(sysid_motor, 0);
+    }
+}
+
+
+uint8_t SysId_IsRunning(void)
+{
+    return sysid_state != SYSID_IDLE;
+}
+
+
+uint8_t SysId_Motor(void)
+{
+    return sysid_motor;
+}
+
+
+/**
+ * @brief 辨识状态机，控制中断中每周期调用
+ * @param speed 被辨识电机本周期速度（对应上一周期的激励）
+ * 
+ * 第k点记录的是本周期施加的激励u[k]与同一时刻读到的速度v[k]，
+ * v[k]反映的是u[k-1]及更早的输入，拟合时按此对齐。
+ */
+void SysId_Tick(int16_t speed)
+{
+    switch (sysid_state)
+    {
+    case SYSID_SETTLE:
+        Motor_Set_Speed(sysid_motor, sysid_offset);
+        if (++sysid_timer >= SYSID_SETTLE_TICKS)
+        {
+            sysid_state = SYSID_RECORD;
+        }
+        break;
+
+    case SYSID_RECORD:
+        if (sysid_hold_count == 0)
+        {
+            sysid_bit = SysId_Lfsr_Next();
+            sysid_hold_count = sysid_hold;
+        }
+        sysid_hold_count--;
+
+        sysid_speed[sysid_count] = speed;
+        if (sysid_bit)
+            sysid_input[sysid_count >> 3] |= (1 << (sysid_count & 7));
+        else
+            sysid_input[sysid_count >> 3] &= ~(1 << (sysid_count & 7));
+
+        Motor_Set_Speed(sysid_motor, sysid_bit ? sysid_offset + sysid_amp : sysid_offset - sysid_amp);
+
+        if (++sysid_count >= SYSID_SAMPLES)
+        {
+            Motor_Set_Speed(sysid_motor, 0);
+            sysid_state = SYSID_IDLE;
+            sysid_done = 1;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+uint8_t SysId_PollDone(void)
+{
+    uint8_t done = sysid_done;
+    sysid_done = 0;
+    return done;
+}
+
+
+/**
+ * @brief 串口导出记录数据（主循环中调用，约需0.7s）
+ * 
+ * 格式：
+ *   ident,<电机>,<偏置>,<幅值>,<保持>,<点数>,<周期us>\n
+ *   <u>,<v>\n   × 点数
+ *   ident,end\n
+ */
+void SysId_Dump(void)
+{
+    Serial_Telemetry_Enable(0);
+    printf("ident,%d,%d,%d,%d,%d,%d\n", sysid_motor, sysid_offset, sysid_amp,
+           sysid_hold, SYSID_SAMPLES, 1000);
+    for (uint16_t i = 0; i < SYSID_SAMPLES; i++)
+    {
+        uint8_t bit = (sysid_input[i >> 3] >> (i & 7)) & 1;
+        printf("%d,%d\n", bit ? sysid_offset + sysid_amp : sysid_offset - sysid_amp,
+               sysid_speed[i]);
+    }
+    printf("ident,end\n");
+    Serial_Telemetry_Enable(1);
+}
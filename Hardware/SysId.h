@@ -0,0 +1,33 @@
+#ifndef __SYSID_H
+#define __SYSID_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 系统辨识模块接口说明（PRBS激励 + RAM记录）
+ *
+ * 在偏置指令上叠加伪随机二进制序列（9位LFSR，周期511位），
+ * 逐周期记录激励与编码器速度，完成后由主循环经串口导出，
+ * 上位机用 Tools/sysid_fit.c 拟合一/二阶电机模型。
+ *
+ * - SysId_Start(num, offset, amp, hold) 启动辨识（仅速度模式）
+ *                                       hold：每位保持的控制周期数
+ * - SysId_Abort()                       中止并停止电机
+ * - SysId_IsRunning()                   运行中返回1
+ * - SysId_Motor()                       被辨识电机编号
+ * - SysId_Tick(speed)                   控制中断中每周期调用
+ * - SysId_PollDone()                    记录完成后返回一次1
+ * - SysId_Dump()                        串口导出记录数据
+ * ========================================================== */
+
+#define SYSID_SAMPLES   1024    // 记录长度（1ms/点，约1s）
+
+void SysId_Start(uint8_t num, int16_t offset, int16_t amp, uint8_t hold);
+void SysId_Abort(void);
+uint8_t SysId_IsRunning(void);
+uint8_t SysId_Motor(void);
+void SysId_Tick(int16_t speed);
+uint8_t SysId_PollDone(void);
+void SysId_Dump(void);
+
+#endif
@@ -0,0 +1,197 @@
+#include "stm32f10x.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "Telemetry.h"
+#include "Serial.h"
+#include "Defer.h"
+#include "Fmt.h"
+
+/* ==========================================================
+ * 变化量触发遥测模块（Telemetry.c）
+ *
+ * 上半部（控制中断，1kHz）比较各通道与上次已发送的值，决定本次
+ * 要发送的通道掩码，保存快照后置位 DEFER_TELEMETRY；下半部（PendSV）
+ * 格式化并写入发送缓冲，写入成功后才更新"已发送值"，因此丢弃的帧
+ * 会在下次采样时以最新值补发。
+ *
+ * 下半部尚未取走快照时上半部不覆盖，跳过本次采样（已发送值未更新，
+ * 变化不会丢失，只是晚1ms）。
+ * ========================================================== */
+
+#define TELEM_FLAG_HEARTBEAT    0x80
+#define TELEM_EVENT_SHIFT       5       // 事件位在掩码中的位置
+
+static uint16_t tel_deadband[TELEM_CHANNELS] = { 2, 0, 8, 2, 4 };
+static uint16_t tel_heartbeat_ms = TELEM_HEARTBEAT_MS;
+static uint16_t tel_burst_ms = TELEM_BURST_MS;
+
+static int16_t tel_sent[TELEM_CHANNELS];        // 上次已发送的值（下半部写）
+static volatile uint32_t tel_last_frame = 0;    // 上次成功发送的时刻（下半部写）
+static uint32_t tel_ms = 0;                     // 采样计数（1ms）
+static uint32_t tel_burst_end = 0;              // 突发结束时刻
+
+// 快照（上半部写，下半部读）
+static int16_t tel_snap[TELEM_CHANNELS];
+static uint32_t tel_snap_ms = 0;
+static volatile uint8_t tel_snap_mask = 0;      // 非0表示有待发送的帧
+
+// 统计
+static uint32_t tel_frames = 0;
+static uint32_t tel_bytes = 0;
+static uint32_t tel_dropped = 0;
+static uint32_t tel_bursts = 0;
+static volatile uint8_t tel_report = 0;
+
+
+/**
+ * @brief 遥测下半部（PendSV）：格式化快照并写入发送缓冲
+ */
+static void Telemetry_Send(void)
+{
+    int16_t values[TELEM_CHANNELS];
+    uint32_t ms;
+    uint8_t mask;
+    char line[8 + 11 + 3 + TELEM_CHANNELS * 7];     // 留出余量："<ms>,<mask>" + 每通道 ",-32768"
+    uint8_t n;
+
+    __disable_irq();
+    mask = tel_snap_mask;
+    ms = tel_snap_ms;
+    for (uint8_t i = 0; i < TELEM_CHANNELS; i++) values[i] = tel_snap[i];
+    __enable_irq();
+
+    if (!mask)
+        return;
+
+    n = Fmt_Uint(line, ms);
+    line[n++] = ',';
+    Fmt_Hex_Fixed(line + n, mask, 2);
+    n += 2;
+    for (uint8_t i = 0; i < TELEM_CHANNELS; i++)
+    {
+        if (mask & (1 << i))
+        {
+            line[n++] = ',';
+            n += Fmt_Int(line + n, values[i]);
+        }
+    }
+    line[n++] = '\n';
+
+    if (Serial_Send_Frame(line, n))
+    {
+        for (uint8_t i = 0; i < TELEM_CHANNELS; i++)
+        {
+            if (mask & (1 << i)) tel_sent[i] = values[i];
+        }
+        tel_last_frame = ms;
+        tel_frames++;
+        tel_bytes += n;
+    }
+    else
+    {
+        tel_dropped++;
+    }
+    tel_snap_mask = 0;
+}
+
+
+void Telemetry_Init(void)
+{
+    Defer_Register(DEFER_TELEMETRY, Telemetry_Send);
+}
+
+
+/**
+ * @brief 采样一次各通道（控制中断中每1ms调用）
+ * @param values 各通道当前值，TELEM_CHANNELS 个
+ * @param events 本次采样发生的事件（TELEM_EVENT_*），任一事件开始一次突发
+ */
+void Telemetry_Sample(const int16_t *values, uint8_t events)
+{
+    uint8_t mask = 0;
+
+    tel_ms++;
+    if (events)
+    {
+        tel_burst_end = tel_ms + tel_burst_ms;
+        tel_bursts++;
+    }
+    if (tel_snap_mask)
+        return;
+
+    if ((int32_t)(tel_burst_end - tel_ms) > 0 || events)
+    {
+        mask = (1 << TELEM_CHANNELS) - 1;
+    }
+    else if (tel_ms - tel_last_frame >= tel_heartbeat_ms)
+    {
+        mask = ((1 << TELEM_CHANNELS) - 1) | TELEM_FLAG_HEARTBEAT;
+    }
+    else
+    {
+        for (uint8_t i = 0; i < TELEM_CHANNELS; i++)
+        {
+            if (abs(values[i] - tel_sent[i]) > tel_deadband[i]) mask |= 1 << i;
+        }
+        if (!mask)
+            return;
+    }
+
+    mask |= events << TELEM_EVENT_SHIFT;
+    for (uint8_t i = 0; i < TELEM_CHANNELS; i++) tel_snap[i] = values[i];
+    tel_snap_ms = tel_ms;
+    tel_snap_mask = mask;
+    Defer_Post(DEFER_TELEMETRY);
+}
+
+
+void Telemetry_Set_Deadband(uint8_t ch, uint16_t deadband)
+{
+    if (ch < TELEM_CHANNELS)
+    {
+        tel_deadband[ch] = deadband;
+    }
+}
+
+
+void Telemetry_Set_Heartbeat(uint16_t ms)
+{
+    tel_heartbeat_ms = ms;
+}
+
+
+void Telemetry_Set_Burst(uint16_t ms)
+{
+    tel_burst_ms = ms;
+}
+
+
+void Telemetry_Request_Report(void)
+{
+    tel_report = 1;
+}
+
+
+/**
+ * @brief 输出遥测配置与统计（主循环中调用）
+ *
+ * 格式：tel,<通道>,<死区>,<上次发送值>\n（每通道一行）
+ *       tel,cfg,<心跳ms>,<突发ms>\n
+ *       tel,stat,<帧数>,<字节数>,<丢弃帧数>,<突发次数>,<运行ms>\n
+ */
+void Telemetry_PollReport(void)
+{
+    if (!tel_report)
+        return;
+    tel_report = 0;
+
+    Serial_Telemetry_Enable(0);
+    for (uint8_t i = 0; i < TELEM_CHANNELS; i++)
+    {
+        printf("tel,%u,%u,%d\n", i, tel_deadband[i], tel_sent[i]);
+    }
+    printf("tel,cfg,%u,%u\n", tel_heartbeat_ms, tel_burst_ms);
+    printf("tel,stat,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)tel_frames, (unsigned long)tel_bytes,
+           (unsigned long)tel_dropped, (unsigned long)tel_bursts, (unsigned long)tel_ms);
+    Serial_Telemetry_Enable(1);
+}
@@ -0,0 +1,50 @@
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 变化量触发遥测模块接口说明（send-on-delta）
+ *
+ * 控制中断每1ms采样一次各通道，只发送变化超过死区的通道：
+ *  - 稳态时各通道不变，只按心跳周期发送完整帧
+ *  - 目标速度改变、速度环进入饱和时触发突发，突发期间每次采样都发送完整帧
+ *  - 发送缓冲放不下一帧时丢弃，下次采样以最新值重试，链路带宽不足时
+ *    自动降低帧率
+ *
+ * 帧格式：<毫秒>,<掩码>,<值>...\n
+ *   掩码为两位十六进制：bit0~4 对应下面的通道，值按通道号顺序只列出置位的通道；
+ *   bit5 目标速度改变、bit6 进入饱和（触发突发的那一帧），bit7 心跳帧
+ *   例：1234,05,120,-35\n 表示第1234ms 电机1速度120、PWM -35
+ *
+ * - Telemetry_Init()                    登记 PendSV 发送处理函数
+ * - Telemetry_Sample(values, events)    控制中断中每1ms调用
+ * - Telemetry_Set_Deadband(ch, db)      设置通道死区（0为变化即发送）
+ * - Telemetry_Set_Heartbeat(ms)         心跳周期
+ * - Telemetry_Set_Burst(ms)             事件突发持续时间
+ * - Telemetry_Request_Report()          请求主循环输出配置与统计
+ * - Telemetry_PollReport()              有报告请求时输出
+ * ========================================================== */
+
+#define TELEM_CH_SPEED1     0       // 电机1速度（速度环反馈）
+#define TELEM_CH_TARGET     1       // 速度环目标（PVT 运行时为插值结果）
+#define TELEM_CH_PWM1       2       // 速度环输出
+#define TELEM_CH_SPEED2     3       // 电机2速度
+#define TELEM_CH_POSERR     4       // 位置差 pos1-pos2，模式2为电机2跟随误差，模式3为同步误差（限幅到 int16）
+#define TELEM_CHANNELS      5
+
+#define TELEM_EVENT_SETPOINT    0x01    // 目标速度改变
+#define TELEM_EVENT_SATURATE    0x02    // 速度环输出进入限幅
+
+#define TELEM_HEARTBEAT_MS  100     // 默认心跳周期
+#define TELEM_BURST_MS      50      // 默认突发持续时间
+
+void Telemetry_Init(void);
+void Telemetry_Sample(const int16_t *values, uint8_t events);
+void Telemetry_Set_Deadband(uint8_t ch, uint16_t deadband);
+void Telemetry_Set_Heartbeat(uint16_t ms);
+void Telemetry_Set_Burst(uint16_t ms);
+void Telemetry_Request_Report(void);
+void Telemetry_PollReport(void);
+
+#endif
@@ -1,112 +1,443 @@
 #include "stm32f10x.h"
+#include "Timer.h"
 #include "Encoder.h"
 #include "Serial.h"
 #include "PID.h"
 #include "Motor.h"
+#include "Friction.h"
+#include "Autotune.h"
+#include "SysId.h"
+#include "Adaptive.h"
+#include "GainSched.h"
+#include "Observer.h"
+#include "Delay.h"
+#include "CpuLoad.h"
+#include "Telemetry.h"
+#include "Measure.h"
+#include "Pvt.h"
+#include "Gear.h"
+#include "Sync.h"
+#include "Drive.h"
+#include "QEnc.h"
+#include <stdio.h>
 #include <stdlib.h>
 
-extern uint8_t current_mode;     // 当前控制模式：1-速度，2-位置
+extern uint8_t current_mode;     // 当前控制模式：1-速度，2-位置，3-同步，4-差速底盘
 extern int16_t target_speed;     // 电机目标速度~~
 
+/* ==========================================================
+ * 多速率控制调度（Timer.c）
+ *
+ * TIM1 更新中断作为唯一时基（10kHz），按速率表分频调用各环：
+ *
+ *   任务      频率     分频  相位  内容
+ *   inner    10kHz     1     0    占空比内环：斜率限制、换向死区、抖动帧输出（见 Motor.c）
+ *   speed     1kHz    10     1    编码器、观测器、里程计、标定/整定/辨识、速度环（模式3、4两个）
+ *   position 200Hz    50     3    模式2电子齿轮/凸轮跟随（见 Gear.c）
+ *   telem     1kHz    10     7    遥测采样（变化量触发，见 Telemetry.c）
+ *   meas      1kHz    10     9    标定写入提交、测量采集表采样（见 Measure.c）
+ *
+ * 相位错开使除内环外任意两个任务不落在同一时基周期（speed 在
+ * 个位为1的周期、position 为3、telem 为7、meas 为9），单个周期最坏负载
+ * 为 内环 + 最慢的一个任务，而非全部之和。
+ *
+ * 超时检测：
+ *  - 任务执行周期数超过其预算时该任务 overrun 计数加一
+ *  - 中断退出时若下一个更新事件已到达，说明丢失时基，late 计数加一
+ *
+ * 中断内只保留采样、计算与输出；遥测格式化交给 PendSV 下半部
+ * （见 Defer.c），telem 任务只判断哪些通道需要发送并保存快照。速度环采样
+ * 间隔的最小/最大值用于评估采样抖动。
+ * 速度环仍为1ms周期，PID 参数、速度单位与各标定模块保持不变。
+ * PVT 轨迹（见 Pvt.c）在速度环内插值，同一周期得到目标，不增加相位滞后。
+ * ========================================================== */
 
+typedef struct
+{
+    const char *name;
+    uint16_t divider;       // 分频（时基周期数）
+    uint16_t phase;         // 首次执行的时基周期（0 ~ divider-1）
+    uint16_t budget;        // 执行预算（CPU周期）
+    void (*task)(void);
+    uint16_t countdown;     // 距下次执行的时基周期数
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+    uint32_t overruns;
+} Control_Task;
+
+static int16_t control_fb_speed1 = 0;       // 速度环反馈速度，供遥测使用
+static int16_t control_target1 = 0;         // 速度环实际使用的目标（PVT 运行时为轨迹插值结果）
+static int16_t control_speed2 = 0;          // 电机2速度，供遥测使用
+static int16_t control_pwm1 = 0;            // 速度环输出，非速度模式为0
+static int32_t control_pos_err = 0;         // 位置差 pos1-pos2，模式2为电机2跟随误差
+static uint32_t sample_last = 0;            // 上次速度环采样时刻（DWT）
+static uint32_t sample_min = 0xFFFFFFFF;    // 采样间隔最小值（CPU周期）
+static uint32_t sample_max = 0;             // 采样间隔最大值
+static uint32_t control_late = 0;           // 丢失时基次数
+static uint32_t control_max_isr = 0;        // 单次中断最大周期数
+static volatile uint8_t control_report = 0;
+static volatile uint8_t control_exit_mode = 0;  // 待退出的模式，0为无请求（串口中断写，速度环处理）
+
+
+// 内环（10kHz）：占空比输出级。本板H桥无电流采样，以斜率限制代替电流环
+// 约束指令阶跃时的电流冲击，各环经 Motor_Set_Speed 只登记指令
+static void Control_Inner_Task(void)
+{
+    Motor_Duty_Tick();
+}
+
+
+// 速度环（1kHz）：编码器读取、观测器、标定类状态机与模式1速度控制
+static void Control_Speed_Task(void)
+{
+    // 采样间隔统计：理想值为 SystemCoreClock/1000
+    uint32_t now = DWT_CYCCNT;
+    uint32_t interval = now - sample_last;
+    if (sample_last != 0)
+    {
+        if (interval < sample_min) sample_min = interval;
+        if (interval > sample_max) sample_max = interval;
+    }
+    sample_last = now;
+
+    // 退出模式请求：串口中断优先级高于本中断，直接在串口中断里切换会与
+    // 本周期已开始的电机2输出交错（电机2停止后又被写回），因此在此处理
+    __disable_irq();
+    uint8_t exit_mode = control_exit_mode;
+    control_exit_mode = 0;
+    __enable_irq();
+    if(exit_mode != 0 && current_mode == exit_mode)
+    {
+        current_mode = 1;
+        Motor_Set_Speed(2, 0);      // 速度模式不驱动电机2
+        Speed_PID_Reset();
+    }
+
+    //读取编码器数据
+    int16_t speed1 = Encoder_Get_Speed(1);
+    int16_t speed2 = Encoder_Get_Speed(2);
+    int32_t pos1 = Encoder_Get_Position(1);
+    int32_t pos2 = Encoder_Get_Position(2);
+
+    // 状态观测器：每周期更新；启用反馈时速度环与遥测改用估计速度，
+    // 标定、整定与辨识仍使用原始差分速度
+    Observer_Update(1, pos1);
+    Observer_Update(2, pos2);
+    Drive_Odom_Tick(pos1, pos2);        // 里程计不分模式，轮子被推动也计入
+    int16_t fb_speed1 = Observer_Feedback_Enabled() ? Observer_Get_Speed(1) : speed1;
+    control_fb_speed1 = fb_speed1;
+    control_speed2 = speed2;
+    if(current_mode != 2 && current_mode != 3) control_pos_err = pos1 - pos2;   // 模式2、3由各自的控制写入跟随/同步误差
+    control_pwm1 = 0;
+    control_target1 = target_speed;
+
+    // 摩擦标定：暂停常规控制，由标定状态机接管被测电机
+    if(Friction_Calib_IsRunning())
+    {
+        uint8_t num = Friction_Calib_Motor();
+        Friction_Calib_Tick(num == 1 ? speed1 : speed2);
+        Motor_Set_Speed(num == 1 ? 2 : 1, 0);
+    }
+    // 继电自整定：由整定状态机接管电机1
+    else if(Autotune_IsRunning())
+    {
+        Autotune_Tick(speed1);
+        Motor_Set_Speed(2, 0);
+    }
+    // 系统辨识：PRBS激励并记录响应
+    else if(SysId_IsRunning())
+    {
+        uint8_t num = SysId_Motor();
+        SysId_Tick(num == 1 ? speed1 : speed2);
+        Motor_Set_Speed(num == 1 ? 2 : 1, 0);
+    }
+    // 模式1：速度控制
+    else if(current_mode == 1)
+    {
+        // PVT 轨迹运行或保持时由插值结果给出目标，否则跟随 @speed%
+        int16_t target = target_speed;
+        Pvt_Tick(pos1, &target);
+        control_target1 = target;
+
+        // 增益来源：自适应开启时由其接管，否则按调度表插值
+        if(!Adaptive_IsEnabled())
+        {
+            GainSched_Tick(target);
+        }
+        int16_t pwm1 = Speed_PID_Compute(target, fb_speed1);       // PID计算
+        Adaptive_Tick(fb_speed1, pwm1);                            // 在线辨识，周期性更新增益
+        control_pwm1 = pwm1;
+
+        // 摩擦前馈：按标定的库仑+粘滞模型补偿，替代固定偏置与死区
+        Motor_Set_Speed_Fine(1, ((int32_t)pwm1 << 8) + Friction_FeedForward_Q8(1, target));
+    }
+    // 模式3/4：两个速度环，目标由交叉耦合同步（见 Sync.c）或差速运动学（见 Drive.c）给出
+    else if(current_mode == 3 || current_mode == 4)
+    {
+        int16_t target1, target2;
+        int16_t fb_speed2 = Observer_Feedback_Enabled() ? Observer_Get_Speed(2) : speed2;
+
+        if(current_mode == 3)
+        {
+            control_pos_err = Sync_Tick(pos1, pos2, target_speed, &target1, &target2);
+        }
+        else
+        {
+            Drive_Wheel_Targets(&target1, &target2);
+        }
+        control_target1 = target1;
+
+        // 两轴共用增益，按电机1目标调度；自适应辨识按电机1单独运行设计，此处保持当前增益
+        if(!Adaptive_IsEnabled())
+        {
+            GainSched_Tick(target1);
+        }
+        int16_t pwm1 = Speed_PID_Compute_Motor(1, target1, fb_speed1);
+        int16_t pwm2 = Speed_PID_Compute_Motor(2, target2, fb_speed2);
+        control_pwm1 = pwm1;
+
+        Motor_Set_Speed_Fine(1, ((int32_t)pwm1 << 8) + Friction_FeedForward_Q8(1, target1));
+        Motor_Set_Speed_Fine(2, ((int32_t)pwm2 << 8) + Friction_FeedForward_Q8(2, target2));
+    }
+}
+
+
+// 位置环（200Hz）：模式2电机2按电子齿轮/凸轮跟随电机1，标定类状态机运行时不介入
+static void Control_Position_Task(void)
+{
+    if(current_mode != 2 || Friction_Calib_IsRunning() || Autotune_IsRunning() || SysId_IsRunning())
+    {
+        Gear_Release();     // 重新进入时以当时位置为起点
+        return;
+    }
+
+    int32_t pos1 = Encoder_Get_Position(1);
+    int32_t pos2 = Encoder_Get_Position(2);
+    int16_t speed_ref2;
+
+    control_pos_err = Gear_Tick(pos1, pos2, &speed_ref2);
+    target_position2 = pos2 + control_pos_err;
+
+    // 速度目标经电机2摩擦模型换算为指令；未标定时模型为0，以起动值代替，
+    // 跟随误差小于 1/增益 时速度目标为0，电机2停止
+    int32_t cmd_q8 = Friction_FeedForward_Q8(2, speed_ref2);
+    if(cmd_q8 == 0 && speed_ref2 != 0)
+    {
+        cmd_q8 = (speed_ref2 > 0) ? (int32_t)Friction_Breakaway(2, 1) << 8 : -((int32_t)Friction_Breakaway(2, -1) << 8);
+    }
+    Motor_Set_Speed_Fine(2, cmd_q8);
+
+    last_position1 = pos1;  // 更新上次位置
+    Motor_Set_Speed(1, 0);  // 位置模式下电机1自由转动
+}
+
+
+// 遥测（1kHz）：采样各通道并检测事件，由 Telemetry 按死区/突发/心跳决定是否发送
+static void Control_Telemetry_Task(void)
+{
+    static int16_t last_target = 0;
+    static uint8_t saturated = 0;
+    int16_t values[TELEM_CHANNELS];
+    uint8_t events = 0;
+
+    values[TELEM_CH_SPEED1] = control_fb_speed1;
+    values[TELEM_CH_TARGET] = control_target1;
+    values[TELEM_CH_PWM1] = control_pwm1;
+    values[TELEM_CH_SPEED2] = control_speed2;
+    values[TELEM_CH_POSERR] = control_pos_err > INT16_MAX ? INT16_MAX :
+                              control_pos_err < INT16_MIN ? INT16_MIN : control_pos_err;
+
+    // 事件按边沿触发：目标改变（@speed% 设定，PVT 插值的连续变化不触发）、速度环刚进入限幅
+    if (target_speed != last_target)
+    {
+        last_target = target_speed;
+        events |= TELEM_EVENT_SETPOINT;
+    }
+    uint8_t sat = abs(control_pwm1) >= SPEED_PID_OUT_MAX;
+    if (sat && !saturated)
+    {
+        events |= TELEM_EVENT_SATURATE;
+    }
+    saturated = sat;
+
+    Telemetry_Sample(values, events);
+}
+
+
+// 测量（1kHz）：与速度环同一毫秒内、速度环之后执行，采样值与本周期控制量一致
+static void Control_Measure_Task(void)
+{
+    Measure_Tick();
+}
+
+
+static Control_Task control_tasks[] =
+{
+    { "inner",    1,  0, 800,  Control_Inner_Task     },
+    { "speed",    10, 1, 5000, Control_Speed_Task     },
+    { "position", 50, 3, 2000, Control_Position_Task  },
+    { "telem",    10, 7, 1500, Control_Telemetry_Task },
+    { "meas",     10, 9, 1500, Control_Measure_Task   },
+};
+
+#define CONTROL_TASK_COUNT  (sizeof(control_tasks) / sizeof(control_tasks[0]))
+
+
+// 控制时基定时器：TIM1 更新中断，10kHz
+// TIM2 专用于 20kHz PWM 输出（见 Motor.c），控制节拍不与PWM共用时基。
 void Timer_Init(void)
 {
-    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+    for (uint8_t i = 0; i < CONTROL_TASK_COUNT; i++)
+    {
+        control_tasks[i].countdown = control_tasks[i].phase;
+    }
+    Telemetry_Init();
+    Measure_Init();
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1, ENABLE);
 
-    TIM_InternalClockConfig(TIM2);
+    TIM_InternalClockConfig(TIM1);
 
     TIM_TimeBaseInitTypeDef TIM_BaseInitStruct;
     TIM_BaseInitStruct.TIM_ClockDivision = TIM_CKD_DIV1;
     TIM_BaseInitStruct.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_BaseInitStruct.TIM_Period = 1000 - 1;   // 10ms中断
-    TIM_BaseInitStruct.TIM_Prescaler = 720 - 1; // 计数频率 10kHz
+    TIM_BaseInitStruct.TIM_Period = 1000000 / CONTROL_BASE_HZ - 1;  // 100us中断
+    TIM_BaseInitStruct.TIM_Prescaler = 72 - 1;  // 计数频率 1MHz
     TIM_BaseInitStruct.TIM_RepetitionCounter = 0;
-    TIM_TimeBaseInit(TIM2, &TIM_BaseInitStruct);
+    TIM_TimeBaseInit(TIM1, &TIM_BaseInitStruct);
 
-    TIM_ClearFlag(TIM2, TIM_FLAG_Update);
-    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+    TIM_ClearFlag(TIM1, TIM_FLAG_Update);
+    TIM_ITConfig(TIM1, TIM_IT_Update, ENABLE);
 
     // 配置NVIC优先级
     NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
     NVIC_InitTypeDef NVIC_InitStruct;
-    NVIC_InitStruct.NVIC_IRQChannel = TIM2_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannel = TIM1_UP_IRQn;
     NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
     NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = 2; // ★修改：降低抢占优先级
     NVIC_InitStruct.NVIC_IRQChannelSubPriority = 0;
     NVIC_Init(&NVIC_InitStruct);
 
-    TIM_Cmd(TIM2, ENABLE);
+    TIM_Cmd(TIM1, ENABLE);
 }
 
 
-void TIM2_IRQHandler(void)
+void TIM1_UP_IRQHandler(void)
 {
-    if(TIM_GetITStatus(TIM2, TIM_IT_Update) == SET)
+    CPULOAD_ENTER(CPU_CTX_CONTROL);
+    if(TIM_GetITStatus(TIM1, TIM_IT_Update) == SET)
     {
-        //读取编码器数据
-        int16_t speed1 = Encoder_Get_Speed(1);
-        int16_t speed2 = Encoder_Get_Speed(2);
-        int32_t pos1 = Encoder_Get_Position(1);
-        int32_t pos2 = Encoder_Get_Position(2);
+        TIM_ClearITPendingBit(TIM1, TIM_IT_Update); // 先清标志，退出前据此判断是否丢失时基
+        uint32_t isr_start = DWT_CYCCNT;
 
-        // 模式1：速度控制
-        if(current_mode == 1)
+        for (uint8_t i = 0; i < CONTROL_TASK_COUNT; i++)
         {
-            int16_t adjusted_target = target_speed; // 目标速度补偿
-
-            // 静摩擦补偿
-            if(abs(target_speed) > 5)
+            Control_Task *t = &control_tasks[i];
+            if (t->countdown > 0)
             {
-                adjusted_target += (target_speed > 0) ? 2 : -2;
+                t->countdown--;
+                continue;
             }
+            t->countdown = t->divider - 1;
+
+            uint32_t start = DWT_CYCCNT;
+            t->task();
+            uint32_t cycles = DWT_CYCCNT - start;
 
-            int16_t pwm1 = Speed_PID_Compute(adjusted_target, speed1); // PID计算
-            Motor_Set_Speed(1, pwm1);
+            t->last_cycles = cycles;
+            if (cycles > t->max_cycles) t->max_cycles = cycles;
+            if (cycles > t->budget) t->overruns++;
         }
-        //模式2：位置跟随
-        else
+
+        uint32_t isr_cycles = DWT_CYCCNT - isr_start;
+        if (isr_cycles > control_max_isr) control_max_isr = isr_cycles;
+        if (TIM_GetFlagStatus(TIM1, TIM_FLAG_Update) == SET)
         {
-            static uint8_t pulse_active = 0;  // 脉冲激活标志
-            static uint8_t pulse_count = 0;   // 脉冲计数器
+            control_late++;
+        }
+    }
+    CPULOAD_EXIT();
+}
 
-            int32_t pos_error = pos1 - pos2;
 
-            if(!pulse_active && abs(pos_error) > 100)
-            {
-                int16_t correction_pwm = (pos_error > 0) ? 120 : -120;
-                Motor_Set_Speed(2, correction_pwm); // 电机2脉冲修正
-                pulse_active = 1;
-                pulse_count = 0;
-            }
-            else if(pulse_active)
-            {
-                pulse_count++;
-                if(pulse_count > 3) // 30ms后停止
-                {
-                    Motor_Set_Speed(2, 0);
-                    pulse_active = 0;
-                }
-            }
-            else
-            {
-                Motor_Set_Speed(2, 0); // 微小误差保持停止
-            }
+// 丢失时基累计次数（健康检查使用）
+uint32_t Timer_Get_Late(void)
+{
+    return control_late;
+}
 
-            last_position1 = pos1;  // 更新上次位置
-            Motor_Set_Speed(1, 0);  // 位置模式下电机1自由转动
-        }
 
-        //发送数据到上位机
-        static uint8_t send_counter = 0;
-        if(send_counter++ >= 2) // 每20ms发送一次
-        {
-            if(USART_GetFlagStatus(USART1, USART_FLAG_TC))
-            {
-                USART_Send_Data(speed1, target_speed);
-            }
-            send_counter = 0;
-        }
+/**
+ * @brief 请求退出指定模式回到速度模式（串口中断中调用），下一个速度环周期开头生效
+ * @param mode 要退出的模式，届时当前不是该模式则忽略
+ */
+void Timer_Request_Exit(uint8_t mode)
+{
+    control_exit_mode = mode;
+}
 
-        TIM_ClearITPendingBit(TIM2, TIM_IT_Update); // 清除中断标志
+
+void Timer_Request_Report(void)
+{
+    control_report = 1;
+}
+
+
+/**
+ * @brief 清零调度统计（最大周期数与超时计数）
+ */
+void Timer_Reset_Stats(void)
+{
+    for (uint8_t i = 0; i < CONTROL_TASK_COUNT; i++)
+    {
+        control_tasks[i].max_cycles = 0;
+        control_tasks[i].overruns = 0;
+    }
+    control_late = 0;
+    control_max_isr = 0;
+    sample_min = 0xFFFFFFFF;
+    sample_max = 0;
+    Serial_Reset_RxStats();
+    QEnc_Reset_Stats();
+}
+
+
+/**
+ * @brief 输出调度统计（主循环中调用）
+ *
+ * 格式：sched,<任务>,<频率Hz>,<相位>,<最近周期数>,<最大周期数>,<预算>,<超时次数>\n
+ *       sched,isr,<最大周期数>,<时基周期数>,<丢失时基次数>\n
+ *       sched,jitter,<最小采样间隔>,<最大采样间隔>,<理想间隔>\n（CPU周期）
+ *       sched,rx,<字节数>,<处理次数>,<单次最大字节数>,<ORE>,<FE>,<NE>,<缓冲超越>\n
+ *       sched,qenc,<轴>,<非法跳变次数>,<最大边沿频率>,<边沿中断最大周期数>\n（轴3、4各一行）
+ */
+void Timer_PollReport(void)
+{
+    if (!control_report)
+        return;
+    control_report = 0;
+
+    Serial_Telemetry_Enable(0);
+    for (uint8_t i = 0; i < CONTROL_TASK_COUNT; i++)
+    {
+        const Control_Task *t = &control_tasks[i];
+        printf("sched,%s,%u,%u,%lu,%lu,%u,%lu\n", t->name, CONTROL_BASE_HZ / t->divider, t->phase,
+               (unsigned long)t->last_cycles, (unsigned long)t->max_cycles, t->budget,
+               (unsigned long)t->overruns);
+    }
+    printf("sched,isr,%lu,%lu,%lu\n", (unsigned long)control_max_isr,
+           (unsigned long)(SystemCoreClock / CONTROL_BASE_HZ), (unsigned long)control_late);
+    printf("sched,jitter,%lu,%lu,%lu\n", (unsigned long)sample_min, (unsigned long)sample_max,
+           (unsigned long)(SystemCoreClock / 1000));
+
+    Serial_RxStats rx;
+    Serial_Get_RxStats(&rx);
+    printf("sched,rx,%lu,%lu,%u,%u,%u,%u,%u\n", (unsigned long)rx.bytes, (unsigned long)rx.events,
+           rx.max_span, rx.overrun, rx.framing, rx.noise, rx.lapped);
+    for (uint8_t num = 3; num <= 4; num++)
+    {
+        printf("sched,qenc,%u,%lu,%lu,%lu\n", num, (unsigned long)QEnc_Get_ErrorCount(num),
+               (unsigned long)QEnc_Get_MaxEdgeRate(num), (unsigned long)QEnc_Get_MaxIsrCycles());
     }
+    Serial_Telemetry_Enable(1);
 }
@@ -1,6 +1,15 @@
 #ifndef __TIMER_H
 #define __TIMER_H
 
-void Timer_Init(void);  // 初始化TIM2定时器及中断
+#include "stm32f10x.h"
+
+#define CONTROL_BASE_HZ     10000   // 控制时基频率（TIM1更新中断）
+
+void Timer_Init(void);              // 初始化TIM1控制时基定时器及中断（10kHz）
+uint32_t Timer_Get_Late(void);      // 控制中断丢失时基累计次数
+void Timer_Request_Exit(uint8_t mode);  // 请求退出模式回到速度模式（下一速度环周期生效）
+void Timer_Request_Report(void);    // 请求主循环输出调度统计
+void Timer_Reset_Stats(void);       // 清零调度统计
+void Timer_PollReport(void);        // 有报告请求时输出各速率任务耗时与超时计数
 
 #endif
@@ -0,0 +1,96 @@
+#include "Cobs.h"
+
+/**
+  * @brief  COBS 编码
+  * @param  src 原始数据
+  * @param  len 原始长度
+  * @param  dst 输出缓冲，至少 COBS_MAX_ENCODED(len) 字节，不含帧分隔符
+  * @retval 编码后长度
+  */
+uint16_t Cobs_Encode(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+	uint16_t out = 1, code_pos = 0;
+	uint8_t code = 1;
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		if (src[i] == 0)
+		{
+			dst[code_pos] = code;
+			code_pos = out++;
+			code = 1;
+		}
+		else
+		{
+			dst[out++] = src[i];
+			if (++code == 0xFF)
+			{
+				dst[code_pos] = code;
+				code_pos = out++;
+				code = 1;
+			}
+		}
+	}
+	dst[code_pos] = code;
+	return out;
+}
+
+/**
+  * @brief  COBS 解码
+  * @param  src 编码数据（不含帧分隔符）
+  * @param  len 编码长度
+  * @param  dst 输出缓冲，至少 len 字节；可与 src 相同（原地解码）
+  * @retval 解码后长度；数据中含 0x00 或长度码越界时返回0
+  */
+uint16_t Cobs_Decode(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+	uint16_t in = 0, out = 0;
+
+	while (in < len)
+	{
+		uint8_t code = src[in++];
+		if (code == 0 || in + code - 1 > len)
+		{
+			return 0;
+		}
+		for (uint8_t k = 1; k < code; k++)
+		{
+			uint8_t b = src[in++];
+			if (b == 0)
+			{
+				return 0;
+			}
+			dst[out++] = b;
+		}
+		if (code != 0xFF && in < len)
+		{
+			dst[out++] = 0;
+		}
+	}
+	return out;
+}
+
+/**
+  * @brief  CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF）
+  * @param  data 数据
+  * @param  len 长度
+  * @retval 校验值
+  * @note   按半字节查表，表只有16项
+  */
+uint16_t Cobs_Crc16(const uint8_t *data, uint16_t len)
+{
+	static const uint16_t table[16] =
+	{
+		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+		0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	};
+	uint16_t crc = 0xFFFF;
+
+	while (len--)
+	{
+		uint8_t b = *data++;
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (b >> 4)];
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (b & 0x0F)];
+	}
+	return crc;
+}
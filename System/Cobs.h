@@ -0,0 +1,17 @@
+#ifndef __COBS_H
+#define __COBS_H
+
+#include <stdint.h>
+
+/* COBS 帧编码与 CRC-16 校验
+ * COBS 把一包数据变换为不含 0x00 的字节串，0x00 专用作帧分隔符，
+ * 接收方遇到 0x00 即可重新同步；开销为每254字节加1字节。
+ * 只依赖 stdint.h，上位机工具（Tools/link_host.c）直接编译同一份源码。 */
+
+#define COBS_MAX_ENCODED(n)	((n) + (n) / 254 + 1)	// n 字节编码后的最大长度
+
+uint16_t Cobs_Encode(const uint8_t *src, uint16_t len, uint8_t *dst);
+uint16_t Cobs_Decode(const uint8_t *src, uint16_t len, uint8_t *dst);
+uint16_t Cobs_Crc16(const uint8_t *data, uint16_t len);
+
+#endif
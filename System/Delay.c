@@ -1,17 +1,30 @@
 #include "stm32f10x.h"
+#include "Delay.h"
+
+/**
+  * @brief  开启DWT周期计数器
+  * @param  无
+  * @retval 无
+  * @note   CYCCNT以HCLK（72MHz）自增，供各模块测量执行周期数
+  */
+void Delay_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;	//使能DWT/ITM跟踪单元
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;									//CYCCNTENA
+}
 
 /**
   * @brief  微秒级延时
-  * @param  xus 延时时长，范围：0~233015
+  * @param  xus 延时时长，范围：0~59652323
   * @retval 无
+  * @note   以DWT周期计数器计时，SysTick 留作调度节拍（见 Sched.c）
   */
 void Delay_us(uint32_t xus)
 {
-	SysTick->LOAD = 72 * xus;				//设置定时器重装值
-	SysTick->VAL = 0x00;					//清空当前计数值
-	SysTick->CTRL = 0x00000005;				//设置时钟源为HCLK，启动定时器
-	while(!(SysTick->CTRL & 0x00010000));	//等待计数到0
-	SysTick->CTRL = 0x00000004;				//关闭定时器
+	uint32_t start = DWT_CYCCNT;
+	uint32_t cycles = xus * (SystemCoreClock / 1000000);
+	while(DWT_CYCCNT - start < cycles);		//差值运算，计数器回绕不影响
 }
 
 /**
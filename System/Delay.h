@@ -1,6 +1,13 @@
 #ifndef __DELAY_H
 #define __DELAY_H
 
+#include "stm32f10x.h"
+
+// DWT周期计数器（CMSIS V1.30 未提供DWT结构体，直接按地址访问）
+#define DWT_CTRL      (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT    (*(volatile uint32_t *)0xE0001004)
+
+void Delay_Init(void);
 void Delay_us(uint32_t us);
 void Delay_ms(uint32_t ms);
 void Delay_s(uint32_t s);
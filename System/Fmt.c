@@ -0,0 +1,207 @@
+#include "Fmt.h"
+
+/**
+  * @brief  无符号数除以10
+  * @param  n 被除数
+  * @retval n / 10
+  * @note   0xCCCCCCCD / 2^35 ≈ 1/10，对全部32位输入结果精确；
+  *         编译为一条 UMULL 加移位，比 UDIV 稳定且不随数值变化
+  */
+static uint32_t Fmt_Div10(uint32_t n)
+{
+	return (uint32_t)(((uint64_t)n * 0xCCCCCCCDu) >> 35);
+}
+
+/**
+  * @brief  无符号十进制格式化
+  * @param  buf 输出缓冲，至少 FMT_INT_MAX_LEN + 1 字节
+  * @param  value 数值
+  * @retval 字符数（不含结束符）
+  */
+uint8_t Fmt_Uint(char *buf, uint32_t value)
+{
+	char tmp[10];
+	uint8_t n = 0, len;
+
+	do
+	{
+		uint32_t q = Fmt_Div10(value);
+		tmp[n++] = '0' + (value - q * 10);
+		value = q;
+	} while (value);
+
+	len = n;
+	while (n)
+	{
+		*buf++ = tmp[--n];
+	}
+	*buf = '\0';
+	return len;
+}
+
+/**
+  * @brief  有符号十进制格式化（负数带'-'，正数不带符号）
+  * @param  buf 输出缓冲，至少 FMT_INT_MAX_LEN + 1 字节
+  * @param  value 数值
+  * @retval 字符数（不含结束符）
+  */
+uint8_t Fmt_Int(char *buf, int32_t value)
+{
+	if (value < 0)
+	{
+		*buf = '-';
+		return 1 + Fmt_Uint(buf + 1, 0u - (uint32_t)value);
+	}
+	return Fmt_Uint(buf, value);
+}
+
+/**
+  * @brief  固定位数十进制格式化
+  * @param  buf 输出缓冲，至少 width 字节，不加结束符
+  * @param  value 数值
+  * @param  width 位数，高位补0，超出部分截去高位（与OLED_ShowNum一致）
+  * @retval 无
+  */
+void Fmt_Uint_Fixed(char *buf, uint32_t value, uint8_t width)
+{
+	while (width)
+	{
+		uint32_t q = Fmt_Div10(value);
+		buf[--width] = '0' + (value - q * 10);
+		value = q;
+	}
+}
+
+/**
+  * @brief  固定位数十六进制格式化（大写）
+  * @param  buf 输出缓冲，至少 width 字节，不加结束符
+  * @param  value 数值
+  * @param  width 位数，范围：1~8
+  * @retval 无
+  */
+void Fmt_Hex_Fixed(char *buf, uint32_t value, uint8_t width)
+{
+	while (width)
+	{
+		uint8_t digit = value & 0x0F;
+		buf[--width] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		value >>= 4;
+	}
+}
+
+/**
+  * @brief  解析十进制整数并检查范围
+  * @param  s 输入串指针，成功时移到数字之后
+  * @param  min、max 允许范围（闭区间）
+  * @param  value 输出数值，仅成功时写入
+  * @retval FMT_OK；FMT_ERR_EMPTY 没有数字；FMT_ERR_RANGE 超出范围（含32位溢出）
+  * @note   接受可选的'+'/'-'，遇到第一个非数字字符停止
+  */
+uint8_t Fmt_Parse_Int(const char **s, int32_t min, int32_t max, int32_t *value)
+{
+	const char *p = *s;
+	uint8_t negative = 0;
+	uint32_t acc = 0;
+	uint8_t overflow = 0;
+
+	if (*p == '-' || *p == '+')
+	{
+		negative = (*p == '-');
+		p++;
+	}
+	if (*p < '0' || *p > '9')
+	{
+		return FMT_ERR_EMPTY;
+	}
+
+	while (*p >= '0' && *p <= '9')
+	{
+		// 超过 2^31 后不再累加，只吃掉剩余数字
+		if (acc > 214748364)
+		{
+			overflow = 1;
+		}
+		else
+		{
+			acc = acc * 10 + (*p - '0');
+			if (acc > 2147483648u) overflow = 1;
+		}
+		p++;
+	}
+	if (overflow || (!negative && acc > 2147483647u))
+	{
+		return FMT_ERR_RANGE;
+	}
+
+	int32_t v = negative ? (int32_t)(0u - acc) : (int32_t)acc;
+	if (v < min || v > max)
+	{
+		return FMT_ERR_RANGE;
+	}
+	*value = v;
+	*s = p;
+	return FMT_OK;
+}
+
+/**
+  * @brief  解析十六进制无符号数（可带"0x"前缀，大小写均可）
+  * @param  s 输入串指针，成功时移到数字之后
+  * @param  value 输出数值，仅成功时写入
+  * @retval FMT_OK；FMT_ERR_EMPTY 没有数字；FMT_ERR_RANGE 超过8位
+  */
+uint8_t Fmt_Parse_Hex(const char **s, uint32_t *value)
+{
+	const char *p = *s;
+	uint32_t acc = 0;
+	uint8_t digits = 0;
+
+	if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+	{
+		p += 2;
+	}
+	while (1)
+	{
+		char c = *p;
+		uint8_t d;
+		if (c >= '0' && c <= '9')      d = c - '0';
+		else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+		else break;
+
+		acc = (acc << 4) | d;
+		digits++;
+		p++;
+	}
+	if (digits == 0)
+	{
+		return FMT_ERR_EMPTY;
+	}
+	if (digits > 8)
+	{
+		return FMT_ERR_RANGE;
+	}
+	*value = acc;
+	*s = p;
+	return FMT_OK;
+}
+
+/**
+  * @brief  前缀匹配
+  * @param  s 输入串
+  * @param  prefix 前缀
+  * @retval 匹配时返回前缀长度，否则返回0
+  */
+uint8_t Fmt_Match(const char *s, const char *prefix)
+{
+	uint8_t n = 0;
+
+	while (prefix[n])
+	{
+		if (s[n] != prefix[n])
+		{
+			return 0;
+		}
+		n++;
+	}
+	return n;
+}
@@ -0,0 +1,24 @@
+#ifndef __FMT_H
+#define __FMT_H
+
+#include <stdint.h>
+
+/* 整数格式化与解析（不依赖 stdio/stdlib）
+ * 串口遥测、命令解析和OLED数字显示共用，除10用乘法代替除法。
+ * 只依赖 stdint.h，上位机工具（Tools/fmt_bench.c）可直接编译同一份源码。 */
+
+#define FMT_OK			0
+#define FMT_ERR_EMPTY	1		// 没有数字
+#define FMT_ERR_RANGE	2		// 超出允许范围
+
+#define FMT_INT_MAX_LEN	11		// "-2147483648" 的长度，缓冲至少再加1个结束符
+
+uint8_t Fmt_Uint(char *buf, uint32_t value);
+uint8_t Fmt_Int(char *buf, int32_t value);
+void Fmt_Uint_Fixed(char *buf, uint32_t value, uint8_t width);
+void Fmt_Hex_Fixed(char *buf, uint32_t value, uint8_t width);
+uint8_t Fmt_Parse_Int(const char **s, int32_t min, int32_t max, int32_t *value);
+uint8_t Fmt_Parse_Hex(const char **s, uint32_t *value);
+uint8_t Fmt_Match(const char *s, const char *prefix);
+
+#endif
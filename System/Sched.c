@@ -0,0 +1,198 @@
+#include "stm32f10x.h"
+#include "Sched.h"
+#include "Delay.h"
+#include "CpuLoad.h"
+#include <stdio.h>
+
+#define SCHED_WINDOW_MS		1000		// 负载统计窗口
+
+static volatile uint32_t sched_tick = 0;
+static Sched_Task *sched_tasks;
+static uint8_t sched_count;
+static uint16_t sched_load = 0;			// 上一窗口忙碌比例（‰）
+static volatile uint8_t sched_report = 0;
+
+/**
+  * @brief  配置SysTick为1ms节拍中断
+  * @param  无
+  * @retval 无
+  * @note   SysTick 优先级为最低，与 PendSV 相同；Delay 已改用DWT计时，不再占用SysTick
+  */
+void Sched_Init(void)
+{
+	SysTick_Config(SystemCoreClock / 1000);
+}
+
+/**
+  * @brief  当前节拍数
+  * @param  无
+  * @retval 上电以来的毫秒数
+  */
+uint32_t Sched_Now(void)
+{
+	return sched_tick;
+}
+
+/**
+  * @brief  节拍递增（SysTick_Handler 中调用）
+  * @param  无
+  * @retval 无
+  */
+void Sched_Tick(void)
+{
+	sched_tick++;
+}
+
+/**
+  * @brief  运行一个已释放的任务并记账
+  * @param  task 任务
+  * @param  now 释放判断时的节拍
+  * @retval 无
+  */
+static void Sched_Dispatch(Sched_Task *task, uint32_t now)
+{
+	uint32_t start = DWT_CYCCNT;
+	task->run();
+	uint32_t cycles = DWT_CYCCNT - start;
+
+	task->runs++;
+	task->window_cycles += cycles;
+	if (cycles > task->max_cycles) task->max_cycles = cycles;
+	if ((int32_t)(Sched_Now() - task->release) > task->deadline) task->misses++;
+
+	// 下次释放时刻按周期推进，保持相位；落后超过一个周期时重新对齐，不补执行
+	task->release += task->period;
+	if ((int32_t)(now - task->release) >= 0)
+	{
+		task->release = now + task->period;
+	}
+}
+
+/**
+  * @brief  统计窗口结束：计算主循环负载与各任务占用比例
+  * @param  busy 窗口内任务执行总周期数
+  * @param  window 窗口长度（CPU周期）
+  * @retval 无
+  */
+static void Sched_Close_Window(uint32_t busy, uint32_t window)
+{
+	uint32_t unit = window / 1000;
+	if (unit == 0) return;
+
+	sched_load = busy / unit;
+	for (uint8_t i = 0; i < sched_count; i++)
+	{
+		sched_tasks[i].share = sched_tasks[i].window_cycles / unit;
+		sched_tasks[i].window_cycles = 0;
+	}
+}
+
+/**
+  * @brief  进入调度循环（不返回）
+  * @param  tasks 任务表，数组顺序即优先级
+  * @param  count 任务数
+  * @retval 无
+  * @note   每轮从最高优先级任务开始检查，执行一个任务后重新检查，
+  *         保证高优先级任务不会被低优先级任务连续占用
+  */
+void Sched_Run(Sched_Task *tasks, uint8_t count)
+{
+	sched_tasks = tasks;
+	sched_count = count;
+
+	uint32_t now = Sched_Now();
+	for (uint8_t i = 0; i < count; i++)
+	{
+		tasks[i].release = now;
+	}
+
+	uint32_t window_start = DWT_CYCCNT;
+	uint32_t window_tick = now;
+	uint32_t busy = 0;
+
+	while (1)
+	{
+		uint8_t ran = 0;
+		now = Sched_Now();
+
+		for (uint8_t i = 0; i < count; i++)
+		{
+			if ((int32_t)(now - tasks[i].release) >= 0)
+			{
+				uint32_t start = DWT_CYCCNT;
+				Sched_Dispatch(&tasks[i], now);
+				busy += DWT_CYCCNT - start;
+				ran = 1;
+				break;
+			}
+		}
+
+		if (now - window_tick >= SCHED_WINDOW_MS)
+		{
+			uint32_t end = DWT_CYCCNT;
+			Sched_Close_Window(busy, end - window_start);
+			window_start = end;
+			window_tick = now;
+			busy = 0;
+		}
+
+		if (!ran)
+		{
+			CPULOAD_ENTER(CPU_CTX_IDLE);
+			__WFI();		// 等待下一个中断（至少1ms内有SysTick）
+			CPULOAD_EXIT();
+		}
+	}
+}
+
+/**
+  * @brief  主循环负载
+  * @param  无
+  * @retval 上一统计窗口内任务执行时间占比（‰），其余为休眠及中断时间
+  */
+uint16_t Sched_Get_Load(void)
+{
+	return sched_load;
+}
+
+/**
+  * @brief  全部任务累计超时次数
+  * @param  无
+  * @retval 超时次数之和
+  */
+uint32_t Sched_Get_Misses(void)
+{
+	uint32_t total = 0;
+	for (uint8_t i = 0; i < sched_count; i++)
+	{
+		total += sched_tasks[i].misses;
+	}
+	return total;
+}
+
+void Sched_Request_Report(void)
+{
+	sched_report = 1;
+}
+
+/**
+  * @brief  输出任务统计（在任务中调用）
+  * @param  无
+  * @retval 无
+  * @note   格式：task,<名称>,<周期>,<期限>,<次数>,<最长周期数>,<占用‰>,<超时次数>
+  *               task,load,<主循环负载‰>
+  */
+void Sched_PollReport(void)
+{
+	if (!sched_report)
+		return;
+	sched_report = 0;
+
+	for (uint8_t i = 0; i < sched_count; i++)
+	{
+		const Sched_Task *t = &sched_tasks[i];
+		printf("task,%s,%u,%u,%lu,%lu,%u,%lu\n", t->name, t->period, t->deadline,
+		       (unsigned long)t->runs, (unsigned long)t->max_cycles, t->share, (unsigned long)t->misses);
+	}
+	printf("task,load,%u\n", sched_load);
+}
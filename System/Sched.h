@@ -0,0 +1,46 @@
+#ifndef __SCHED_H
+#define __SCHED_H
+
+#include "stm32f10x.h"
+
+/* ==========================================================
+ * 主循环协作式调度器接口说明
+ *
+ * SysTick 提供1ms节拍，主循环按静态任务表（数组顺序即优先级）
+ * 依周期释放任务，任务须执行完即返回、不得阻塞等待。
+ * 无就绪任务时 __WFI 休眠，由下一个中断唤醒。
+ *
+ * - Sched_Init()                  配置 SysTick 1ms 节拍
+ * - Sched_Now()                   当前节拍数（ms）
+ * - Sched_Tick()                  SysTick_Handler 中调用
+ * - Sched_Run(tasks, count)       进入调度循环，不返回
+ * - Sched_Get_Load()              最近1秒主循环忙碌比例（‰）
+ * - Sched_Get_Misses()            全部任务累计超时次数
+ * - Sched_Request_Report()        请求输出任务统计
+ * - Sched_PollReport()            有报告请求时输出（在任务中调用）
+ * ========================================================== */
+
+typedef struct
+{
+	const char *name;
+	uint16_t period;		// 周期（ms）
+	uint16_t deadline;		// 相对释放时刻的完成期限（ms）
+	void (*run)(void);
+	uint32_t release;		// 下次释放时刻（节拍）
+	uint32_t runs;			// 执行次数
+	uint32_t misses;		// 超过期限次数
+	uint32_t max_cycles;	// 单次最长执行时间（CPU周期）
+	uint32_t window_cycles;	// 当前统计窗口内累计执行时间
+	uint16_t share;			// 上一窗口占用比例（‰）
+} Sched_Task;
+
+void Sched_Init(void);
+uint32_t Sched_Now(void);
+void Sched_Tick(void);
+void Sched_Run(Sched_Task *tasks, uint8_t count);
+uint16_t Sched_Get_Load(void);
+uint32_t Sched_Get_Misses(void);
+void Sched_Request_Report(void);
+void Sched_PollReport(void);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef __TRIG_H
+#define __TRIG_H
+
+#include <stdint.h>
+
+/* 定点正弦/余弦（查表 + 线性插值）
+ * 角度为 32 位二进制角：2^32 对应一整圈，加减法自然回绕，不需要取模；
+ * 结果为 Q15（±32768 对应 ±1.0），最大误差约 1 LSB。
+ * 表只存 0~90° 的 257 个点（Flash 约 0.5KB），其余象限按对称关系得到。
+ * 只依赖 stdint.h，上位机工具（Tools/odom_check.c）直接编译同一份源码。 */
+
+#define TRIG_ANGLE_90		0x40000000UL	// 90° 的二进制角
+
+int32_t Trig_Sin_Q15(uint32_t angle);
+int32_t Trig_Cos_Q15(uint32_t angle);
+
+#endif
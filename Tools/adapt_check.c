@@ -0,0 +1,235 @@
+/* ==========================================================
+ * 在线自适应（RLS + 极点配置）校验工具（上位机，Linux）
+ *
+ * 直接编译固件中的 Hardware/Adaptive.c 与 Hardware/PID.c，对象为直流电机
+ * 一阶模型（可加负载力矩），编码器按整数脉冲计数，测速与固件
+ * Encoder_Get_Speed 相同（每ms脉冲数×1.85），指令在下一周期内生效
+ * （10kHz 内环输出）。Defer 由本文件提供，Defer_Post 立即执行处理函数
+ * （固件中为同一控制中断退出后的 PendSV）。目标在 20/40 之间每 500ms
+ * 切换一次：
+ *   收敛     以对象真实 a、b 与所施加增益求闭环特征根，最慢根对应的
+ *            时间常数与按真实 a、b 极点配置（含固件增益限幅）的结果
+ *            相差不超过 ±30%
+ *   不漂移   目标保持不变 60 秒，增益变化不超过 10%
+ *   跟踪     保持段末 500ms 平均误差
+ *   负载     保持中突加负载力矩：速度跌落后回到 ±2 以内，之后切换激励下
+ *            增益仍满足收敛条件
+ *   惯量     切换激励中对象时间常数加倍（惯量加倍）后重新收敛
+ *   增益     切换激励中对象增益减半（b 减半）后重新收敛（增益加倍，可能触及限幅）
+ *
+ * 编译：gcc -O2 -Ihost -I../Hardware -o adapt_check adapt_check.c ../Hardware/Adaptive.c ../Hardware/PID.c -lm
+ * 用法：adapt_check [-k 稳态增益(脉冲/ms每单位指令)] [-t 时间常数ms] [-c 期望闭环时间常数ms]
+ *       期望闭环时间常数须小于对象时间常数（极点配置的适用范围）
+ *       -k、-t 可直接取 sysid_fit 输出的 plant 行
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <complex.h>
+#include <unistd.h>
+#include "Adaptive.h"
+#include "PID.h"
+#include "Defer.h"
+#include "GainSched.h"
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-66s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+/* ---------------- 固件接口替身 ---------------- */
+
+static void (*defer_handler[DEFER_MAX])(void);
+
+void Defer_Register(uint8_t id, void (*handler)(void))
+{
+    if (id < DEFER_MAX) defer_handler[id] = handler;
+}
+
+void Defer_Post(uint8_t id)
+{
+    if (id < DEFER_MAX && defer_handler[id]) defer_handler[id]();
+}
+
+/* 调度表不参与仿真 */
+void GainSched_Invalidate(void)
+{
+}
+
+/* ---------------- 对象模型 ---------------- */
+
+typedef struct
+{
+    double gain;            // 稳态速度 / 指令（脉冲/ms 每单位指令）
+    double tau_ms;
+    double load;            // 负载力矩（折算为指令单位）
+    double w;               // 速度（脉冲/ms）
+    double pos;
+    int32_t prev_count;
+    int16_t v;              // 最近一次测速值
+} Plant;
+
+/* 以指令 u 推进1ms，返回固件测速值 */
+static int16_t plant_step(Plant *m, int16_t u)
+{
+    const int sub = 10;
+    for (int i = 0; i < sub; i++)
+    {
+        m->w += (m->gain * (u - m->load) - m->w) / m->tau_ms / sub;
+        m->pos += m->w / sub;
+    }
+    int32_t count = (int32_t)floor(m->pos);
+    int16_t delta = (int16_t)(count - m->prev_count);
+    m->prev_count = count;
+    m->v = (int16_t)(delta * 1.85f);
+    return m->v;
+}
+
+/* 对象按固件测速单位的离散参数：v[k] = a·v[k-1] + b·u[k-1] */
+static void plant_ab(const Plant *m, double *a, double *b)
+{
+    *a = exp(-1.0 / m->tau_ms);
+    *b = (1 - *a) * m->gain * 1.85;
+}
+
+/* 增益 kp、ki 下闭环最慢特征根对应的时间常数（ms），不稳定返回 -1 */
+static double closed_loop_tc(const Plant *m, double kp, double ki)
+{
+    double a, b;
+    plant_ab(m, &a, &b);
+    // z² + (b(Kp+Ki) - 1 - a) z + (a - b·Kp)
+    double c1 = b * (kp + ki) - 1 - a, c0 = a - b * kp;
+    double complex d = csqrt(c1 * c1 - 4 * c0);
+    double r = fmax(cabs((-c1 + d) / 2), cabs((-c1 - d) / 2));
+    return r < 1 ? -1 / log(r) : -1;
+}
+
+/* 按对象真实 a、b 做与 Adaptive.c 相同的极点配置与限幅，返回闭环时间常数 */
+static double expected_tc(const Plant *m, int tcl)
+{
+    double a, b, p = exp(-1.0 / tcl);
+    plant_ab(m, &a, &b);
+    double kp = (a - p * p) / b;
+    double ki = (1 + a - 2 * p) / b - kp;
+    if (kp > 50) kp = 50;
+    if (ki < 0) ki = 0;
+    if (ki > 20) ki = 20;
+    return closed_loop_tc(m, kp, ki);
+}
+
+static float pid_kp, pid_ki, pid_kd;
+
+/* 读取固件当前增益 */
+static void gains(void)
+{
+    Speed_PID_GetParams(&pid_kp, &pid_ki, &pid_kd);
+}
+
+/* 运行 ms 毫秒，toggle 非0时目标每 500ms 在 20/40 间切换；返回末 500ms 平均误差。
+ * settle 非空时记录误差最后一次超出 ±2 之后的时刻（ms），peak 记录最大误差 */
+static double run_ex(Plant *m, long ms, int toggle, int16_t hold, long *settle, int *peak)
+{
+    static long t_global;
+    double err_sum = 0;
+
+    for (long t = 0; t < ms; t++, t_global++)
+    {
+        int16_t target = toggle ? ((t_global / 500) & 1 ? 40 : 20) : hold;
+        int16_t u = Speed_PID_Compute(target, m->v);
+        Adaptive_Tick(m->v, u);
+        plant_step(m, u);
+        int err = target - m->v;
+        if (t >= ms - 500) err_sum += err;
+        if (settle && abs(err) > 2) *settle = t + 1;
+        if (peak && abs(err) > *peak) *peak = abs(err);
+    }
+    gains();
+    return err_sum / 500;
+}
+
+static double run(Plant *m, long ms, int toggle, int16_t hold)
+{
+    return run_ex(m, ms, toggle, hold, NULL, NULL);
+}
+
+/* 切换激励 ms 毫秒后检查收敛 */
+static void check_converged(Plant *m, long ms, int tcl, const char *name)
+{
+    char what[128];
+    run(m, ms, 1, 0);
+    double tc = closed_loop_tc(m, pid_kp, pid_ki);
+    double expect = expected_tc(m, tcl);
+    snprintf(what, sizeof(what), "%s: Kp %.2f, Ki %.3f, closed-loop tc %.1f ms (expect %.1f)",
+             name, pid_kp, pid_ki, tc, expect);
+    check(tc > 0 && fabs(tc / expect - 1) <= 0.3, what);
+}
+
+int main(int argc, char **argv)
+{
+    Plant m = { 0.06, 30, 0, 0, 0, 0, 0 };
+    int tcl = 20, opt;
+    char what[128];
+
+    while ((opt = getopt(argc, argv, "k:t:c:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'k': m.gain = atof(optarg); break;
+            case 't': m.tau_ms = atof(optarg); break;
+            case 'c': tcl = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: adapt_check [-k gain] [-t tau_ms] [-c tcl_ms]\n");
+                return 2;
+        }
+    }
+    if (m.gain <= 0 || m.tau_ms < 2 || tcl < 2 || tcl >= m.tau_ms)
+    {
+        fprintf(stderr, "adapt_check: gain > 0, tau >= 2 ms, 2 <= tcl < tau\n");
+        return 2;
+    }
+
+    double a, b;
+    plant_ab(&m, &a, &b);
+    printf("plant: gain %.3f counts/ms per unit, tau %.0f ms (a %.4f, b %.5f), Tcl %d ms\n",
+           m.gain, m.tau_ms, a, b, tcl);
+
+    /* 从固件默认增益开始，20 秒方波激励后收敛 */
+    Adaptive_Enable(1, (uint16_t)tcl, 0);
+    check_converged(&m, 20000, tcl, "converge");
+
+    /* 不漂移：目标保持 40，60 秒 */
+    float kp0 = pid_kp, ki0 = pid_ki;
+    double ss = run(&m, 60000, 0, 40);
+    snprintf(what, sizeof(what), "hold 60 s: Kp %.2f -> %.2f, Ki %.3f -> %.3f", kp0, pid_kp, ki0, pid_ki);
+    check(fabs(pid_kp / kp0 - 1) <= 0.1 && fabs(pid_ki / ki0 - 1) <= 0.1, what);
+    snprintf(what, sizeof(what), "  tracking error at 40: %.2f", ss);
+    check(fabs(ss) < 1.0, what);
+
+    /* 负载力矩阶跃：保持 40 时突加，取该速度所需指令的一半，且总指令不超过输出限幅 */
+    long settle = 0;
+    int peak = 0;
+    double u40 = 40 / (m.gain * 1.85);
+    m.load = fmin(u40 / 2, (SPEED_PID_OUT_MAX - u40) / 2);
+    ss = run_ex(&m, 2000, 0, 40, &settle, &peak);
+    snprintf(what, sizeof(what), "load step %.0f: speed dip %d, back within 2 after %ld ms", m.load, peak, settle);
+    check(peak > 0 && settle <= 500 && fabs(ss) < 1.0, what);
+    check_converged(&m, 20000, tcl, "  with load");
+    m.load = 0;
+
+    /* 惯量阶跃：时间常数加倍 */
+    m.tau_ms *= 2;
+    check_converged(&m, 20000, tcl, "tau doubled");
+    m.tau_ms /= 2;
+
+    /* 对象增益减半：重新收敛 */
+    m.gain /= 2;
+    check_converged(&m, 20000, tcl, "gain halved");
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,302 @@
+/* ==========================================================
+ * 波特率协商状态机测试（上位机，Linux）
+ *
+ * 直接编译固件的 Hardware/Baud.c 与 System/Fmt.c，以一对伪终端(pty)
+ * 作为串口：从端是下位机替身（实现 Baud_Port_* 接口、解析 @baud%
+ * 命令，每1ms收一次数据、每10ms调用一次 Baud_Poll，与固件一致），
+ * 主端是上位机一侧的协商流程。按1ms步进模拟时间。
+ *
+ * pty 本身不区分速率，收发双方速率不一致时由发送方把字节替换成
+ * 0xFF（相当于线路上的乱码），下位机收到计为帧错误。
+ *
+ * 编译：gcc -O2 -I../Hardware -I../System -o baud_pty baud_pty.c ../Hardware/Baud.c ../System/Fmt.c
+ * 用法：baud_pty [-v]     -v 打印双方收发的每一行
+ *
+ * 场景：正常协商、不支持的速率、上位机未确认（超时切回）、
+ *       高速下线路噪声（错误率回退，上位机静默超时后同样回退）
+ * ========================================================== */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Baud.h"
+#include "Fmt.h"
+
+#define HOST_OFFER_MS       100     // 上位机等待 offer 的时间
+#define HOST_SILENCE_MS     1500    // 上位机收不到有效行即回退默认速率
+
+static int fd_host, fd_dev;
+static uint32_t now_ms = 0;
+static uint32_t dev_rate = BAUD_DEFAULT, host_rate = BAUD_DEFAULT;
+static uint32_t dev_errors = 0;
+static uint32_t host_last_valid = 0;
+static int verbose = 0;
+
+static char host_line[128];
+static int host_line_ready = 0;
+
+/* ---------------- 线路 ---------------- */
+
+static void wire_write(int fd, const char *data, size_t len, uint32_t from_rate, uint32_t to_rate)
+{
+    char buf[256];
+    if (len > sizeof(buf)) len = sizeof(buf);
+    for (size_t i = 0; i < len; i++)
+    {
+        buf[i] = (from_rate == to_rate) ? data[i] : (char)0xFF;
+    }
+    if (write(fd, buf, len) != (ssize_t)len)
+    {
+        perror("write");
+        exit(2);
+    }
+}
+
+/* ---------------- 下位机替身 ---------------- */
+
+void Baud_Port_Apply(uint32_t baud)
+{
+    dev_rate = baud;
+}
+
+uint8_t Baud_Port_Tx_Idle(void)
+{
+    return 1;       // pty 写入即完成
+}
+
+uint32_t Baud_Port_Errors(void)
+{
+    return dev_errors;
+}
+
+void Baud_Port_Hold_Telemetry(uint8_t hold)
+{
+    (void)hold;     // 替身不输出遥测
+}
+
+void Baud_Port_Reply(const char *line)
+{
+    if (verbose) printf("  %6u dev  -> %s", now_ms, line);
+    wire_write(fd_dev, line, strlen(line), dev_rate, host_rate);
+}
+
+static void dev_command(const char *cmd)
+{
+    const char *arg;
+    int32_t rate;
+
+    if (!Fmt_Match(cmd, "@baud%"))
+        return;
+    arg = cmd + 6;
+    if (*arg == '?')
+        Baud_Request_Report();
+    else if (Fmt_Match(arg, "ok"))
+        Baud_Confirm();
+    else if (Fmt_Parse_Int(&arg, 1, INT32_MAX, &rate) != FMT_OK || !Baud_Request(rate))
+        Baud_Port_Reply("err,@baud%,2\n");      // 与 Serial_Reject 相同
+}
+
+static void dev_step(void)
+{
+    static char line[64];
+    static int n = 0;
+    char c;
+
+    while (read(fd_dev, &c, 1) == 1)
+    {
+        if ((unsigned char)c == 0xFF)
+        {
+            dev_errors++;           // 乱码按帧错误计
+            n = 0;
+        }
+        else if (c == '\n')
+        {
+            line[n] = '\0';
+            if (verbose) printf("  %6u dev  <- %s\n", now_ms, line);
+            dev_command(line);
+            n = 0;
+        }
+        else if (n < (int)sizeof(line) - 1)
+        {
+            line[n++] = c;
+        }
+    }
+    if (now_ms % 10 == 0)
+    {
+        Baud_Poll(now_ms);      // 与固件 Task_Command 周期一致
+    }
+}
+
+/* ---------------- 上位机 ---------------- */
+
+static void host_send(const char *line)
+{
+    if (verbose) printf("  %6u host -> %s", now_ms, line);
+    wire_write(fd_host, line, strlen(line), host_rate, dev_rate);
+}
+
+static void host_step(void)
+{
+    static char line[128];
+    static int n = 0, garbled = 0;
+    char c;
+
+    while (read(fd_host, &c, 1) == 1)
+    {
+        if ((unsigned char)c == 0xFF)
+        {
+            garbled = 1;
+        }
+        else if (c == '\n')
+        {
+            line[n] = '\0';
+            if (!garbled)
+            {
+                if (verbose) printf("  %6u host <- %s\n", now_ms, line);
+                strcpy(host_line, line);
+                host_line_ready = 1;
+                host_last_valid = now_ms;
+            }
+            n = 0;
+            garbled = 0;
+        }
+        else if (n < (int)sizeof(line) - 1)
+        {
+            line[n++] = c;
+        }
+    }
+}
+
+/* 推进时间直到上位机收到以 prefix 开头的行，或超时；返回1表示收到 */
+static int run_until(const char *prefix, uint32_t timeout_ms)
+{
+    uint32_t end = now_ms + timeout_ms;
+    while (now_ms < end)
+    {
+        now_ms++;
+        dev_step();
+        host_step();
+        if (host_line_ready)
+        {
+            host_line_ready = 0;
+            if (prefix && strncmp(host_line, prefix, strlen(prefix)) == 0)
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/* 上位机协商流程；confirm 为0时模拟上位机收到 offer 后未切换 */
+static int host_negotiate(uint32_t rate, int confirm)
+{
+    char cmd[32], expect[32];
+    uint32_t old = host_rate;
+
+    snprintf(cmd, sizeof(cmd), "@baud%%%u\n", rate);
+    snprintf(expect, sizeof(expect), "baud,offer,%u", rate);
+    host_send(cmd);
+    if (!run_until(expect, HOST_OFFER_MS))
+        return 0;
+    if (!confirm)
+        return 0;
+
+    host_rate = rate;
+    run_until(NULL, BAUD_GUARD_MS);
+    host_send("@baud%ok\n");
+    snprintf(expect, sizeof(expect), "baud,ok,%u", rate);
+    if (run_until(expect, BAUD_CONFIRM_MS))
+        return 1;
+    host_rate = old;        // 未收到确认，切回原速率
+    return 0;
+}
+
+/* 上位机静默回退：长时间收不到有效行时切回默认速率 */
+static void host_watchdog_run(uint32_t duration_ms)
+{
+    uint32_t end = now_ms + duration_ms;
+    while (now_ms < end)
+    {
+        if (now_ms % 200 == 0) host_send("@baud%?\n");
+        run_until(NULL, 1);
+        if (host_rate != BAUD_DEFAULT && now_ms - host_last_valid > HOST_SILENCE_MS)
+        {
+            if (verbose) printf("  %6u host: silent, back to %u\n", now_ms, BAUD_DEFAULT);
+            host_rate = BAUD_DEFAULT;
+            host_last_valid = now_ms;
+        }
+    }
+}
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-52s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "-v") == 0) verbose = 1;
+
+    fd_host = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd_host < 0 || grantpt(fd_host) || unlockpt(fd_host))
+    {
+        perror("posix_openpt");
+        return 2;
+    }
+    fd_dev = open(ptsname(fd_host), O_RDWR | O_NOCTTY);
+    if (fd_dev < 0)
+    {
+        perror("open slave");
+        return 2;
+    }
+    struct termios t;
+    tcgetattr(fd_dev, &t);
+    cfmakeraw(&t);
+    tcsetattr(fd_dev, TCSANOW, &t);
+    fcntl(fd_host, F_SETFL, O_NONBLOCK);
+    fcntl(fd_dev, F_SETFL, O_NONBLOCK);
+
+    // 1. 正常协商
+    check(host_negotiate(921600, 1), "negotiate 921600");
+    check(dev_rate == 921600 && host_rate == 921600, "  both sides at 921600");
+    host_send("@baud%?\n");
+    check(run_until("baud,rate,921600", 50), "  query at new rate");
+
+    // 2. 不支持的速率
+    host_send("@baud%57600\n");
+    check(run_until("err,@baud%,2", 50), "reject unsupported 57600");
+    check(dev_rate == 921600, "  rate unchanged");
+
+    // 3. 上位机未确认：下位机超时切回原速率
+    check(!host_negotiate(2000000, 0), "unconfirmed switch to 2000000");
+    check(run_until("baud,revert,921600", BAUD_CONFIRM_MS + 50), "  device reverts after timeout");
+    check(dev_rate == 921600, "  device back at 921600");
+
+    // 4. 高速下线路噪声：错误率超限回退，上位机静默后回退
+    check(host_negotiate(2000000, 1), "negotiate 2000000");
+    uint32_t end = now_ms + 2 * BAUD_WINDOW_MS;
+    while (now_ms < end && dev_rate != BAUD_DEFAULT)
+    {
+        if (now_ms % 50 == 0)
+        {
+            char noise = (char)0xFF;
+            if (write(fd_host, &noise, 1) != 1) return 2;
+        }
+        run_until(NULL, 1);
+    }
+    check(dev_rate == BAUD_DEFAULT, "  device falls back on error rate");
+    host_watchdog_run(HOST_SILENCE_MS + 500);
+    check(host_rate == BAUD_DEFAULT, "  host falls back after silence");
+    host_send("@baud%?\n");
+    check(run_until("baud,rate,115200", 50), "  link restored at 115200");
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
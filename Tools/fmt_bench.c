@@ -0,0 +1,205 @@
+/* ==========================================================
+ * 整数格式化/解析库校验与基准测试（上位机，Linux）
+ *
+ * 直接编译固件中的 System/Fmt.c，逐项与 C 库结果比对，再对比
+ * 三条热路径的耗时：
+ *   遥测帧     printf("%d,%d\n")      ↔ Fmt_Int 拼帧
+ *   命令参数   atoi / strtol           ↔ Fmt_Parse_Int
+ *   OLED数字   OLED_Pow 逐位除法       ↔ Fmt_Uint_Fixed
+ *
+ * 编译：gcc -O2 -I../System -o fmt_bench fmt_bench.c ../System/Fmt.c
+ * 用法：fmt_bench [-n 次数]
+ *
+ * 主机上只能比较相对耗时；Flash 占用以 Keil 链接 map 的
+ * "Image component sizes" 为准：比较改动前后 main.o/Serial.o/OLED.o
+ * 及 microlib 中 _printf_*、atoi、strtol 各项，或直接比较 @mem%? 的
+ * mem,flash 一行。
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "Fmt.h"
+
+static volatile uint32_t sink;      // 防止被优化掉
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t rng_state = 0x2545F491;
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// 原 OLED.c 的逐位算法
+static uint32_t old_pow(uint32_t x, uint32_t y)
+{
+    uint32_t r = 1;
+    while (y--) r *= x;
+    return r;
+}
+
+static void old_fixed(char *buf, uint32_t n, uint8_t len)
+{
+    for (uint8_t i = 0; i < len; i++)
+        buf[i] = n / old_pow(10, len - i - 1) % 10 + '0';
+}
+
+static int check(void)
+{
+    static const int32_t edges[] = { 0, 1, -1, 9, 10, -10, 99, 100, 32767, -32768,
+                                     2147483647, -2147483647 - 1, 1000000000, -999999999 };
+    char a[32], b[32];
+    int errors = 0;
+
+    for (int i = 0; i < 1000000; i++)
+    {
+        int32_t v = i < (int)(sizeof(edges) / sizeof(edges[0])) ? edges[i] : (int32_t)rng();
+        if (i & 1) v >>= rng() & 31;
+
+        // 格式化
+        Fmt_Int(a, v);
+        snprintf(b, sizeof(b), "%d", v);
+        if (strcmp(a, b) != 0)
+        {
+            printf("Fmt_Int(%d) = %s\n", v, a);
+            errors++;
+        }
+
+        // 解析往返与范围检查
+        const char *p = b;
+        int32_t parsed;
+        if (Fmt_Parse_Int(&p, INT32_MIN, INT32_MAX, &parsed) != FMT_OK || parsed != v || *p)
+        {
+            printf("Fmt_Parse_Int(%s) failed\n", b);
+            errors++;
+        }
+        p = b;
+        uint8_t st = Fmt_Parse_Int(&p, -32768, 32767, &parsed);
+        if ((v >= -32768 && v <= 32767) != (st == FMT_OK))
+        {
+            printf("range check %d -> %u\n", v, st);
+            errors++;
+        }
+
+        // 定长格式化与原OLED算法一致
+        uint8_t width = 1 + rng() % 10;
+        Fmt_Uint_Fixed(a, (uint32_t)v, width);
+        old_fixed(b, (uint32_t)v, width);
+        if (memcmp(a, b, width) != 0)
+        {
+            printf("Fmt_Uint_Fixed(%u,%u) mismatch\n", (uint32_t)v, width);
+            errors++;
+        }
+
+        Fmt_Hex_Fixed(a, (uint32_t)v, 8);
+        snprintf(b, sizeof(b), "%08X", (uint32_t)v);
+        if (memcmp(a, b, 8) != 0)
+        {
+            printf("Fmt_Hex_Fixed(%08X) = %.8s\n", (uint32_t)v, a);
+            errors++;
+        }
+        if (errors > 10) break;
+    }
+
+    // 溢出与空输入
+    static const char *bad[] = { "2147483648", "-2147483649", "99999999999", "", "-", "x1" };
+    for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        const char *p = bad[i];
+        int32_t v;
+        if (Fmt_Parse_Int(&p, INT32_MIN, INT32_MAX, &v) == FMT_OK)
+        {
+            printf("Fmt_Parse_Int(\"%s\") accepted %d\n", bad[i], v);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    long n = 2000000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:")) != -1)
+    {
+        if (opt == 'n') n = atol(optarg);
+    }
+
+    int errors = check();
+    printf("check: %s\n\n", errors ? "FAILED" : "ok");
+
+    static int16_t speeds[1024];
+    static char args[1024][8];
+    static uint32_t nums[1024];
+    for (int i = 0; i < 1024; i++)
+    {
+        speeds[i] = (int16_t)rng();
+        snprintf(args[i], sizeof(args[i]), "%d", (int16_t)rng());
+        nums[i] = rng() % 10000;
+    }
+
+    char line[32];
+    double t0, t_old, t_new;
+
+    t0 = now_ns();
+    for (long i = 0; i < n; i++)
+        sink += snprintf(line, sizeof(line), "%d,%d\n", speeds[i & 1023], speeds[(i + 1) & 1023]);
+    t_old = now_ns() - t0;
+    t0 = now_ns();
+    for (long i = 0; i < n; i++)
+    {
+        uint8_t k = Fmt_Int(line, speeds[i & 1023]);
+        line[k++] = ',';
+        k += Fmt_Int(line + k, speeds[(i + 1) & 1023]);
+        line[k++] = '\n';
+        sink += k;
+    }
+    t_new = now_ns() - t0;
+    printf("%-12s %8.1f ns  ->  %8.1f ns  (x%.1f)\n", "telemetry", t_old / n, t_new / n, t_old / t_new);
+
+    t0 = now_ns();
+    for (long i = 0; i < n; i++)
+        sink += atoi(args[i & 1023]);
+    t_old = now_ns() - t0;
+    t0 = now_ns();
+    for (long i = 0; i < n; i++)
+    {
+        const char *p = args[i & 1023];
+        int32_t v;
+        Fmt_Parse_Int(&p, INT16_MIN, INT16_MAX, &v);
+        sink += v;
+    }
+    t_new = now_ns() - t0;
+    printf("%-12s %8.1f ns  ->  %8.1f ns  (x%.1f)\n", "parse", t_old / n, t_new / n, t_old / t_new);
+
+    t0 = now_ns();
+    for (long i = 0; i < n; i++)
+    {
+        old_fixed(line, nums[i & 1023], 4);
+        sink += line[0];
+    }
+    t_old = now_ns() - t0;
+    t0 = now_ns();
+    for (long i = 0; i < n; i++)
+    {
+        Fmt_Uint_Fixed(line, nums[i & 1023], 4);
+        sink += line[0];
+    }
+    t_new = now_ns() - t0;
+    printf("%-12s %8.1f ns  ->  %8.1f ns  (x%.1f)\n", "oled 4-digit", t_old / n, t_new / n, t_old / t_new);
+
+    return errors ? 1 : 0;
+}
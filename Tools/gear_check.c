@@ -0,0 +1,196 @@
+/* ==========================================================
+ * 电子齿轮/凸轮校验工具（上位机，Linux）
+ *
+ * 直接编译固件中的 Hardware/Gear.c，以位置环周期驱动 Gear_Tick：
+ *   齿轮  主轴随机往复并跨越 32 位回绕，逐周期检查目标恰好等于
+ *         起点 + floor(主轴总位移 × 分子 / 分母)，运行中改比例不跳变
+ *   凸轮  主轴正反转多圈，检查分段点处目标等于表值、每圈恰好附加升程、
+ *         相邻周期目标变化有界（插值连续）
+ *   跟随  从轴模型按速度目标理想运动，检查恒速下的跟随误差
+ *
+ * 编译：gcc -O2 -Ihost -I../Hardware -o gear_check gear_check.c ../Hardware/Gear.c
+ * 用法：gear_check [-n 周期数] [-r 分子:分母]
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "Gear.h"
+#include "Serial.h"
+
+/* 报告前后暂停周期遥测（固件见 Serial.c），上位机无遥测 */
+void Serial_Telemetry_Enable(uint8_t enable)
+{
+    (void)enable;
+}
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-56s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/* 齿轮：target 必须恰好等于 起点 + floor(位移×num/den) */
+static int check_ratio(long ticks, int32_t num, uint16_t den, int32_t master0)
+{
+    int16_t ref;
+    int32_t master = master0, slave = 12345;
+    int64_t moved = 0;
+
+    Gear_Release();
+    Gear_Set_Ratio(num, den);
+    Gear_Tick(master, slave, &ref);
+    for (long i = 0; i < ticks; i++)
+    {
+        int32_t d = rand() % 4001 - 1900;                   // 偏正向，累计跨越回绕
+        master = (int32_t)((uint32_t)master + (uint32_t)d);
+        moved += d;
+        int32_t err = Gear_Tick(master, slave, &ref);
+        int32_t expect = (int32_t)(12345 + floor_div(moved * num, den));
+        if (err + slave != expect)
+        {
+            printf("  tick %ld: target %d, expected %d\n", i, err + slave, expect);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* 运行中改比例：新比例从当前目标接着算，目标不跳变 */
+static int check_ratio_change(void)
+{
+    int16_t ref;
+    int32_t master = 0, t0, t1;
+
+    Gear_Release();
+    Gear_Set_Ratio(37, 12);
+    Gear_Tick(master, 0, &ref);
+    for (int i = 0; i < 100; i++) Gear_Tick(master += 7, 0, &ref);
+    t0 = Gear_Tick(master, 0, &ref);
+    Gear_Set_Ratio(-5, 3);
+    t1 = Gear_Tick(master, 0, &ref);
+    if (t1 != t0)
+        return 0;
+    t1 = Gear_Tick(master += 3, 0, &ref);
+    return t1 == t0 - 5;
+}
+
+/* 凸轮：表值、升程与连续性 */
+static int check_cam(int cubic, long *max_step)
+{
+    static const int32_t table[8] = { 0, 100, 400, 900, 1200, 1300, 1300, 1250 };
+    const uint32_t period = 8000;
+    const int32_t rise = 1000;
+    int16_t ref;
+    int32_t master = -5000000, slave = 777, prev;
+    int64_t moved = 0;
+
+    Gear_Set_Ratio(1, 1);           // 退出凸轮方式才能改表
+    Gear_Release();
+    Gear_Set_Cam_Shape(8, period, rise, cubic);
+    for (int i = 0; i < 8; i++) Gear_Set_Cam_Point(i, table[i]);
+    if (!Gear_Select_Cam() || Gear_Set_Cam_Point(0, 1))
+        return 0;                   // 选用凸轮后不允许改表
+
+    prev = Gear_Tick(master, slave, &ref) + slave;
+    *max_step = 0;
+    for (long i = 0; i < 200000; i++)
+    {
+        int32_t d = (i / 50000) % 2 ? -37 : 41;            // 正反转各若干圈
+        master += d;
+        moved += d;
+        int32_t target = Gear_Tick(master, slave, &ref) + slave;
+        long step = labs((long)target - prev);
+        if (step > *max_step) *max_step = step;
+        prev = target;
+
+        int64_t cycles = floor_div(moved, period);
+        int64_t phase = moved - cycles * period;
+        if (phase % (period / 8) == 0)
+        {
+            int32_t expect = (int32_t)(slave - table[0] + cycles * rise + table[phase / (period / 8)]);
+            if (target != expect)
+            {
+                printf("  tick %ld: phase %lld target %d, expected %d\n", i, (long long)phase, target, expect);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/* 跟随：从轴以速度目标理想运动（速度单位为每ms脉冲数×1.85） */
+static int32_t check_follow(int32_t num, uint16_t den)
+{
+    int16_t ref;
+    int32_t master = 0, max_err = 0;
+    double slave = 0;
+
+    Gear_Release();
+    Gear_Set_Ratio(num, den);
+    for (int i = 0; i < 4000; i++)
+    {
+        master += 60;               // 主轴约 12000 脉冲/s
+        int32_t err = Gear_Tick(master, (int32_t)slave, &ref);
+        slave += ref / 1.85 * GEAR_TICK_MS;
+        if (i > 400 && abs(err) > max_err) max_err = abs(err);
+    }
+    return max_err;
+}
+
+int main(int argc, char **argv)
+{
+    long ticks = 2000000;
+    int num = 37, den = 12, opt;
+    char what[96];
+
+    while ((opt = getopt(argc, argv, "n:r:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': ticks = atol(optarg); break;
+            case 'r':
+                if (sscanf(optarg, "%d:%d", &num, &den) != 2 || den < 1 || den > 65535 ||
+                    abs(num) > GEAR_NUM_MAX)
+                    goto usage;
+                break;
+            default: goto usage;
+        }
+    }
+    srand(1);
+
+    snprintf(what, sizeof(what), "ratio %d:%d, %ld ticks across 32-bit wrap, exact", num, den, ticks);
+    check(check_ratio(ticks, num, den, INT32_MAX - 100000), what);
+    check(check_ratio(ticks / 4, -num, den, INT32_MIN + 100000), "negative ratio across wrap, exact");
+    check(check_ratio(ticks / 4, 1, 65535, 0), "ratio 1:65535, exact");
+    check(check_ratio_change(), "ratio change takes effect without a jump");
+
+    long step;
+    int ok = check_cam(0, &step);
+    snprintf(what, sizeof(what), "linear cam: table points, rise per cycle (max step %ld)", step);
+    check(ok && step < 100, what);
+    ok = check_cam(1, &step);
+    snprintf(what, sizeof(what), "cubic cam: table points, rise per cycle (max step %ld)", step);
+    check(ok && step < 100, what);
+
+    int32_t err = check_follow(num, den);
+    snprintf(what, sizeof(what), "following error at constant speed: %d counts", err);
+    check(err < 64, what);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+
+usage:
+    fprintf(stderr, "usage: gear_check [-n ticks] [-r num:den]\n");
+    return 2;
+}
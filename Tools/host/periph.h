@@ -0,0 +1,86 @@
+/* ==========================================================
+ * 上位机替身：外设寄存器与标准库初始化接口（仅 QEnc.c 所用部分）
+ *
+ * GPIOB->IDR、EXTI->PR 指向由测试程序定义的普通变量，测试程序写
+ * 引脚电平后直接调用中断函数；初始化类库函数为空操作。
+ * 编译时以 -include host/periph.h 强制包含，固件源码无需改动。
+ * ========================================================== */
+
+#ifndef __HOST_PERIPH_H
+#define __HOST_PERIPH_H
+
+#include <stdint.h>
+
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+typedef struct { volatile uint32_t IDR; } GPIO_TypeDef;
+typedef struct { volatile uint32_t PR; } EXTI_TypeDef;
+
+extern GPIO_TypeDef host_gpiob;
+extern EXTI_TypeDef host_exti;
+extern uint32_t SystemCoreClock;
+
+#define GPIOB                       (&host_gpiob)
+#define EXTI                        (&host_exti)
+
+#define RCC_APB2Periph_AFIO         ((uint32_t)0x00000001)
+#define RCC_APB2Periph_GPIOB        ((uint32_t)0x00000008)
+
+#define GPIO_Pin_0                  ((uint16_t)0x0001)
+#define GPIO_Pin_1                  ((uint16_t)0x0002)
+#define GPIO_Pin_10                 ((uint16_t)0x0400)
+#define GPIO_Pin_11                 ((uint16_t)0x0800)
+#define GPIO_Mode_IPU               0x48
+#define GPIO_Speed_50MHz            3
+#define GPIO_PortSourceGPIOB        ((uint8_t)0x01)
+#define GPIO_PinSource0             ((uint8_t)0x00)
+#define GPIO_PinSource1             ((uint8_t)0x01)
+#define GPIO_PinSource10            ((uint8_t)0x0A)
+#define GPIO_PinSource11            ((uint8_t)0x0B)
+
+#define EXTI_Line0                  ((uint32_t)0x00001)
+#define EXTI_Line1                  ((uint32_t)0x00002)
+#define EXTI_Line10                 ((uint32_t)0x00400)
+#define EXTI_Line11                 ((uint32_t)0x00800)
+#define EXTI_Mode_Interrupt         0x00
+#define EXTI_Trigger_Rising_Falling 0x10
+
+#define NVIC_PriorityGroup_2        ((uint32_t)0x500)
+#define EXTI0_IRQn                  6
+#define EXTI1_IRQn                  7
+#define EXTI15_10_IRQn              40
+
+typedef struct
+{
+    uint16_t GPIO_Pin;
+    int GPIO_Speed;
+    int GPIO_Mode;
+} GPIO_InitTypeDef;
+
+typedef struct
+{
+    uint32_t EXTI_Line;
+    int EXTI_Mode;
+    int EXTI_Trigger;
+    FunctionalState EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+typedef struct
+{
+    uint8_t NVIC_IRQChannel;
+    uint8_t NVIC_IRQChannelPreemptionPriority;
+    uint8_t NVIC_IRQChannelSubPriority;
+    FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+static inline void RCC_APB2PeriphClockCmd(uint32_t periph, FunctionalState state) { (void)periph; (void)state; }
+static inline void GPIO_Init(GPIO_TypeDef *gpio, GPIO_InitTypeDef *init) { (void)gpio; (void)init; }
+static inline void GPIO_EXTILineConfig(uint8_t port, uint8_t pin) { (void)port; (void)pin; }
+static inline void EXTI_Init(EXTI_InitTypeDef *init) { (void)init; }
+static inline void NVIC_PriorityGroupConfig(uint32_t group) { (void)group; }
+static inline void NVIC_Init(NVIC_InitTypeDef *init) { (void)init; }
+
+#define __disable_irq()
+#define __enable_irq()
+
+#endif
@@ -0,0 +1,16 @@
+/* ==========================================================
+ * 上位机编译固件模块用的替身头文件
+ *
+ * 只提供纯算法模块（Autotune.c、Adaptive.c、Observer.c、PID.c 等）
+ * 用到的整数类型，不含任何外设定义；用到外设寄存器的模块不能
+ * 以此在上位机编译。使用时 -Ihost 须排在 -I../Hardware 等之前。
+ * ========================================================== */
+
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+#include <stdint.h>
+
+#define __INLINE    inline
+
+#endif
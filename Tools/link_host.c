@@ -0,0 +1,888 @@
+/* ==========================================================
+ * 二进制命令通道上位机（Linux）
+ *
+ * 按 Hardware/Link.h 的协议收发 COBS 帧：会话开始先 SYNC，之后最多
+ * 保持 -w 个未应答请求连续发送；应答超时或收到 NACK SEQ 时从丢失处
+ * 起重发未应答的请求（go-back-N），下位机对重复请求只回复结果不再执行。
+ *
+ * PVT 轨迹点按流量控制发送：在途点数不超过最近一次 ACK 报告的队列剩余
+ * 空间，没有在途请求时每 PVT_POLL_MS 试发一个点取得新的剩余空间；
+ * 收到 NACK BUSY（下位机未执行）时暂停 BUSY_RETRY_MS 后从该请求起重发。
+ *
+ * 编译：gcc -O2 -I../Hardware -I../System -o link_host link_host.c ../Hardware/Link.c \
+ *           ../Hardware/Pvt.c ../System/Cobs.c -lm
+ * 用法：
+ *   link_host -t [-v]                                  自测（见下）
+ *   link_host -d /dev/ttyUSB0 [-b 波特率] [-w 窗口] 命令...
+ *       命令：ping  status  speed=<n>  pid=<p>,<i>,<d>  text=<ASCII命令>
+ *             pvt=<dt>,<位置>,<速度>  pvt（查询队列）
+ *   link_host -d /dev/ttyUSB0 [-b 波特率] [-w 窗口] -s < speeds.txt
+ *       每行一个目标速度，以链路速率连续下发
+ *   link_host -d /dev/ttyUSB0 [-b 波特率] [-w 窗口] -p < points.csv
+ *       每行一个 PVT 点 <dt>,<位置>,<速度>，按队列空间流式下发
+ *
+ * 自测直接编译固件的 Link.c 与 Cobs.c，以一对伪终端作为串口，从端
+ * 为下位机替身（每1ms处理一次收到的字节，与 DMA 空闲线中断相近），
+ * 上位机发送按波特率限速；在线路误码（翻转字节）与应答丢失下检查
+ * 每条命令恰好执行一次且顺序不变、丢失应答后重发的应答仍带原负载，
+ * 并比较窗口为1与窗口为8的吞吐量。
+ * PVT 部分链接固件的 Pvt.c，替身每1ms调用 Pvt_Tick，电机以理想速度环
+ * 跟随速度目标：误码下流式下发整条轨迹不欠载、跟踪误差小、停在终点
+ * PVT_HOLD_TOL 脉冲以内，中途断流时欠载减速停止，短段大位移时速度
+ * 目标饱和而不反号。
+ * ========================================================== */
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include "Link.h"
+#include "Pvt.h"
+#include "Cobs.h"
+
+#define MAX_REQUESTS    4096
+#define RTO_MS          50          // 应答超时
+#define WIRE_LATENCY_MS 1           // 自测模型：USB 串口转换器单向延迟
+#define BUSY_RETRY_MS   10          // NACK BUSY 后暂停时间
+#define PVT_POLL_MS     10          // 队列无空间且无在途请求时试发间隔
+
+typedef struct
+{
+    uint8_t cmd;
+    uint8_t payload[LINK_MAX_PAYLOAD];
+    uint8_t len;
+    // 发送状态
+    uint32_t sent_ms;
+    int sent;
+    int done;                       // 已收到应答
+    int fast;                       // 已因后续应答提前重发过
+    uint8_t status, err;
+    uint8_t reply[LINK_MAX_PAYLOAD];
+    uint8_t reply_len;
+} Request;
+
+static Request reqs[MAX_REQUESTS];
+static int req_count = 0;
+static int base = 0, next = 0;      // 最早未应答、下一个待发送
+static uint8_t seq0 = 0;
+static int window = LINK_WINDOW;
+static int verbose = 0;
+
+static int fd_host = -1;
+static uint32_t now_ms = 0;
+static long baud = 115200;
+
+static double corrupt_p = 0, drop_p = 0;
+static int drop_after = -1;             // 再发出几个应答后丢弃下一个（-1 不丢）
+
+static uint32_t host_retransmits = 0, host_timeouts = 0, host_busy = 0;
+
+// PVT 流量控制：第 pvt_credit_idx 个请求的应答报告队列剩余 pvt_free
+static int pvt_credit_idx = 0;
+static int pvt_free = 1;
+static uint32_t hold_until = 0;         // BUSY 或试发后的暂停截止时刻
+
+static double rnd(void)
+{
+    return rand() / (RAND_MAX + 1.0);
+}
+
+/* ---------------- 线路 ---------------- */
+
+/* 自测时两个方向各有一条延迟线：按波特率逐帧排队发送，发完再经过
+ * WIRE_LATENCY_MS 才送达对端；实际设备时直接写串口 */
+typedef struct
+{
+    uint32_t due;
+    uint8_t len;
+    uint8_t data[COBS_MAX_ENCODED(LINK_MAX_PACKET + 1) + 2];
+} Wire_Chunk;
+
+#define WIRE_DEPTH      64
+static int simulate = 0;
+static int fd_dev = -1;
+static Wire_Chunk wire[2][WIRE_DEPTH];      // 0：上位机→下位机，1：下位机→上位机
+static int wire_head[2], wire_tail[2];
+static double wire_free[2];                 // 该方向线路空闲时刻（ms）
+
+static void wire_write(int dir, const uint8_t *data, int len)
+{
+    int fd = dir ? fd_dev : fd_host;
+
+    if (!simulate)
+    {
+        if (write(fd, data, len) != len)
+        {
+            perror("write");
+            exit(2);
+        }
+        return;
+    }
+    if ((wire_head[dir] + 1) % WIRE_DEPTH == wire_tail[dir])
+        return;             // 发送缓冲满，等同丢弃
+    double start = wire_free[dir] > now_ms ? wire_free[dir] : now_ms;
+    wire_free[dir] = start + len * 10000.0 / baud;
+    Wire_Chunk *c = &wire[dir][wire_head[dir]];
+    c->due = (uint32_t)(wire_free[dir] + 0.999) + WIRE_LATENCY_MS;
+    c->len = len;
+    memcpy(c->data, data, len);
+    wire_head[dir] = (wire_head[dir] + 1) % WIRE_DEPTH;
+}
+
+static void wire_deliver(void)
+{
+    for (int dir = 0; dir < 2; dir++)
+    {
+        int fd = dir ? fd_dev : fd_host;
+        while (wire_tail[dir] != wire_head[dir] && wire[dir][wire_tail[dir]].due <= now_ms)
+        {
+            Wire_Chunk *c = &wire[dir][wire_tail[dir]];
+            if (write(fd, c->data, c->len) != c->len)
+            {
+                perror("write");
+                exit(2);
+            }
+            wire_tail[dir] = (wire_tail[dir] + 1) % WIRE_DEPTH;
+        }
+    }
+}
+
+/* ---------------- 上位机发送/接收 ---------------- */
+
+static void add_request(uint8_t cmd, const void *payload, uint8_t len)
+{
+    if (req_count >= MAX_REQUESTS)
+        return;
+    Request *r = &reqs[req_count++];
+    memset(r, 0, sizeof(*r));
+    r->cmd = cmd;
+    memcpy(r->payload, payload, len);
+    r->len = len;
+}
+
+static int build_frame(int idx, uint8_t *frame)
+{
+    uint8_t pkt[LINK_MAX_PACKET];
+    const Request *r = &reqs[idx];
+    int n = 0;
+
+    pkt[n++] = (uint8_t)(seq0 + idx);
+    pkt[n++] = r->cmd;
+    memcpy(pkt + n, r->payload, r->len);
+    n += r->len;
+    uint16_t crc = Cobs_Crc16(pkt, n);
+    pkt[n++] = crc & 0xFF;
+    pkt[n++] = crc >> 8;
+
+    frame[0] = 0;
+    int m = 1 + Cobs_Encode(pkt, n, frame + 1);
+    frame[m++] = 0;
+    return m;
+}
+
+/* 发送第 idx 个请求 */
+static void send_request(int idx)
+{
+    uint8_t frame[COBS_MAX_ENCODED(LINK_MAX_PACKET) + 2];
+    int m = build_frame(idx, frame);
+
+    if (corrupt_p > 0 && rnd() < corrupt_p)
+    {
+        frame[1 + rand() % (m - 2)] ^= 1 + rand() % 255;     // 线路误码
+    }
+    wire_write(0, frame, m);
+    if (reqs[idx].sent) host_retransmits++;
+    reqs[idx].sent = 1;
+    reqs[idx].sent_ms = now_ms;
+}
+
+static int seq_to_index(uint8_t seq)
+{
+    int d = (uint8_t)(seq - (uint8_t)(seq0 + base));
+    return d < next - base ? base + d : -1;
+}
+
+/* 从 idx 起重发：下一次 host_pump 从这里继续 */
+static void go_back(int idx)
+{
+    if (idx < next)
+        next = idx;
+}
+
+static void on_response(const uint8_t *pkt, int n)
+{
+    if (n < 5 || Cobs_Crc16(pkt, n - 2) != (pkt[n - 2] | pkt[n - 1] << 8))
+        return;
+    int idx = seq_to_index(pkt[0]);
+    if (idx < 0)
+        return;
+    Request *r = &reqs[idx];
+    if (pkt[2] != r->cmd)
+        return;
+
+    if (pkt[1] == LINK_NACK && n >= 6 && pkt[3] == LINK_ERR_CRC)
+        return;         // 请求在线路上损坏，等后续 NACK SEQ 或超时重发
+    if (pkt[1] == LINK_NACK && n >= 6 && pkt[3] == LINK_ERR_BUSY)
+    {
+        // 未执行：稍后从这里重发
+        host_busy++;
+        go_back(idx);
+        hold_until = now_ms + BUSY_RETRY_MS;
+        return;
+    }
+    if (pkt[1] == LINK_NACK && n >= 7 && pkt[3] == LINK_ERR_SEQ)
+    {
+        int e = seq_to_index(pkt[4]);
+        if (e >= 0 && !reqs[e].done)
+            go_back(e);
+        return;
+    }
+
+    if (!r->done)
+    {
+        r->done = 1;
+        r->status = pkt[1];
+        r->err = pkt[1] == LINK_NACK ? pkt[3] : 0;
+        r->reply_len = pkt[1] == LINK_ACK ? n - 5 : 0;
+        memcpy(r->reply, pkt + 3, r->reply_len);
+        if (r->cmd == LINK_CMD_PVT && r->reply_len == 2 && idx > pvt_credit_idx)
+        {
+            pvt_credit_idx = idx;
+            pvt_free = r->reply[0];
+        }
+    }
+    // 下位机按序执行，后面的请求有了结果说明最早的请求已执行、只是应答丢失，
+    // 立即重发取回结果（下位机按重复请求回复），不等超时
+    if (idx > base && !reqs[base].done && !reqs[base].fast)
+    {
+        reqs[base].fast = 1;
+        send_request(base);
+    }
+    while (base < req_count && reqs[base].done) base++;
+    if (next < base) next = base;
+}
+
+/* 读取应答字节，0x00 分隔的帧交给 on_response，其余为 ASCII 输出（遥测等）忽略 */
+static void host_receive(void)
+{
+    static uint8_t buf[64];
+    static int len = 0, in_frame = 0;
+    uint8_t chunk[256];
+    int got;
+
+    while ((got = read(fd_host, chunk, sizeof(chunk))) > 0)
+    {
+        for (int i = 0; i < got; i++)
+        {
+            uint8_t b = chunk[i];
+            if (!in_frame)
+            {
+                if (b == 0) { in_frame = 1; len = 0; }
+                continue;
+            }
+            if (b == 0)
+            {
+                if (len > 0)
+                {
+                    uint8_t pkt[64];
+                    int n = Cobs_Decode(buf, len, pkt);
+                    on_response(pkt, n);
+                    in_frame = 0;
+                }
+                continue;
+            }
+            if (len < (int)sizeof(buf)) buf[len++] = b;
+            else in_frame = 0;
+        }
+    }
+}
+
+/* 第 idx 个请求是否受 PVT 队列空间限制而暂不发送 */
+static int pvt_blocked(int idx)
+{
+    if (reqs[idx].cmd != LINK_CMD_PVT || reqs[idx].len == 0)
+        return 0;
+    int pending = 0;
+    for (int i = pvt_credit_idx + 1; i < idx; i++)
+    {
+        if (reqs[i].cmd == LINK_CMD_PVT && reqs[i].len) pending++;
+    }
+    if (pending < pvt_free)
+        return 0;
+    if (idx > base)
+        return 1;               // 等在途请求的应答更新剩余空间
+    hold_until = now_ms + PVT_POLL_MS;
+    return 0;                   // 无在途请求：试发一个
+}
+
+/* 发送窗口内尚未应答的请求；SYNC 单独发送，确认后才开始后续请求 */
+static void host_pump(void)
+{
+    if ((int32_t)(hold_until - now_ms) > 0)
+        return;
+
+    // 超时只重发最早的一个：多数是应答丢失，下位机按重复请求回复；
+    // 若请求本身丢失，后续请求的 NACK SEQ 会触发整体重发
+    if (base < next && !reqs[base].done && now_ms - reqs[base].sent_ms >= RTO_MS)
+    {
+        host_timeouts++;
+        send_request(base);
+    }
+
+    int limit = base == 0 ? 1 : window;
+    while (next < req_count && next - base < limit && !pvt_blocked(next))
+    {
+        if (!reqs[next].done)
+            send_request(next);
+        next++;
+    }
+}
+
+/* ---------------- 自测：下位机替身 ---------------- */
+
+static int16_t executed[MAX_REQUESTS];
+static int executed_count = 0;
+
+uint8_t Link_Port_Execute(uint8_t cmd, const uint8_t *payload, uint8_t len,
+                          uint8_t *reply, uint8_t *reply_len)
+{
+    switch (cmd)
+    {
+        case LINK_CMD_PING:
+            return 0;
+        case LINK_CMD_SPEED:
+            if (len != 2) return LINK_ERR_LENGTH;
+            executed[executed_count++] = (int16_t)(payload[0] | payload[1] << 8);
+            return 0;
+        case LINK_CMD_STATUS:
+            reply[0] = 0x34;
+            reply[1] = 0x12;
+            reply[2] = 1;
+            *reply_len = 3;
+            return 0;
+        case LINK_CMD_TEXT:
+            return (len > 6 && memcmp(payload, "@speed%", 7) == 0) ? 0 : LINK_ERR_CMD;
+        case LINK_CMD_PVT:
+        {
+            if (len == 10)
+            {
+                uint16_t dt;
+                int32_t pos, vel;
+                memcpy(&dt, payload, 2);
+                memcpy(&pos, payload + 2, 4);
+                memcpy(&vel, payload + 6, 4);
+                if (!Pvt_Push(dt, pos, vel))
+                    return LINK_ERR_BUSY;
+            }
+            else if (len != 0)
+            {
+                return LINK_ERR_LENGTH;
+            }
+            Pvt_Stats s;
+            Pvt_Get_Stats(&s);
+            reply[0] = Pvt_Free();
+            reply[1] = s.state;
+            *reply_len = 2;
+            return 0;
+        }
+        default:
+            return LINK_ERR_CMD;
+    }
+}
+
+uint8_t Link_Port_Send(const uint8_t *frame, uint8_t len)
+{
+    if (drop_p > 0 && rnd() < drop_p)
+        return 1;           // 应答在线路上丢失
+    if (drop_after >= 0 && drop_after-- == 0)
+        return 1;
+    wire_write(1, frame, len);
+    return 1;
+}
+
+// 电机1模型：速度环理想跟随速度目标（速度单位为每ms脉冲数×1.85）
+static double plant_pos = 0;
+static double plant_origin = 0;         // 轨迹起点
+static int16_t plant_ref = 0;
+
+static void dev_step(void)
+{
+    uint8_t chunk[256];
+    int got;
+
+    if (Pvt_Tick((int32_t)plant_pos, &plant_ref))
+    {
+        plant_pos += plant_ref / 1.85;
+    }
+
+    while ((got = read(fd_dev, chunk, sizeof(chunk))) > 0)
+    {
+        for (int i = 0; i < got; i++) Link_Rx_Byte(chunk[i]);
+    }
+}
+
+static void session_reset(int w)
+{
+    req_count = base = next = 0;
+    executed_count = 0;
+    host_retransmits = host_timeouts = host_busy = 0;
+    pvt_credit_idx = 0;
+    pvt_free = 1;
+    hold_until = now_ms;
+    window = w;
+    seq0 = rand() & 0xFF;
+    add_request(LINK_CMD_SYNC, NULL, 0);
+}
+
+/* 运行直到全部应答或超时，返回用时（ms），超时返回 -1 */
+static long run_session(uint32_t timeout_ms)
+{
+    uint32_t start = now_ms;
+    while (base < req_count)
+    {
+        if (now_ms - start > timeout_ms)
+            return -1;
+        now_ms++;
+        wire_deliver();
+        host_pump();
+        dev_step();
+        host_receive();
+    }
+    return now_ms - start;
+}
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-52s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+static int stream_speeds(int count, int w, long *elapsed)
+{
+    session_reset(w);
+    for (int i = 0; i < count; i++)
+    {
+        int16_t v = (int16_t)(i * 37 - 1000);
+        uint8_t p[2] = { v & 0xFF, (uint16_t)v >> 8 };
+        add_request(LINK_CMD_SPEED, p, 2);
+    }
+    *elapsed = run_session(60000);
+    if (*elapsed < 0 || executed_count != count)
+        return 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (executed[i] != (int16_t)(i * 37 - 1000))
+            return 0;
+    }
+    for (int i = 1; i < req_count; i++)
+    {
+        if (reqs[i].status != LINK_ACK)
+            return 0;
+    }
+    return 1;
+}
+
+static void add_pvt(uint16_t dt, int32_t pos, int32_t vel)
+{
+    uint8_t p[10];
+    memcpy(p, &dt, 2);
+    memcpy(p + 2, &pos, 4);
+    memcpy(p + 6, &vel, 4);
+    add_request(LINK_CMD_PVT, p, sizeof(p));
+}
+
+/* 轨迹 p = A(1-cos ωt)/2，1Hz，每 dt 一个点；整周期结束时速度为0 */
+#define PVT_TEST_AMP    20000
+#define PVT_TEST_DT     10
+#define PVT_HOLD_TOL    2           // 保持终点的允许误差（脉冲）
+#define PVT_BIG_STEP    8000000     // 4ms 段的位移：段内速度约 2.2e9~3e9 脉冲/s
+
+static void add_pvt_wave(int count)
+{
+    double w = 2 * 3.14159265358979 * 1.0;
+    for (int k = 1; k <= count; k++)
+    {
+        double t = k * PVT_TEST_DT / 1000.0;
+        add_pvt(PVT_TEST_DT, (int32_t)(PVT_TEST_AMP * (1 - cos(w * t)) / 2),
+                (int32_t)(PVT_TEST_AMP * w * sin(w * t) / 2));
+    }
+}
+
+/* 停止上次的轨迹，下发 count 个点并运行到下位机停止插值 */
+static int run_pvt(int count, Pvt_Stats *s)
+{
+    Pvt_Stop();
+    dev_step();
+    plant_origin = plant_pos;
+    session_reset(8);
+    add_pvt_wave(count);
+    if (run_session(60000) < 0)
+        return 0;
+    for (int i = 0; i < 10000; i++)
+    {
+        Pvt_Get_Stats(s);
+        if (s->state == PVT_HOLD && s->queued == 0)
+            break;
+        now_ms++;
+        wire_deliver();
+        dev_step();
+        host_receive();
+    }
+    for (int i = 1; i < req_count; i++)
+    {
+        if (reqs[i].status != LINK_ACK)
+            return 0;
+    }
+    return s->state == PVT_HOLD;
+}
+
+static int self_test(void)
+{
+    char what[96];
+    long t1, t8;
+
+    fd_host = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd_host < 0 || grantpt(fd_host) || unlockpt(fd_host))
+    {
+        perror("posix_openpt");
+        return 2;
+    }
+    fd_dev = open(ptsname(fd_host), O_RDWR | O_NOCTTY);
+    if (fd_dev < 0)
+    {
+        perror("open slave");
+        return 2;
+    }
+    struct termios t;
+    tcgetattr(fd_dev, &t);
+    cfmakeraw(&t);
+    tcsetattr(fd_dev, TCSANOW, &t);
+    fcntl(fd_host, F_SETFL, O_NONBLOCK);
+    fcntl(fd_dev, F_SETFL, O_NONBLOCK);
+    srand(1);
+    simulate = 1;
+
+    // 1. COBS/CRC 基本性质
+    uint8_t raw[300], enc[COBS_MAX_ENCODED(300)], dec[300];
+    int ok = Cobs_Crc16((const uint8_t *)"123456789", 9) == 0x29B1;
+    for (int trial = 0; trial < 2000 && ok; trial++)
+    {
+        int n = rand() % 300;
+        for (int i = 0; i < n; i++) raw[i] = rand() % 4 ? rand() & 0xFF : 0;
+        int m = Cobs_Encode(raw, n, enc);
+        ok = m <= COBS_MAX_ENCODED(n) && !memchr(enc, 0, m) &&
+             Cobs_Decode(enc, m, dec) == n && memcmp(raw, dec, n) == 0;
+    }
+    check(ok, "COBS round trip, CRC-16/CCITT-FALSE check value");
+
+    // 2. 干净链路：窗口1与窗口8
+    check(stream_speeds(1000, 1, &t1), "1000 speed commands, window 1");
+    check(stream_speeds(1000, 8, &t8), "1000 speed commands, window 8");
+    snprintf(what, sizeof(what), "  %ld baud: %.0f -> %.0f cmd/s", baud, 1000e3 / t1, 1000e3 / t8);
+    check(t8 * 2 < t1, what);
+
+    // 3. 误码与应答丢失下恰好执行一次、顺序不变
+    corrupt_p = 0.05;
+    drop_p = 0.05;
+    check(stream_speeds(2000, 8, &t8), "2000 commands, 5% corrupted + 5% replies lost");
+    snprintf(what, sizeof(what), "  %u retransmits, %u timeouts, %.0f cmd/s",
+             host_retransmits, host_timeouts, 2000e3 / t8);
+    check(host_retransmits > 0, what);
+    corrupt_p = drop_p = 0;
+
+    // 4. 应答负载与错误码
+    session_reset(8);
+    add_request(LINK_CMD_STATUS, NULL, 0);
+    add_request(LINK_CMD_TEXT, "@speed%5", 8);
+    add_request(LINK_CMD_TEXT, "@nope%1", 7);
+    add_request(LINK_CMD_SPEED, "\x01", 1);
+    add_request(LINK_CMD_PING, NULL, 0);
+    check(run_session(1000) >= 0, "mixed commands");
+    check(reqs[1].status == LINK_ACK && reqs[1].reply_len == 3 &&
+          reqs[1].reply[0] == 0x34 && reqs[1].reply[1] == 0x12 && reqs[1].reply[2] == 1,
+          "  status reply payload");
+    check(reqs[2].status == LINK_ACK, "  text command ack");
+    check(reqs[3].status == LINK_NACK && reqs[3].err == LINK_ERR_CMD, "  unknown text command nack");
+    check(reqs[4].status == LINK_NACK && reqs[4].err == LINK_ERR_LENGTH, "  bad payload length nack");
+    check(reqs[5].status == LINK_ACK, "  ping after errors");
+
+    // 应答丢失后重发：重复请求的应答须带原负载（PVT 流量控制依赖剩余空间）
+    Link_Stats ls0, ls1;
+    for (int k = 0; k < 2; k++)
+    {
+        uint8_t cmd = k ? LINK_CMD_PVT : LINK_CMD_STATUS;
+        Link_Get_Stats(&ls0);
+        session_reset(8);
+        add_request(cmd, NULL, 0);
+        drop_after = 1;                     // SYNC 的应答正常，丢弃第一个应答
+        long ms = run_session(1000);
+        drop_after = -1;
+        Link_Get_Stats(&ls1);
+        if (k == 0)
+            ok = reqs[1].reply_len == 3 && reqs[1].reply[0] == 0x34 && reqs[1].reply[1] == 0x12;
+        else
+            ok = reqs[1].reply_len == 2 && reqs[1].reply[0] == Pvt_Free();
+        snprintf(what, sizeof(what), "  %s ack lost: resent reply %u bytes",
+                 k ? "PVT" : "status", reqs[1].reply_len);
+        check(ms >= 0 && reqs[1].status == LINK_ACK && ls1.duplicates == ls0.duplicates + 1 && ok, what);
+    }
+
+    // 5. PVT 流式下发：队列只有15个点、3秒轨迹，误码下靠流量控制不欠载
+    Pvt_Stats ps;
+    corrupt_p = 0.05;
+    drop_p = 0.05;
+    ok = run_pvt(300, &ps);
+    corrupt_p = drop_p = 0;
+    check(ok && ps.segments == 300 && ps.underruns == 0, "PVT 300 points, 5% corrupted + 5% replies lost");
+    snprintf(what, sizeof(what), "  max tracking error %d counts, %u busy", ps.max_error, host_busy);
+    check(ps.max_error < 64, what);
+    for (int i = 0; i < 500; i++)
+    {
+        now_ms++;
+        dev_step();
+    }
+    snprintf(what, sizeof(what), "  holds end point after 0.5 s (%+.1f counts)", plant_pos - plant_origin);
+    check(fabs(plant_pos - plant_origin) <= PVT_HOLD_TOL, what);
+
+    // 6. 中途断流：欠载减速停止
+    ok = run_pvt(60, &ps);
+    check(ok && ps.underruns == 1, "PVT underrun stops the axis");
+    check(plant_ref == 0, "  speed target back to 0");
+
+    // 短段大位移：段内速度（脉冲/s）超出32位时速度目标饱和而不反号；
+    // 位置增益置0，速度目标只含速度前馈
+    Pvt_Stop();
+    dev_step();
+    int16_t ref, ref_min = 0, ref_max = 0;
+    Pvt_Set_Gain(0);
+    ok = Pvt_Push(4, PVT_BIG_STEP, 0);
+    Pvt_Start();
+    for (int i = 0; i < 8; i++)
+    {
+        ok &= Pvt_Tick(0, &ref);
+        if (ref < ref_min) ref_min = ref;
+        if (ref > ref_max) ref_max = ref;
+    }
+    Pvt_Stop();
+    Pvt_Set_Gain(PVT_KP_Q8);
+    snprintf(what, sizeof(what), "PVT %d counts in 4 ms: speed target %d..%d", PVT_BIG_STEP, ref_min, ref_max);
+    check(ok && ref_min >= 0 && ref_max == INT16_MAX, what);
+
+    // 7. ASCII 命令不受影响
+    const char *text = "@speed%100\r\n120,5\n";
+    ok = 1;
+    for (const char *p = text; *p; p++) ok &= !Link_Rx_Byte(*p);
+    check(ok, "ASCII bytes outside frames pass through");
+
+    Link_Stats s;
+    Link_Get_Stats(&s);
+    printf("device: %u frames, %u ack, %u nack, %u crc, %u dup, %u out of order\n",
+           s.frames, s.acks, s.nacks, s.crc_errors, s.duplicates, s.out_of_order);
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
+
+/* ---------------- 实际设备 ---------------- */
+
+static speed_t baud_constant(long b)
+{
+    switch (b)
+    {
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        default:      return 0;
+    }
+}
+
+static uint32_t wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int parse_command(const char *arg)
+{
+    if (strcmp(arg, "ping") == 0)
+        add_request(LINK_CMD_PING, NULL, 0);
+    else if (strcmp(arg, "status") == 0)
+        add_request(LINK_CMD_STATUS, NULL, 0);
+    else if (strncmp(arg, "speed=", 6) == 0)
+    {
+        int16_t v = atoi(arg + 6);
+        uint8_t p[2] = { v & 0xFF, (uint16_t)v >> 8 };
+        add_request(LINK_CMD_SPEED, p, 2);
+    }
+    else if (strncmp(arg, "pid=", 4) == 0)
+    {
+        float g[3];
+        if (sscanf(arg + 4, "%f,%f,%f", &g[0], &g[1], &g[2]) != 3)
+            return -1;
+        add_request(LINK_CMD_PID, g, sizeof(g));
+    }
+    else if (strcmp(arg, "pvt") == 0)
+        add_request(LINK_CMD_PVT, NULL, 0);
+    else if (strncmp(arg, "pvt=", 4) == 0)
+    {
+        int dt;
+        long pos, vel;
+        if (sscanf(arg + 4, "%d,%ld,%ld", &dt, &pos, &vel) != 3 || dt < 1 || dt > PVT_MAX_DT)
+            return -1;
+        add_pvt(dt, pos, vel);
+    }
+    else if (strncmp(arg, "text=", 5) == 0 && strlen(arg + 5) < LINK_MAX_PAYLOAD)
+        add_request(LINK_CMD_TEXT, arg + 5, strlen(arg + 5));
+    else
+        return -1;
+    return 0;
+}
+
+static int run_device(const char *dev, int from_stdin, int pvt_stdin, char **cmds, int ncmds)
+{
+    struct termios t;
+    speed_t speed = baud_constant(baud);
+
+    if (!speed)
+    {
+        fprintf(stderr, "unsupported baud %ld\n", baud);
+        return 2;
+    }
+    fd_host = open(dev, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd_host < 0 || tcgetattr(fd_host, &t))
+    {
+        perror(dev);
+        return 2;
+    }
+    cfmakeraw(&t);
+    cfsetspeed(&t, speed);
+    tcsetattr(fd_host, TCSANOW, &t);
+    tcflush(fd_host, TCIOFLUSH);
+
+    srand(wall_ms());
+    session_reset(window);
+    if (from_stdin)
+    {
+        char line[64];
+        while (fgets(line, sizeof(line), stdin))
+        {
+            char arg[72];
+            snprintf(arg, sizeof(arg), "speed=%d", atoi(line));
+            parse_command(arg);
+        }
+    }
+    if (pvt_stdin)
+    {
+        char line[64];
+        while (fgets(line, sizeof(line), stdin))
+        {
+            char arg[72];
+            line[strcspn(line, "\r\n")] = '\0';
+            snprintf(arg, sizeof(arg), "pvt=%s", line);
+            if (line[0] && parse_command(arg))
+            {
+                fprintf(stderr, "bad point '%s'\n", line);
+                return 2;
+            }
+        }
+    }
+    for (int i = 0; i < ncmds; i++)
+    {
+        if (parse_command(cmds[i]))
+        {
+            fprintf(stderr, "bad command '%s'\n", cmds[i]);
+            return 2;
+        }
+    }
+
+    uint32_t start = wall_ms(), last_progress = start;
+    int last_base = 0;
+    while (base < req_count)
+    {
+        now_ms = wall_ms();
+        host_pump();
+        usleep(200);
+        host_receive();
+        if (base != last_base)
+        {
+            last_base = base;
+            last_progress = now_ms;
+        }
+        else if (now_ms - last_progress > 20 * RTO_MS)
+        {
+            fprintf(stderr, "no response from device\n");
+            return 1;
+        }
+    }
+
+    int errors = 0;
+    for (int i = 1; i < req_count; i++)
+    {
+        const Request *r = &reqs[i];
+        if (r->status == LINK_NACK) errors++;
+        if (verbose || r->status == LINK_NACK || r->reply_len)
+        {
+            printf("#%d cmd 0x%02X %s", i, r->cmd, r->status == LINK_ACK ? "ack" : "nack");
+            if (r->status == LINK_NACK) printf(" err %u", r->err);
+            if (r->cmd == LINK_CMD_STATUS && r->reply_len == 3)
+                printf(" target %d mode %u", (int16_t)(r->reply[0] | r->reply[1] << 8), r->reply[2]);
+            if (r->cmd == LINK_CMD_PVT && r->reply_len == 2)
+                printf(" free %u state %u", r->reply[0], r->reply[1]);
+            printf("\n");
+        }
+    }
+    uint32_t elapsed = wall_ms() - start;
+    printf("%d commands in %u ms (%.0f cmd/s), %u retransmits, %u busy, %d rejected\n", req_count - 1,
+           elapsed, elapsed ? (req_count - 1) * 1000.0 / elapsed : 0.0, host_retransmits, host_busy, errors);
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dev = NULL;
+    int test = 0, from_stdin = 0, pvt_stdin = 0, opt;
+
+    while ((opt = getopt(argc, argv, "td:b:w:spv")) != -1)
+    {
+        switch (opt)
+        {
+            case 't': test = 1;                 break;
+            case 'd': dev = optarg;             break;
+            case 'b': baud = atol(optarg);      break;
+            case 'w': window = atoi(optarg);    break;
+            case 's': from_stdin = 1;           break;
+            case 'p': pvt_stdin = 1;            break;
+            case 'v': verbose = 1;              break;
+            default:  goto usage;
+        }
+    }
+    if (window < 1 || window > LINK_WINDOW)
+    {
+        fprintf(stderr, "window must be 1..%d\n", LINK_WINDOW);
+        return 2;
+    }
+    if (test)
+        return self_test();
+    if (dev && (from_stdin || pvt_stdin || optind < argc))
+        return run_device(dev, from_stdin, pvt_stdin, argv + optind, argc - optind);
+
+usage:
+    fprintf(stderr, "usage: link_host -t\n"
+                    "       link_host -d tty [-b baud] [-w window] [-v] command...\n"
+                    "       link_host -d tty [-b baud] [-w window] -s < speeds.txt\n"
+                    "       link_host -d tty [-b baud] [-w window] -p < points.csv\n");
+    return 2;
+}
@@ -0,0 +1,542 @@
+/* ==========================================================
+ * 变量测量与标定客户端（上位机，Linux）
+ *
+ * 从 Keil 链接 map 文件的 Image Symbol Table 查变量地址与大小
+ * （Options → Listing 勾选 Local Symbols，static 变量才会列出），
+ * 经串口向固件下发 @mlist%/@mdaq%/@mread%/@mwrite% 命令（见
+ * Hardware/Measure.h），解码采集帧并按 CSV 输出。
+ *
+ * 编译：gcc -O2 -o meas meas.c
+ * 用法：
+ *   meas -m Listings/Project.map -l [子串]             列出数据符号
+ *   meas -m <map> -d /dev/ttyUSB0 [-b 波特率] [-p 周期ms] [-n 帧数] 变量...
+ *                                                       周期采集，输出 ms,值1,值2...
+ *   meas -m <map> -d <串口> -r 变量...                 单次读取
+ *   meas -m <map> -d <串口> -w 变量=值...              一次提交写入（原子生效）
+ *
+ * 变量写法：[目标文件/]名称[下标][:类型]
+ *   类型 u8 i8 u16 i16 u32 i32 f32；省略时按符号大小取 u8/i16/i32，
+ *   数组必须给出类型（下标按类型大小换算偏移）。名称也可以直接写 0x 地址。
+ *   例：speed_err[0]:f32  speed_output:f32  encoder.o/encoder_pos2  target_speed
+ *   同名 static 变量出现在多个目标文件中时需加目标文件前缀。
+ *
+ * 固件与上位机均为小端，采集帧中各项按原始字节依次排列。
+ * ========================================================== */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <sys/select.h>
+
+#define MAX_SYMBOLS     8192
+#define MAX_VARS        12      // 与 MEAS_MAX_ENTRIES 一致
+#define MAX_BYTES       32      // 与 MEAS_MAX_BYTES 一致
+#define REPLY_MS        500     // 等待应答的时间
+
+typedef struct
+{
+    char name[64];
+    char object[48];
+    unsigned long addr;
+    unsigned long size;
+} Symbol;
+
+typedef struct
+{
+    char label[96];
+    unsigned long addr;
+    int size;               // 1/2/4
+    char type;              // 'u' 'i' 'f'
+    char value[32];         // 写入值（-w）
+} Var;
+
+static Symbol symbols[MAX_SYMBOLS];
+static int symbol_count = 0;
+static int fd = -1;
+static volatile sig_atomic_t stop = 0;
+
+/* 解析 map 文件中的数据符号行：
+ *   speed_err   0x2000001c   Data   12  pid.o(.bss) */
+static int load_map(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[512];
+
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) && symbol_count < MAX_SYMBOLS)
+    {
+        char name[256], kind[16], object[256];
+        unsigned long addr, size;
+
+        if (!strstr(line, " Data "))
+            continue;
+        if (sscanf(line, "%255s 0x%lx %15s %lu %255s", name, &addr, kind, &size, object) != 5)
+            continue;
+        if (strcmp(kind, "Data") != 0 || size == 0)
+            continue;
+
+        Symbol *s = &symbols[symbol_count++];
+        snprintf(s->name, sizeof(s->name), "%.63s", name);
+        char *paren = strchr(object, '(');
+        if (paren) *paren = '\0';
+        snprintf(s->object, sizeof(s->object), "%.47s", object);
+        s->addr = addr;
+        s->size = size;
+    }
+    fclose(f);
+    return 0;
+}
+
+static int parse_type(const char *t, Var *v)
+{
+    static const struct { const char *name; char type; int size; } types[] =
+    {
+        { "u8", 'u', 1 }, { "i8", 'i', 1 }, { "u16", 'u', 2 }, { "i16", 'i', 2 },
+        { "u32", 'u', 4 }, { "i32", 'i', 4 }, { "f32", 'f', 4 },
+    };
+    for (unsigned i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        if (strcmp(t, types[i].name) == 0)
+        {
+            v->type = types[i].type;
+            v->size = types[i].size;
+            return 0;
+        }
+    }
+    fprintf(stderr, "unknown type '%s'\n", t);
+    return -1;
+}
+
+/* 解析变量写法并在符号表中查找，结果写入 v */
+static int resolve(const char *spec, Var *v)
+{
+    char buf[128], *name, *object = NULL, *type, *index, *value;
+    long element = -1;
+    const Symbol *found = NULL;
+
+    memset(v, 0, sizeof(*v));
+    snprintf(buf, sizeof(buf), "%s", spec);
+    if ((value = strchr(buf, '=')) != NULL)
+    {
+        *value++ = '\0';
+        snprintf(v->value, sizeof(v->value), "%s", value);
+    }
+    snprintf(v->label, sizeof(v->label), "%.95s", buf);
+    if ((type = strchr(buf, ':')) != NULL) *type++ = '\0';
+    if ((index = strchr(buf, '[')) != NULL)
+    {
+        *index++ = '\0';
+        element = strtol(index, NULL, 0);
+    }
+    name = buf;
+    if (strchr(name, '/'))
+    {
+        object = name;
+        name = strchr(name, '/');
+        *name++ = '\0';
+    }
+
+    if (type && parse_type(type, v))
+        return -1;
+
+    if (strncmp(name, "0x", 2) == 0)
+    {
+        v->addr = strtoul(name, NULL, 16);
+        if (!type)
+            return parse_type("u32", v);
+    }
+    else
+    {
+        for (int i = 0; i < symbol_count; i++)
+        {
+            if (strcmp(symbols[i].name, name) != 0 || (object && strcmp(symbols[i].object, object) != 0))
+                continue;
+            if (found)
+            {
+                fprintf(stderr, "%s: defined in %s and %s, prefix with the object file\n",
+                        name, found->object, symbols[i].object);
+                return -1;
+            }
+            found = &symbols[i];
+        }
+        if (!found)
+        {
+            fprintf(stderr, "%s: not in map (enable Local Symbols for static variables)\n", name);
+            return -1;
+        }
+        if (!type)
+        {
+            if (found->size == 1)      parse_type("u8", v);
+            else if (found->size == 2) parse_type("i16", v);
+            else if (found->size == 4) parse_type("i32", v);
+            else
+            {
+                fprintf(stderr, "%s: %lu bytes, give an element type (e.g. %s[0]:f32)\n",
+                        name, found->size, name);
+                return -1;
+            }
+        }
+        v->addr = found->addr;
+        if (element >= 0)
+        {
+            v->addr += element * v->size;
+            if ((unsigned long)(element + 1) * v->size > found->size)
+            {
+                fprintf(stderr, "%s[%ld]: out of bounds (%lu bytes)\n", name, element, found->size);
+                return -1;
+            }
+        }
+    }
+    if (v->addr & (v->size - 1))
+    {
+        fprintf(stderr, "%s: 0x%08lx not aligned to %d\n", spec, v->addr, v->size);
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------------- 串口 ---------------- */
+
+static speed_t baud_constant(long baud)
+{
+    switch (baud)
+    {
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        default:      return 0;
+    }
+}
+
+static int open_port(const char *dev, long baud)
+{
+    struct termios t;
+    speed_t speed = baud_constant(baud);
+
+    if (!speed)
+    {
+        fprintf(stderr, "unsupported baud %ld\n", baud);
+        return -1;
+    }
+    fd = open(dev, O_RDWR | O_NOCTTY);
+    if (fd < 0 || tcgetattr(fd, &t))
+    {
+        perror(dev);
+        return -1;
+    }
+    cfmakeraw(&t);
+    cfsetspeed(&t, speed);
+    t.c_cc[VMIN] = 0;
+    t.c_cc[VTIME] = 0;
+    tcsetattr(fd, TCSANOW, &t);
+    tcflush(fd, TCIOFLUSH);
+    return 0;
+}
+
+static void send_cmd(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+static void send_cmd(const char *fmt, ...)
+{
+    char line[64];
+    va_list ap;
+
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line) - 1, fmt, ap);
+    va_end(ap);
+    line[n++] = '\n';
+    if (write(fd, line, n) != n)
+    {
+        perror("write");
+        exit(2);
+    }
+}
+
+/* 读取一行，timeout_ms 内没有完整的行返回0 */
+static int read_line(char *line, int size, int timeout_ms)
+{
+    static char buf[512];
+    static int len = 0;
+
+    while (1)
+    {
+        char *nl = memchr(buf, '\n', len);
+        if (nl)
+        {
+            int n = nl - buf;
+            if (n >= size) n = size - 1;
+            memcpy(line, buf, n);
+            line[n] = '\0';
+            len -= nl + 1 - buf;
+            memmove(buf, nl + 1, len);
+            return 1;
+        }
+        if (len == sizeof(buf)) len = 0;        // 超长行丢弃
+
+        fd_set set;
+        struct timeval tv = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        if (select(fd + 1, &set, NULL, NULL, &tv) <= 0)
+            return 0;
+        int n = read(fd, buf + len, sizeof(buf) - len);
+        if (n <= 0)
+            return 0;
+        len += n;
+    }
+}
+
+/* 等待以 prefix 开头的应答；收到该命令的 err 行返回 -1 */
+static int wait_reply(const char *prefix, const char *cmd, char *line, int size)
+{
+    char err[32];
+    snprintf(err, sizeof(err), "err,%s", cmd);
+
+    while (read_line(line, size, REPLY_MS))
+    {
+        if (strncmp(line, prefix, strlen(prefix)) == 0)
+            return 0;
+        if (strncmp(line, err, strlen(err)) == 0)
+            return -1;
+    }
+    return -1;
+}
+
+/* ---------------- 数值 ---------------- */
+
+static uint32_t from_le(const uint8_t *p, int size)
+{
+    uint32_t v = 0;
+    for (int i = size - 1; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static void print_value(const Var *v, uint32_t raw)
+{
+    if (v->type == 'f')
+    {
+        float f;
+        memcpy(&f, &raw, 4);
+        printf("%g", f);
+    }
+    else if (v->type == 'i')
+    {
+        int shift = 32 - 8 * v->size;
+        printf("%d", (int32_t)(raw << shift) >> shift);
+    }
+    else
+    {
+        printf("%u", raw);
+    }
+}
+
+static int to_raw(const Var *v, uint32_t *raw)
+{
+    char *end;
+
+    if (v->value[0] == '\0')
+    {
+        fprintf(stderr, "%s: missing =value\n", v->label);
+        return -1;
+    }
+    if (v->type == 'f')
+    {
+        float f = strtof(v->value, &end);
+        memcpy(raw, &f, 4);
+    }
+    else
+    {
+        *raw = (uint32_t)strtoll(v->value, &end, 0);
+        if (v->size < 4) *raw &= (1UL << (8 * v->size)) - 1;
+    }
+    if (*end)
+    {
+        fprintf(stderr, "%s: bad value '%s'\n", v->label, v->value);
+        return -1;
+    }
+    return 0;
+}
+
+/* ---------------- 操作 ---------------- */
+
+static int do_read(Var *vars, int count)
+{
+    char line[128];
+
+    for (int i = 0; i < count; i++)
+    {
+        send_cmd("@mread%%%lX,%d", vars[i].addr, vars[i].size);
+        if (wait_reply("mr,", "@mread%", line, sizeof(line)))
+        {
+            fprintf(stderr, "%s: read rejected\n", vars[i].label);
+            return 1;
+        }
+        printf("%s = ", vars[i].label);
+        print_value(&vars[i], strtoul(line + 12, NULL, 16));
+        printf("\n");
+    }
+    return 0;
+}
+
+static int do_write(Var *vars, int count)
+{
+    char line[128];
+
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t raw;
+        if (to_raw(&vars[i], &raw))
+            return 1;
+        send_cmd("@mwrite%%%lX,%d,%X", vars[i].addr, vars[i].size, raw);
+    }
+    send_cmd("@mwrite%%c");
+    if (wait_reply("mw,ok,", "@mwrite%", line, sizeof(line)) || atoi(line + 6) != count)
+    {
+        fprintf(stderr, "write rejected, nothing applied\n");
+        send_cmd("@mwrite%%x");
+        return 1;
+    }
+    printf("%d variable(s) written\n", count);
+    return 0;
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static int do_daq(Var *vars, int count, int period, long frames)
+{
+    char line[256];
+    int bytes = 0;
+
+    for (int i = 0; i < count; i++) bytes += vars[i].size;
+    if (count > MAX_VARS || bytes > MAX_BYTES)
+    {
+        fprintf(stderr, "at most %d variables / %d bytes per list\n", MAX_VARS, MAX_BYTES);
+        return 1;
+    }
+
+    send_cmd("@mdaq%%0");
+    send_cmd("@mlist%%c");
+    for (int i = 0; i < count; i++)
+    {
+        send_cmd("@mlist%%%d,%lX,%d", i, vars[i].addr, vars[i].size);
+    }
+    send_cmd("@mdaq%%%d", period);
+    if (wait_reply("meas,", "@m", line, sizeof(line)))
+    {
+        fprintf(stderr, "list rejected\n");
+        return 1;
+    }
+
+    printf("ms");
+    for (int i = 0; i < count; i++) printf(",%s", vars[i].label);
+    printf("\n");
+
+    signal(SIGINT, on_signal);
+    while (!stop && frames != 0)
+    {
+        if (!read_line(line, sizeof(line), REPLY_MS) || strncmp(line, "m,", 2) != 0)
+            continue;
+
+        char *hex = strchr(line + 2, ',');
+        if (!hex || (int)strlen(hex + 1) != bytes * 2)
+            continue;
+        uint8_t raw[MAX_BYTES];
+        for (int i = 0; i < bytes; i++)
+        {
+            char byte[3] = { hex[1 + 2 * i], hex[2 + 2 * i], 0 };
+            raw[i] = strtoul(byte, NULL, 16);
+        }
+
+        printf("%.*s", (int)(hex - line - 2), line + 2);
+        for (int i = 0, off = 0; i < count; off += vars[i].size, i++)
+        {
+            printf(",");
+            print_value(&vars[i], from_le(raw + off, vars[i].size));
+        }
+        printf("\n");
+        fflush(stdout);
+        if (frames > 0) frames--;
+    }
+
+    send_cmd("@mdaq%%0");
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: meas -m map -l [filter]\n"
+                    "       meas -m map -d tty [-b baud] [-p ms] [-n frames] var...\n"
+                    "       meas -m map -d tty [-b baud] -r var...\n"
+                    "       meas -m map -d tty [-b baud] -w var=value...\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *map = NULL, *dev = NULL;
+    long baud = 115200, frames = -1;
+    int period = 1, mode = 0, opt;
+    static Var vars[64];
+    int count = 0;
+
+    while ((opt = getopt(argc, argv, "m:d:b:p:n:lrw")) != -1)
+    {
+        switch (opt)
+        {
+            case 'm': map = optarg;                break;
+            case 'd': dev = optarg;                break;
+            case 'b': baud = atol(optarg);         break;
+            case 'p': period = atoi(optarg);       break;
+            case 'n': frames = atol(optarg);       break;
+            case 'l': case 'r': case 'w': mode = opt; break;
+            default: usage();
+        }
+    }
+    if (!map || load_map(map))
+        usage();
+
+    if (mode == 'l')
+    {
+        for (int i = 0; i < symbol_count; i++)
+        {
+            if (optind < argc && !strstr(symbols[i].name, argv[optind]))
+                continue;
+            printf("0x%08lx %6lu  %-40s %s\n", symbols[i].addr, symbols[i].size,
+                   symbols[i].name, symbols[i].object);
+        }
+        return 0;
+    }
+
+    if (!dev || optind >= argc)
+        usage();
+    for (int i = optind; i < argc && count < (int)(sizeof(vars) / sizeof(vars[0])); i++)
+    {
+        if (resolve(argv[i], &vars[count++]))
+            return 1;
+    }
+    if (open_port(dev, baud))
+        return 2;
+
+    if (mode == 'r')
+        return do_read(vars, count);
+    if (mode == 'w')
+        return do_write(vars, count);
+    return do_daq(vars, count, period, frames);
+}
@@ -0,0 +1,199 @@
+/* ==========================================================
+ * 编码器状态观测器（α-β-γ）校验工具（上位机，Linux）
+ *
+ * 直接编译固件中的 Hardware/Observer.c，每周期输入按整数脉冲取整的
+ * 真实位置，与真实速度（同为 脉冲/周期×1.85）比较，并与固件原始
+ * 差分测速（Encoder_Get_Speed）对照：
+ *   匀速     非整数速度，稳定后逐周期误差与 RMS，RMS 须明显小于差分测速
+ *            （或接近整数输出本身的取整误差）
+ *   匀加速   常加速度模型无稳态滞后，斜坡末段平均误差（同时检查输出取整无偏）
+ *   阶跃     速度突变后的超调与进入 ±1.5（或阶跃量 1%）的周期数，不超过 8/(1-θ)
+ *   清零     运动中计数清零并 Rebase，速度不跳变
+ *   跳变     计数突跳超过残差限幅（未 Rebase），不溢出且能重新收敛
+ *   增益     直接设置的 α、β、γ 超出稳定域时拒绝
+ *
+ * 编译：gcc -O2 -Ihost -I../Hardware -o obs_check obs_check.c ../Hardware/Observer.c -lm
+ * 用法：obs_check [-v 匀速(脉冲/周期)] [-t 衰减记忆因子θ]
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include "Observer.h"
+#include "Serial.h"
+
+/* 报告前后暂停周期遥测（固件见 Serial.c），上位机无遥测 */
+void Serial_Telemetry_Enable(uint8_t enable)
+{
+    (void)enable;
+}
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-66s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+/* 真实运动：位置（脉冲）与速度（脉冲/周期） */
+typedef struct
+{
+    double pos;
+    double vel;
+    int32_t offset;         // 计数偏移（清零、跳变）
+    int32_t prev_count;
+} Motion;
+
+static int32_t count_of(const Motion *m)
+{
+    return (int32_t)floor(m->pos) + m->offset;
+}
+
+/* 推进一周期（速度按周期内平均计），更新观测器，返回原始差分测速 */
+static int16_t step(Motion *m, double accel)
+{
+    m->pos += m->vel + accel / 2;
+    m->vel += accel;
+    int32_t count = count_of(m);
+    int16_t raw = (int16_t)((count - m->prev_count) * 1.85f);
+    m->prev_count = count;
+    Observer_Update(1, count);
+    return raw;
+}
+
+static void restart(Motion *m, double vel)
+{
+    m->pos = 0.37;
+    m->vel = vel;
+    m->offset = 0;
+    m->prev_count = count_of(m);
+    Observer_Init();
+    Observer_Update(1, m->prev_count);
+}
+
+static double err_of(const Motion *m)
+{
+    return Observer_Get_Speed(1) - m->vel * 1.85;
+}
+
+int main(int argc, char **argv)
+{
+    double vel = 10.3, theta = 0.8;
+    int opt;
+    char what[128];
+    Motion m;
+
+    while ((opt = getopt(argc, argv, "v:t:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'v': vel = atof(optarg); break;
+            case 't': theta = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: obs_check [-v counts_per_tick] [-t theta]\n");
+                return 2;
+        }
+    }
+    if (fabs(vel) < 1 || fabs(vel) > 200 || theta < 0.5 || theta > 0.95)
+    {
+        fprintf(stderr, "obs_check: 1 <= |v| <= 200, 0.5 <= theta <= 0.95\n");
+        return 2;
+    }
+    int32_t theta_q16 = (int32_t)lround(theta * 65536);
+    printf("speed %.2f counts/tick (%.2f units), theta %.2f\n", vel, vel * 1.85, theta);
+
+    /* 匀速：从静止初值起，500 周期后统计 2000 周期 */
+    restart(&m, vel);
+    Observer_Set_Theta(1, theta_q16);
+    double sum_obs = 0, sum_raw = 0, max_err = 0;
+    for (int t = 0; t < 2500; t++)
+    {
+        int16_t raw = step(&m, 0);
+        if (t < 500) continue;
+        double e = err_of(&m), er = raw - m.vel * 1.85;
+        sum_obs += e * e;
+        sum_raw += er * er;
+        if (fabs(e) > max_err) max_err = fabs(e);
+    }
+    double rms_obs = sqrt(sum_obs / 2000), rms_raw = sqrt(sum_raw / 2000);
+    snprintf(what, sizeof(what), "constant speed: max err %.2f, rms %.2f (raw difference %.2f)",
+             max_err, rms_obs, rms_raw);
+    double round_err = fabs(vel * 1.85 - lround(vel * 1.85));   // 整数输出的最小误差
+    check(max_err <= 1.5 && rms_obs <= fmax(0.6 * rms_raw, round_err + 0.1), what);
+
+    /* 匀加速：速度在 2000 周期内增加 vel，末 200 周期平均误差 */
+    restart(&m, 0);
+    Observer_Set_Theta(1, theta_q16);
+    double accel = vel / 2000, lag = 0;
+    for (int t = 0; t < 2000; t++)
+    {
+        step(&m, accel);
+        if (t >= 1800) lag += err_of(&m);
+    }
+    lag /= 200;
+    snprintf(what, sizeof(what), "ramp 0 -> %.1f in 2 s: mean error %.2f at end", vel, lag);
+    check(fabs(lag) <= 0.3, what);
+
+    /* 阶跃：由静止突变到 vel */
+    restart(&m, 0);
+    Observer_Set_Theta(1, theta_q16);
+    for (int t = 0; t < 100; t++) step(&m, 0);
+    m.vel = vel;
+    int settle = -1;
+    double peak = 0, tol = fmax(1.5, fabs(vel) * 1.85 / 100);
+    for (int t = 0; t < 300; t++)
+    {
+        step(&m, 0);
+        double e = err_of(&m);
+        if (e * (vel > 0 ? 1 : -1) > peak) peak = e * (vel > 0 ? 1 : -1);
+        if (fabs(e) > tol) settle = -1;
+        else if (settle < 0) settle = t + 1;
+    }
+    snprintf(what, sizeof(what), "step 0 -> %.1f: overshoot %.1f units, within %.1f after %d ticks",
+             vel, peak, tol, settle);
+    check(settle > 0 && settle <= 8 / (1 - theta), what);
+
+    /* 清零：匀速运动中计数清零并 Rebase */
+    restart(&m, vel);
+    Observer_Set_Theta(1, theta_q16);
+    for (int t = 0; t < 500; t++) step(&m, 0);
+    int16_t before = Observer_Get_Speed(1);
+    m.offset = -(int32_t)floor(m.pos);
+    m.prev_count = count_of(&m);
+    Observer_Rebase(1);
+    double jump = 0;
+    for (int t = 0; t < 200; t++)
+    {
+        step(&m, 0);
+        if (abs(Observer_Get_Speed(1) - before) > jump) jump = abs(Observer_Get_Speed(1) - before);
+    }
+    snprintf(what, sizeof(what), "count cleared with rebase: speed %d, max change %.0f", before, jump);
+    check(jump <= 2, what);
+
+    /* 跳变：计数突增 100000 脉冲，未 Rebase */
+    m.offset += 100000;
+    int16_t worst = 0;
+    int recovered = -1;
+    for (int t = 0; t < 3000; t++)
+    {
+        step(&m, 0);
+        int16_t s = Observer_Get_Speed(1);
+        if (abs(s) > abs(worst)) worst = s;
+        if (fabs(err_of(&m)) > 1.5) recovered = -1;
+        else if (recovered < 0) recovered = t + 1;
+    }
+    snprintf(what, sizeof(what), "count jump +100000: peak speed %d, back within 1.5 after %d ticks",
+             worst, recovered);
+    check(recovered > 0 && recovered <= 1000, what);
+
+    /* 直接设置增益：稳定域外拒绝，增益不变 */
+    check(!Observer_Set_Gains(1, 2 << 16, 2 << 16, 2 << 16) && !Observer_Set_Gains(1, 32768, 16384, 16384) &&
+          !Observer_Set_Gains(3, 32768, 16384, 8192) && Observer_Set_Gains(1, 32768, 16384, 8192),
+          "direct gains outside 0<a<=1, 0<b<2, 0<g<b rejected");
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,256 @@
+/* ==========================================================
+ * 差速运动学/里程计校验工具（上位机，Linux）
+ *
+ * 直接编译固件中的 Hardware/Drive.c 与 System/Trig.c：
+ *   查表    全圆周逐点比较 Trig_Sin_Q15/Trig_Cos_Q15 与 sin/cos
+ *   直线    两轮等速，航向保持0，x 等于行驶距离
+ *   原地转  两轮反向恰好一圈，航向回到0，位置不动
+ *   圆周    两轮不等速绕圆多圈，回到起点，半径与几何一致
+ *   随机    两轮随机增量与双精度（同一中点公式）逐周期比较，计数跨越 32 位回绕，
+ *           误差允许输出取整（每轴 0.5mm）加行驶距离的 10ppm（查表误差）
+ *   清零    编码器计数清零（模式切换）时位姿不跳变
+ *   运动学  轮速换算（整数目标 1000 周期平均，低速不丢小数）与超上限时的同比例缩放
+ *
+ * 编译：gcc -O2 -I../Hardware -I../System -o odom_check odom_check.c ../Hardware/Drive.c ../System/Trig.c -lm
+ * 用法：odom_check [-n 周期数] [-g 每米脉冲数,轮距mm]
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include "Drive.h"
+#include "Trig.h"
+
+static int failures = 0;
+static uint32_t cpm = 7640;
+static uint16_t track = 160;
+
+static void check(int ok, const char *what)
+{
+    printf("%-60s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+/* 连续取 1000 周期轮速目标，返回平均值与偏离平均值的最大量 */
+static uint8_t mean_targets(double *m1, double *m2, double *spread)
+{
+    int16_t t1[1000], t2[1000];
+    uint8_t scaled = 0;
+    double s1 = 0, s2 = 0;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        scaled = Drive_Wheel_Targets(&t1[i], &t2[i]);
+        s1 += t1[i];
+        s2 += t2[i];
+    }
+    *m1 = s1 / 1000;
+    *m2 = s2 / 1000;
+    *spread = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        if (fabs(t1[i] - *m1) > *spread) *spread = fabs(t1[i] - *m1);
+        if (fabs(t2[i] - *m2) > *spread) *spread = fabs(t2[i] - *m2);
+    }
+    return scaled;
+}
+
+static double heading_deg(const Drive_Pose *p)
+{
+    return p->heading_cdeg / 100.0;
+}
+
+/* 从原点开始，按给定每周期增量运行 n 个周期 */
+static void run(int32_t *pos1, int32_t *pos2, long n, int32_t dl, int32_t dr)
+{
+    for (long i = 0; i < n; i++)
+    {
+        *pos1 += dl;
+        *pos2 += dr;
+        Drive_Odom_Tick(*pos1, *pos2);
+    }
+}
+
+static void restart(int32_t pos1, int32_t pos2)
+{
+    Drive_Reset_Pose();
+    Drive_Odom_Rebase();
+    Drive_Odom_Tick(pos1, pos2);
+}
+
+static double trig_max_error(void)
+{
+    double max = 0;
+    for (uint64_t a = 0; a < (1ULL << 32); a += 4099)
+    {
+        double rad = a * (2 * M_PI / 4294967296.0);
+        double es = fabs(Trig_Sin_Q15((uint32_t)a) - sin(rad) * 32768);
+        double ec = fabs(Trig_Cos_Q15((uint32_t)a) - cos(rad) * 32768);
+        if (es > max) max = es;
+        if (ec > max) max = ec;
+    }
+    return max;
+}
+
+int main(int argc, char **argv)
+{
+    long ticks = 2000000;
+    int opt;
+    unsigned g_cpm, g_track;
+    char what[128];
+    Drive_Pose p;
+    int32_t pos1 = 0, pos2 = 0;
+
+    while ((opt = getopt(argc, argv, "n:g:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': ticks = atol(optarg); break;
+            case 'g':
+                if (sscanf(optarg, "%u,%u", &g_cpm, &g_track) != 2) goto usage;
+                cpm = g_cpm;
+                track = (uint16_t)g_track;
+                break;
+            default: goto usage;
+        }
+    }
+    if (!Drive_Set_Geometry(cpm, track))
+        goto usage;
+    srand(1);
+
+    double terr = trig_max_error();
+    snprintf(what, sizeof(what), "sin/cos table: max error %.2f LSB (Q15)", terr);
+    check(terr <= 1.5, what);
+
+    /* 直线：10m */
+    restart(pos1, pos2);
+    run(&pos1, &pos2, cpm, 10, 10);
+    Drive_Get_Pose(&p);
+    snprintf(what, sizeof(what), "straight 10 m: x %d mm, y %d mm, heading %.2f deg", p.x_mm, p.y_mm, heading_deg(&p));
+    check(p.x_mm == 10000 && p.y_mm == 0 && p.heading == 0, what);
+
+    /* 原地转一圈：两轮各走 π·轮距（取整到脉冲，期望航向按实际脉冲数计算） */
+    double k = 1000.0 / cpm;                    // mm/脉冲
+    restart(pos1, pos2);
+    long spin = lround(M_PI * track * cpm / 1000.0);
+    run(&pos1, &pos2, spin, -1, 1);
+    Drive_Get_Pose(&p);
+    double expect_deg = remainder(2.0 * spin * k / track * 180 / M_PI, 360);
+    snprintf(what, sizeof(what), "spin in place 1 turn: heading %.2f deg (expect %.2f), x %d, y %d mm",
+             heading_deg(&p), expect_deg, p.x_mm, p.y_mm);
+    check(fabs(heading_deg(&p) - expect_deg) <= 0.02 && p.x_mm == 0 && p.y_mm == 0, what);
+
+    /* 圆周：左 4、右 6 脉冲/周期，半径 = 轮距/2 × (6+4)/(6-4)，终点按实际走过的弧长计算 */
+    restart(pos1, pos2);
+    double radius = track / 2.0 * 10 / 2;
+    long lap = lround(2 * M_PI * radius * cpm / 1000.0 / 5);    // 中心每周期 5 脉冲
+    double th = 3.0 * lap * 2 * k / track;
+    double ex = radius * sin(th), ey = radius * (1 - cos(th));
+    double max_r_err = 0;
+    for (long i = 0; i < 3 * lap; i++)
+    {
+        run(&pos1, &pos2, 1, 4, 6);
+        if (i % 97 == 0)
+        {
+            Drive_Get_Pose(&p);
+            double r = hypot(p.x_mm, p.y_mm - radius);
+            if (fabs(r - radius) > max_r_err) max_r_err = fabs(r - radius);
+        }
+    }
+    Drive_Get_Pose(&p);
+    snprintf(what, sizeof(what), "3 laps r=%.0f mm: end (%d, %d) mm, expect (%.1f, %.1f), radius err %.1f mm",
+             radius, p.x_mm, p.y_mm, ex, ey, max_r_err);
+    check(hypot(p.x_mm - ex, p.y_mm - ey) <= 1.5 &&
+          fabs(heading_deg(&p) - remainder(th * 180 / M_PI, 360)) <= 0.05 && max_r_err <= 1.5, what);
+
+    /* 随机：与双精度参考比较，从接近 INT32_MAX 开始跨越回绕 */
+    pos1 = INT32_MAX - 500000;
+    pos2 = INT32_MAX - 700000;
+    restart(pos1, pos2);
+    double rx = 0, ry = 0, rth = 0, max_err = 0, max_herr = 0, path = 0;
+    int32_t dl = 0, dr = 0;
+    for (long i = 0; i < ticks; i++)
+    {
+        if (i % 500 == 0)
+        {
+            dl = rand() % 41 - 10;
+            dr = rand() % 41 - 10;
+        }
+        int32_t jl = dl + rand() % 3 - 1, jr = dr + rand() % 3 - 1;
+        pos1 = (int32_t)((uint32_t)pos1 + (uint32_t)jl);
+        pos2 = (int32_t)((uint32_t)pos2 + (uint32_t)jr);
+        Drive_Odom_Tick(pos1, pos2);
+
+        double d = (jl + jr) / 2.0 * k, dth = (jr - jl) * k / track;
+        path += fabs(d);
+        rx += d * cos(rth + dth / 2);
+        ry += d * sin(rth + dth / 2);
+        rth += dth;
+        if (i % 1000 == 999)
+        {
+            Drive_Get_Pose(&p);
+            double e = hypot(p.x_mm - rx, p.y_mm - ry);
+            double he = fabs(remainder(p.heading_cdeg / 100.0 - rth * 180 / M_PI, 360));
+            if (e > max_err) max_err = e;
+            if (he > max_herr) max_herr = he;
+        }
+    }
+    Drive_Get_Pose(&p);
+    snprintf(what, sizeof(what), "random %.0f m across wrap: max pos err %.2f mm, heading %.3f deg",
+             path / 1000, max_err, max_herr);
+    check(max_err <= 0.75 + path * 1e-5 && max_herr <= 0.02, what);
+
+    /* 清零：计数突然回到0，位姿不变 */
+    Drive_Pose before;
+    Drive_Get_Pose(&before);
+    pos1 = 0;
+    pos2 = 0;
+    Drive_Odom_Tick(pos1, pos2);                // 未请求重新对齐：增量过大，跳过
+    Drive_Odom_Rebase();
+    Drive_Odom_Tick(pos1, pos2);
+    Drive_Get_Pose(&p);
+    check(p.x_mm == before.x_mm && p.y_mm == before.y_mm && p.heading == before.heading,
+          "encoder count cleared: pose unchanged");
+
+    /* 运动学：1 m/s 直行 = cpm 脉冲/s = cpm/1000 脉冲/ms × 1.85 */
+    double m1, m2, spread;
+    Drive_Set_Wheel_Max(INT16_MAX);
+    Drive_Set_Velocity(1000, 0);
+    mean_targets(&m1, &m2, &spread);
+    double expect = cpm * 1.85 / 1000;
+    snprintf(what, sizeof(what), "1 m/s straight: mean targets %.3f, %.3f (expect %.3f)", m1, m2, expect);
+    check(fabs(m1 - expect) < 0.01 && fabs(m2 - expect) < 0.01 && spread < 1, what);
+
+    /* 原地转：轮速 ±轮距/2 mm/s，低速时整数目标须在相邻值间交替而不是取整丢失 */
+    static const int16_t spin_w[] = { 1000, 200 };
+    for (int i = 0; i < 2; i++)
+    {
+        Drive_Set_Velocity(0, spin_w[i]);
+        mean_targets(&m1, &m2, &spread);
+        expect = track / 2.0 * spin_w[i] / 1000 * cpm * 1.85 / 1e6;
+        snprintf(what, sizeof(what), "%.1f rad/s spin: mean targets %.3f, %.3f (expect -/+%.3f)",
+                 spin_w[i] / 1000.0, m1, m2, expect);
+        check(fabs(m1 + expect) < 0.01 && fabs(m2 - expect) < 0.01 && spread < 1, what);
+    }
+
+    /* 超上限：上限取未缩放轮速的一半，两轮同比例缩放，转弯半径不变 */
+    Drive_Set_Velocity(20000, 20000);
+    mean_targets(&m1, &m2, &spread);
+    int16_t limit = (int16_t)(m2 / 2);
+    Drive_Set_Wheel_Max(limit);
+    uint8_t scaled = mean_targets(&m1, &m2, &spread);
+    double vl = 20000 - 20.0 * track / 2, vr = 20000 + 20.0 * track / 2;
+    double ratio = m1 / m2;
+    snprintf(what, sizeof(what), "saturation at %d: targets %.2f, %.2f, ratio %.3f (expect %.3f)",
+             limit, m1, m2, ratio, vl / vr);
+    check(scaled && fabs(m2 - limit) < 0.01 && fabs(ratio - vl / vr) < 0.01, what);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+
+usage:
+    fprintf(stderr, "usage: odom_check [-n ticks] [-g counts_per_m,track_mm]\n");
+    return 2;
+}
@@ -0,0 +1,195 @@
+/* ==========================================================
+ * PC采样直方图符号化工具（上位机，Linux）
+ *
+ * 读取固件 @prof%d 导出的直方图（Profiler_PollDump 输出），结合
+ * Keil 链接器 map 文件的 Image Symbol Table，把各地址桶的样本按
+ * 重叠字节数分摊到函数，输出函数热点及按目标文件汇总的占比。
+ *
+ * 编译：gcc -O2 -o prof_map prof_map.c
+ * 用法：prof_map [-n 行数] Listings/Project.map < dump.txt
+ *
+ * 桶宽较大（默认128字节）时小函数会与相邻函数共享样本，
+ * 可用 @prof%s,<基址>,<位数> 缩小范围、减小桶宽后再次采样。
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_SYMBOLS     8192
+#define MAX_BUCKETS     4096
+
+typedef struct
+{
+    char name[64];
+    char object[48];
+    unsigned long addr;
+    unsigned long size;
+    double samples;
+} Symbol;
+
+static Symbol symbols[MAX_SYMBOLS];
+static int symbol_count = 0;
+
+static int by_addr(const void *a, const void *b)
+{
+    const Symbol *x = a, *y = b;
+    return (x->addr > y->addr) - (x->addr < y->addr);
+}
+
+static int by_samples(const void *a, const void *b)
+{
+    const Symbol *x = a, *y = b;
+    return (x->samples < y->samples) - (x->samples > y->samples);
+}
+
+/* 解析 map 文件中的代码符号行：
+ *   name   0x08000e51   Thumb Code   320  main.o(i.main) */
+static int load_map(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char line[512];
+
+    if (!f)
+    {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) && symbol_count < MAX_SYMBOLS)
+    {
+        char name[256], kind[16], code[16], object[256];
+        unsigned long addr, size;
+
+        if (!strstr(line, " Code "))
+            continue;
+        if (sscanf(line, "%255s 0x%lx %15s %15s %lu %255s", name, &addr, kind, code, &size, object) != 6)
+            continue;
+        if (strcmp(code, "Code") != 0 || size == 0)
+            continue;
+
+        Symbol *s = &symbols[symbol_count++];
+        snprintf(s->name, sizeof(s->name), "%.63s", name);
+        char *paren = strchr(object, '(');
+        if (paren) *paren = '\0';
+        snprintf(s->object, sizeof(s->object), "%.47s", object);
+        s->addr = addr & ~1UL;      // Thumb 符号地址最低位为1
+        s->size = size;
+        s->samples = 0;
+    }
+    fclose(f);
+    qsort(symbols, symbol_count, sizeof(Symbol), by_addr);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int top = 30, opt;
+
+    while ((opt = getopt(argc, argv, "n:")) != -1)
+    {
+        if (opt == 'n')
+            top = atoi(optarg);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n rows] map_file < dump.txt\n", argv[0]);
+            return 1;
+        }
+    }
+    if (optind >= argc || load_map(argv[optind]) != 0)
+    {
+        fprintf(stderr, "usage: %s [-n rows] map_file < dump.txt\n", argv[0]);
+        return 1;
+    }
+
+    char line[256];
+    unsigned long base = 0, total = 0, other = 0;
+    unsigned shift = 7, buckets = 0, full = 0;
+    int header = 0;
+    double unknown = 0;
+
+    while (fgets(line, sizeof(line), stdin))
+    {
+        unsigned idx, count;
+        // 第6项（桶满已停止）为后加字段，旧固件导出时缺省为0
+        if (sscanf(line, "prof,0x%lx,%u,%u,%lu,%lu,%u", &base, &shift, &buckets, &total, &other, &full) >= 5)
+        {
+            header = 1;
+            continue;
+        }
+        if (strncmp(line, "prof,end", 8) == 0)
+            break;
+        if (!header || sscanf(line, "p,%u,%u", &idx, &count) != 2 || idx >= MAX_BUCKETS)
+            continue;
+
+        // 按重叠字节数把本桶样本分摊给覆盖它的符号
+        unsigned long lo = base + ((unsigned long)idx << shift);
+        unsigned long hi = lo + (1UL << shift);
+        unsigned long covered = 0;
+        for (int i = 0; i < symbol_count; i++)
+        {
+            Symbol *s = &symbols[i];
+            if (s->addr >= hi) break;
+            unsigned long a = s->addr > lo ? s->addr : lo;
+            unsigned long b = s->addr + s->size < hi ? s->addr + s->size : hi;
+            if (b > a)
+            {
+                s->samples += (double)count * (b - a) / (hi - lo);
+                covered += b - a;
+            }
+        }
+        if (covered < hi - lo)
+            unknown += (double)count * (hi - lo - covered) / (hi - lo);
+    }
+
+    if (!header || total == 0)
+    {
+        fprintf(stderr, "no profile data on stdin\n");
+        return 1;
+    }
+
+    printf("samples %lu, outside range %lu (%.1f%%), bucket %u bytes\n",
+           total, other, 100.0 * other / total, 1u << shift);
+    if (full)
+        printf("sampling stopped early: a bucket reached 65535\n");
+    printf("\n");
+
+    // 按目标文件汇总，复用 Symbol 结构（name 存目标文件名）
+    static Symbol objects[MAX_SYMBOLS];
+    int object_count = 0;
+    for (int i = 0; i < symbol_count; i++)
+    {
+        if (symbols[i].samples <= 0)
+            continue;
+        int j;
+        for (j = 0; j < object_count; j++)
+        {
+            if (strcmp(objects[j].name, symbols[i].object) == 0)
+                break;
+        }
+        if (j == object_count)
+        {
+            snprintf(objects[j].name, sizeof(objects[j].name), "%.47s", symbols[i].object);
+            objects[j].samples = 0;
+            object_count++;
+        }
+        objects[j].samples += symbols[i].samples;
+    }
+    qsort(objects, object_count, sizeof(Symbol), by_samples);
+    printf("%-10s %7s  %s\n", "samples", "%", "object");
+    for (int i = 0; i < object_count; i++)
+    {
+        printf("%-10.1f %6.2f%%  %s\n", objects[i].samples, 100.0 * objects[i].samples / total, objects[i].name);
+    }
+
+    qsort(symbols, symbol_count, sizeof(Symbol), by_samples);
+    printf("\n%-10s %7s  %-40s %s\n", "samples", "%", "function", "object");
+    for (int i = 0; i < symbol_count && i < top && symbols[i].samples > 0; i++)
+    {
+        printf("%-10.1f %6.2f%%  %-40s %s\n", symbols[i].samples, 100.0 * symbols[i].samples / total,
+               symbols[i].name, symbols[i].object);
+    }
+    if (unknown > 0)
+        printf("%-10.1f %6.2f%%  %s\n", unknown, 100.0 * unknown / total, "(no symbol)");
+    return 0;
+}
@@ -0,0 +1,234 @@
+/* ==========================================================
+ * 软件正交解码校验与基准测试（上位机，Linux）
+ *
+ * 直接编译固件中的 Hardware/QEnc.c（外设寄存器由 host/periph.h 替身
+ * 提供），写入 GPIOB->IDR 引脚电平后调用对应的 EXTI 中断函数：
+ *   正反转   轴3 连续正转、反转，计数与边沿数一致，无非法跳变
+ *   随机     轴4 随机换向（含 A/B 同入口），与参考计数逐步比较
+ *   丢沿     A、B 同时跳变只进一次中断：计数不变，非法跳变计数+1，
+ *            随后另一条线的挂起中断不再重复计数
+ *   增量     QEnc_Get_Delta 与清零
+ *   基准     每次中断函数耗时，与逐位判断方向的分支写法对比
+ *
+ * 编译：gcc -O2 -Ihost -I../Hardware -I../System -include host/periph.h -o qenc_bench qenc_bench.c ../Hardware/QEnc.c
+ * 用法：qenc_bench [-n 边沿数]
+ *
+ * 主机上只能比较相对耗时；目标板单次边沿中断的最大周期数、
+ * 最大边沿频率与非法跳变次数由 @sched%? 的 sched,qenc 行给出。
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "QEnc.h"
+
+GPIO_TypeDef host_gpiob;
+EXTI_TypeDef host_exti;
+uint32_t SystemCoreClock = 72000000;
+
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+
+/* CpuLoad 记账替身 */
+static uint64_t charged_edges;
+void CpuLoad_Charge_Exti(uint32_t cycles)
+{
+    (void)cycles;
+    charged_edges++;
+}
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-60s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t rng_state = 0x2545F491;
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---------------- 引脚驱动 ---------------- */
+
+/* 正转相位序列（A为低位）：00→01→11→10 */
+static const uint8_t phase_ab[4] = { 0, 1, 3, 2 };
+
+typedef struct
+{
+    uint8_t shift;          // A相在IDR中的位号
+    uint8_t phase;          // 当前相位 0~3
+    int32_t expect;         // 参考计数
+} Pins;
+
+static void set_ab(Pins *p, uint8_t ab)
+{
+    host_gpiob.IDR = (host_gpiob.IDR & ~(3u << p->shift)) | ((uint32_t)ab << p->shift);
+}
+
+/* 走一步（dir = +1/-1），返回变化的相：0 为A，1 为B */
+static int move(Pins *p, int dir)
+{
+    uint8_t old = phase_ab[p->phase];
+    p->phase = (p->phase + dir) & 3;
+    uint8_t ab = phase_ab[p->phase];
+    set_ab(p, ab);
+    p->expect += dir;
+    return ((old ^ ab) & 1) ? 0 : 1;
+}
+
+/* 轴3：A、B 分别进入 EXTI0、EXTI1 */
+static void edge3(Pins *p, int dir)
+{
+    if (move(p, dir) == 0)
+        EXTI0_IRQHandler();
+    else
+        EXTI1_IRQHandler();
+}
+
+/* 轴4：A、B 共用 EXTI15_10 */
+static void edge4(Pins *p, int dir)
+{
+    move(p, dir);
+    EXTI15_10_IRQHandler();
+}
+
+/* ---------------- 对照：逐位判断方向的分支写法 ---------------- */
+
+static volatile int32_t ref_count;
+static uint8_t ref_state;
+static volatile uint32_t ref_errors;
+
+static void ref_edge(uint8_t shift)
+{
+    uint8_t ab = (host_gpiob.IDR >> shift) & 0x03;
+    uint8_t a = ab & 1, b = ab >> 1, pa = ref_state & 1, pb = ref_state >> 1;
+
+    if (a != pa && b != pb)
+        ref_errors++;
+    else if (a != pa)
+        ref_count += (a == pb) ? -1 : +1;       // A 变化：与 B 相同为反转
+    else if (b != pb)
+        ref_count += (b == pa) ? +1 : -1;       // B 变化：与 A 相同为正转
+    ref_state = ab;
+}
+
+int main(int argc, char **argv)
+{
+    long edges = 2000000;
+    int opt;
+    char what[128];
+
+    while ((opt = getopt(argc, argv, "n:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': edges = atol(optarg); break;
+            default:
+                fprintf(stderr, "usage: qenc_bench [-n edges]\n");
+                return 2;
+        }
+    }
+    if (edges < 1000)
+    {
+        fprintf(stderr, "qenc_bench: edges >= 1000\n");
+        return 2;
+    }
+
+    Pins p3 = { 0, 0, 0 }, p4 = { 10, 0, 0 };
+    host_gpiob.IDR = 0;
+    QEnc_Init();
+
+    /* 正反转 */
+    for (long i = 0; i < edges; i++) edge3(&p3, +1);
+    int32_t fwd = QEnc_Get_Count(3);
+    for (long i = 0; i < edges; i++) edge3(&p3, -1);
+    snprintf(what, sizeof(what), "axis 3: %ld edges forward -> %ld, back -> %ld, errors %lu",
+             edges, (long)fwd, (long)QEnc_Get_Count(3), (unsigned long)QEnc_Get_ErrorCount(3));
+    check(fwd == edges && QEnc_Get_Count(3) == 0 && QEnc_Get_ErrorCount(3) == 0, what);
+
+    /* 随机换向 */
+    long mismatch = 0;
+    int dir = 1;
+    for (long i = 0; i < edges; i++)
+    {
+        if (rng() % 16 == 0) dir = -dir;
+        edge4(&p4, dir);
+        if (QEnc_Get_Count(4) != p4.expect) mismatch++;
+    }
+    snprintf(what, sizeof(what), "axis 4: random walk, count %ld (expect %ld), %ld mismatches",
+             (long)QEnc_Get_Count(4), (long)p4.expect, mismatch);
+    check(mismatch == 0 && QEnc_Get_ErrorCount(4) == 0, what);
+
+    /* 丢沿：A、B 同时跳变（相位跨两步），两条线各挂起一次中断 */
+    int32_t before = QEnc_Get_Count(3);
+    p3.phase = (p3.phase + 2) & 3;
+    set_ab(&p3, phase_ab[p3.phase]);
+    EXTI0_IRQHandler();
+    EXTI1_IRQHandler();
+    snprintf(what, sizeof(what), "A and B change together: count %+ld, errors %lu",
+             (long)(QEnc_Get_Count(3) - before), (unsigned long)QEnc_Get_ErrorCount(3));
+    check(QEnc_Get_Count(3) == before && QEnc_Get_ErrorCount(3) == 1, what);
+    p3.expect = QEnc_Get_Count(3);
+
+    /* 增量与清零 */
+    QEnc_Get_Delta(3);
+    for (int i = 0; i < 123; i++) edge3(&p3, -1);
+    int16_t delta = QEnc_Get_Delta(3);
+    QEnc_Clear_Count(3);
+    edge3(&p3, +1);
+    snprintf(what, sizeof(what), "delta after 123 reverse edges %d; after clear +1 -> %ld",
+             delta, (long)QEnc_Get_Count(3));
+    check(delta == -123 && QEnc_Get_Count(3) == 1 && QEnc_Get_Delta(3) == 1, what);
+    check(charged_edges == (uint64_t)(2 * edges + edges + 2 + 124), "every edge charged to CpuLoad once");
+
+    /* 基准：同一随机边沿序列（预先生成引脚电平），查表中断函数对比分支写法 */
+    uint8_t *seq = malloc(edges);
+    uint8_t ph = 0;
+    for (long i = 0; i < edges; i++)
+    {
+        ph = (ph + ((rng() & 1) ? 1 : 3)) & 3;
+        seq[i] = phase_ab[ph];
+    }
+    host_gpiob.IDR = 0;
+    QEnc_Init();
+    double t0 = now_ns();
+    for (long i = 0; i < edges; i++)
+    {
+        host_gpiob.IDR = (uint32_t)seq[i] << 10;
+        EXTI15_10_IRQHandler();
+    }
+    double t_table = (now_ns() - t0) / edges;
+    ref_state = 0;
+    ref_count = 0;
+    t0 = now_ns();
+    for (long i = 0; i < edges; i++)
+    {
+        host_gpiob.IDR = (uint32_t)seq[i] << 10;
+        ref_edge(10);
+    }
+    double t_ref = (now_ns() - t0) / edges;
+    free(seq);
+    snprintf(what, sizeof(what), "random sequence: table count %ld, branch count %ld",
+             (long)QEnc_Get_Count(4), (long)ref_count);
+    check(QEnc_Get_Count(4) == ref_count && ref_errors == 0, what);
+    printf("host time per edge: table ISR %.2f ns, branch decode %.2f ns\n", t_table, t_ref);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
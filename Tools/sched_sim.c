@@ -0,0 +1,178 @@
+/* ==========================================================
+ * 多速率调度时序仿真工具（上位机，Linux）
+ *
+ * 按固件速率表（Timer.c）逐个时基周期累加各任务执行时间，并计入
+ * 更高优先级中断（USART1、QEnc的EXTI）的抢占，给出每个速率的
+ * 最坏响应时间、CPU占用以及单个时基周期的最坏负载。
+ *
+ * 编译：gcc -O2 -o sched_sim sched_sim.c
+ * 用法：sched_sim [-b 波特率] [-u USART中断周期数] [-e EXTI中断周期数]
+ *                 [-r 最高边沿频率Hz] [-o 调度开销周期数] < sched.txt
+ *
+ * 输入为固件 @sched%? 的输出（sched,<任务>,<Hz>,<相位>,<最近>,<最大>,<预算>,<超时>），
+ * 以各任务"最大周期数"作为执行时间；无输入时用预算值代替。
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CPU_HZ          72000000L
+#define BASE_HZ         10000L
+#define MAX_TASKS       8
+
+typedef struct
+{
+    char name[16];
+    long divider;
+    long phase;
+    long wcet;              // 最坏执行时间（CPU周期）
+    long worst_response;    // 相对所在时基周期起点的最坏完成时间
+} Task;
+
+static Task tasks[MAX_TASKS] =
+{
+    { "inner",    1,  0, 800, 0 },
+    { "speed",    10, 1, 5000, 0 },
+    { "position", 50, 3, 2000, 0 },
+    { "telem",    10, 7, 1500, 0 },
+    { "meas",     10, 9, 1500, 0 },
+};
+static int task_count = 5;
+
+static long gcd(long a, long b)
+{
+    while (b)
+    {
+        long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* 读取 @sched%? 输出，覆盖默认速率表 */
+static void load_table(FILE *in)
+{
+    char line[128];
+    int n = 0;
+
+    while (fgets(line, sizeof(line), in) && n < MAX_TASKS)
+    {
+        char name[16];
+        long hz, phase, last, max, budget, ovr;
+        if (strncmp(line, "sched,", 6) != 0 || strncmp(line, "sched,isr", 9) == 0 ||
+            strncmp(line, "sched,rx", 8) == 0 || strncmp(line, "sched,qenc", 10) == 0)
+            continue;
+        if (sscanf(line + 6, "%15[^,],%ld,%ld,%ld,%ld,%ld,%ld", name, &hz, &phase, &last, &max, &budget, &ovr) != 7)
+            continue;
+        if (hz <= 0)
+            continue;
+        strcpy(tasks[n].name, name);
+        tasks[n].divider = BASE_HZ / hz;
+        tasks[n].phase = phase;
+        tasks[n].wcet = max > 0 ? max : budget;
+        n++;
+    }
+    if (n > 0)
+        task_count = n;
+}
+
+/* 周期 period、每次 cost 的抢占源在长度 window 内最多产生的负载 */
+static long interference(long window, long period, long cost)
+{
+    if (period <= 0 || cost <= 0)
+        return 0;
+    return ((window + period - 1) / period) * cost;
+}
+
+int main(int argc, char **argv)
+{
+    long baud = 115200, usart_cost = 300, exti_cost = 120, edge_hz = 0, overhead = 200;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:u:e:r:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'b': baud = atol(optarg); break;
+            case 'u': usart_cost = atol(optarg); break;
+            case 'e': exti_cost = atol(optarg); break;
+            case 'r': edge_hz = atol(optarg); break;
+            case 'o': overhead = atol(optarg); break;
+            default:
+                fprintf(stderr, "usage: %s [-b baud] [-u usart_cycles] [-e exti_cycles] [-r edge_hz] [-o overhead]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (!isatty(0))
+        load_table(stdin);
+
+    long base = CPU_HZ / BASE_HZ;
+    // 接收走DMA，中断次数与字节数无关（每帧一次空闲线，至多每半缓冲一次）；
+    // 发送满速时每个字符时间一次TXE中断
+    long usart_period = baud > 0 ? CPU_HZ * 10 / baud : 0;
+    long exti_period = edge_hz > 0 ? CPU_HZ / edge_hz : 0;
+
+    long hyper = 1;
+    for (int i = 0; i < task_count; i++)
+        hyper = hyper / gcd(hyper, tasks[i].divider) * tasks[i].divider;
+
+    long worst_tick = 0, worst_tick_index = 0, late_ticks = 0;
+    for (long n = 0; n < hyper; n++)
+    {
+        long demand = overhead;
+        for (int i = 0; i < task_count; i++)
+        {
+            Task *t = &tasks[i];
+            if (n % t->divider != t->phase % t->divider)
+                continue;
+
+            demand += t->wcet;
+            // 迭代求含抢占的完成时间
+            long r = demand, prev = 0;
+            while (r != prev && r < 10 * base)
+            {
+                prev = r;
+                r = demand + interference(prev, usart_period, usart_cost) + interference(prev, exti_period, exti_cost);
+            }
+            if (r > t->worst_response)
+                t->worst_response = r;
+            if (r > worst_tick)
+            {
+                worst_tick = r;
+                worst_tick_index = n;
+            }
+        }
+        long r = demand, prev = 0;
+        while (r != prev && r < 10 * base)
+        {
+            prev = r;
+            r = demand + interference(prev, usart_period, usart_cost) + interference(prev, exti_period, exti_cost);
+        }
+        if (r > base)
+            late_ticks++;
+    }
+
+    printf("base %ld Hz (%ld cycles), hyperperiod %ld ticks\n", BASE_HZ, base, hyper);
+    printf("%-10s %8s %6s %8s %10s %10s %8s\n", "task", "Hz", "phase", "wcet", "response", "deadline", "cpu%");
+    double total = (double)overhead / base;
+    for (int i = 0; i < task_count; i++)
+    {
+        Task *t = &tasks[i];
+        long deadline = base * t->divider;
+        double cpu = 100.0 * t->wcet / deadline;
+        total += (double)t->wcet / deadline;
+        printf("%-10s %8ld %6ld %8ld %10ld %10ld %7.2f%s\n", t->name, BASE_HZ / t->divider, t->phase,
+               t->wcet, t->worst_response, deadline, cpu, t->worst_response > deadline ? "  MISS" : "");
+    }
+    if (usart_period)
+        total += (double)usart_cost / usart_period;
+    if (exti_period)
+        total += (double)exti_cost / exti_period;
+    printf("worst tick %ld: %ld cycles (%.1f%% of base period)\n", worst_tick_index, worst_tick, 100.0 * worst_tick / base);
+    printf("ticks over base period: %ld of %ld\n", late_ticks, hyper);
+    printf("total cpu incl. interrupts: %.1f%%\n", 100.0 * total);
+    return late_ticks > 0;
+}
@@ -0,0 +1,200 @@
+/* ==========================================================
+ * 交叉耦合同步仿真工具（上位机，Linux）
+ *
+ * 两个直流电机一阶模型（时间常数、增益、库仑摩擦），编码器按整数
+ * 脉冲计数，测速与固件 Encoder_Get_Speed 相同（每ms脉冲数×1.85，向0截断），
+ * 速度环为与 PID.c 相同的增量式 PID，每1ms一次。
+ *
+ * 负载不对称：电机2增益低、摩擦大，并周期性受到负载冲击（如输送带上
+ * 的工件、底盘一侧过坎）。冲击期间电机2指令达到限幅仍跟不上目标，
+ * 增量式 PID 的输出限幅丢弃了这段速度误差，冲击过后速度恢复但丢失的
+ * 位移不会追回，独立速度环下两轴位置差逐次累积；交叉耦合（直接编译
+ * 固件中的 Hardware/Sync.c）让电机1同时减速等待，冲击过后误差回到0附近。
+ *
+ * 先按秒列出各耦合增益下的同步误差（增益0即两轴独立运行），再给出
+ * 最终同步误差、最大同步误差、均方根误差与速度目标修正量的最大值。
+ *
+ * 编译：gcc -O2 -I../Hardware -o sync_sim sync_sim.c ../Hardware/Sync.c -lm
+ * 用法：sync_sim [-t 秒] [-s 目标速度] [-a 电机2负载冲击] [-k 增益Q8] [-c]
+ *       -k 可重复，默认比较 0、4、8、16、32；-c 输出最后一个增益的逐ms曲线（CSV）
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include "Sync.h"
+
+#define MAX_GAINS       8
+#define MAX_SECONDS     600
+#define PID_OUT_MAX     800         // SPEED_PID_OUT_MAX
+
+typedef struct
+{
+    double gain;            // 稳态速度 / 指令（脉冲/ms 每单位指令）
+    double tau_ms;          // 机械时间常数
+    double coulomb;         // 库仑摩擦（指令当量）
+    double w;               // 速度（脉冲/ms）
+    double pos;             // 位置（脉冲）
+    int32_t count;          // 编码器计数
+    int32_t prev_count;
+} Plant;
+
+typedef struct
+{
+    float kp, ki, kd;
+    float output;
+    float err[3];
+} Pid;
+
+/* 与 PID.c 中 Speed_PID_Compute_Motor 相同的增量式 PID */
+static int16_t pid_compute(Pid *s, int16_t target, int16_t actual)
+{
+    s->err[2] = s->err[1];
+    s->err[1] = s->err[0];
+    s->err[0] = target - actual;
+    s->output += s->kp * (s->err[0] - s->err[1]) + s->ki * s->err[0] +
+                 s->kd * (s->err[0] - 2 * s->err[1] + s->err[2]);
+    if (s->output > PID_OUT_MAX) s->output = PID_OUT_MAX;
+    if (s->output < -PID_OUT_MAX) s->output = -PID_OUT_MAX;
+    return (int16_t)s->output;
+}
+
+/* 推进1ms：摩擦在静止时作为静摩擦，指令不足时不起动 */
+static void plant_step(Plant *m, double u, double load)
+{
+    double drive = u - load;
+    if (m->w > 1e-6) drive -= m->coulomb;
+    else if (m->w < -1e-6) drive += m->coulomb;
+    else if (fabs(drive) <= m->coulomb) drive = 0;
+    else drive -= (drive > 0 ? m->coulomb : -m->coulomb);
+
+    const int sub = 10;
+    for (int i = 0; i < sub; i++)
+    {
+        m->w += (m->gain * drive - m->w) / m->tau_ms / sub;
+        m->pos += m->w / sub;
+    }
+    m->count = (int32_t)floor(m->pos);
+}
+
+static int16_t plant_speed(Plant *m)
+{
+    int16_t delta = (int16_t)(m->count - m->prev_count);
+    m->prev_count = m->count;
+    return (int16_t)(delta * 1.85f);
+}
+
+/* 电机2负载冲击：每秒一次，持续200ms */
+static double load2(long t_ms, double bump)
+{
+    return (t_ms > 500 && t_ms % 1000 < 200) ? bump : 0;
+}
+
+typedef struct
+{
+    int32_t final_err;
+    int32_t max_err;
+    double rms_err;
+    int max_corr;
+} Result;
+
+static Result run(uint16_t kc, long ms, int16_t target, double bump, int csv, int32_t *trace)
+{
+    Plant m1 = { 0.030, 30, 60, 0, 0, 0, 0 };
+    Plant m2 = { 0.026, 35, 90, 0, 0, 0, 0 };
+    Pid p1 = { 2.0f, 0.5f, 0.1f, 0, { 0, 0, 0 } }, p2 = p1;
+    Result r = { 0, 0, 0, 0 };
+    double sum_sq = 0;
+    int16_t t1, t2;
+
+    Sync_Set_Gain(kc);
+    Sync_Start();
+    if (csv) printf("ms,target1,target2,speed1,speed2,sync_err\n");
+
+    for (long t = 0; t < ms; t++)
+    {
+        int16_t v1 = plant_speed(&m1);
+        int16_t v2 = plant_speed(&m2);
+        int32_t err = Sync_Tick(m1.count, m2.count, target, &t1, &t2);
+        int16_t u1 = pid_compute(&p1, t1, v1);
+        int16_t u2 = pid_compute(&p2, t2, v2);
+        plant_step(&m1, u1, 0);
+        plant_step(&m2, u2, load2(t, bump));
+
+        int corr = abs(t2 - target);
+        if (corr > r.max_corr) r.max_corr = corr;
+        if (abs(err) > r.max_err) r.max_err = abs(err);
+        sum_sq += (double)err * err;
+        r.final_err = err;
+        if (trace && (t + 1) % 1000 == 0) trace[t / 1000] = err;
+        if (csv) printf("%ld,%d,%d,%d,%d,%d\n", t, t1, t2, v1, v2, err);
+    }
+    r.rms_err = sqrt(sum_sq / ms);
+    return r;
+}
+
+int main(int argc, char **argv)
+{
+    long seconds = 20;
+    int target = 20, csv = 0, opt, n = 0;
+    double bump = 400;
+    uint16_t gains[MAX_GAINS] = { 0, 4, 8, 16, 32 };
+
+    while ((opt = getopt(argc, argv, "t:s:a:k:c")) != -1)
+    {
+        switch (opt)
+        {
+            case 't': seconds = atol(optarg); break;
+            case 's': target = atoi(optarg); break;
+            case 'a': bump = atof(optarg); break;
+            case 'k':
+                if (n < MAX_GAINS) gains[n++] = (uint16_t)atoi(optarg);
+                break;
+            case 'c': csv = 1; break;
+            default:
+                fprintf(stderr, "usage: sync_sim [-t s] [-s speed] [-a load] [-k gain]... [-c]\n");
+                return 2;
+        }
+    }
+    if (seconds < 1 || seconds > MAX_SECONDS || abs(target) > 50)
+    {
+        fprintf(stderr, "sync_sim: 1 <= -t <= %d, |-s| <= 50\n", MAX_SECONDS);
+        return 2;
+    }
+    if (n == 0) n = 5;
+
+    if (csv)
+    {
+        run(gains[n - 1], seconds * 1000, target, bump, 1, NULL);
+        return 0;
+    }
+
+    static int32_t trace[MAX_GAINS][MAX_SECONDS];
+    Result res[MAX_GAINS];
+    for (int i = 0; i < n; i++)
+    {
+        res[i] = run(gains[i], seconds * 1000, target, bump, 0, trace[i]);
+    }
+
+    printf("target %d (%.1f counts/ms), motor 2 load bump %.0f for 200 ms every 1 s, %ld s\n",
+           target, target / 1.85, bump, seconds);
+    printf("\nsync error (counts) at the end of each second\n%6s", "s");
+    for (int i = 0; i < n; i++) printf(" %9s%-3u", "kc=", gains[i]);
+    printf("\n");
+    for (long t = 0; t < seconds; t++)
+    {
+        printf("%6ld", t + 1);
+        for (int i = 0; i < n; i++) printf(" %12d", trace[i][t]);
+        printf("\n");
+    }
+
+    printf("\n%8s %12s %12s %12s %12s\n", "kc_q8", "final_err", "max_err", "rms_err", "max_corr");
+    for (int i = 0; i < n; i++)
+    {
+        printf("%8u %12d %12d %12.1f %12d\n", gains[i], res[i].final_err, res[i].max_err,
+               res[i].rms_err, res[i].max_corr);
+    }
+    return 0;
+}
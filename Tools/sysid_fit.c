@@ -0,0 +1,377 @@
+/* ==========================================================
+ * 电机模型拟合工具（上位机，Linux）
+ *
+ * 读取固件 @ident 命令导出的PRBS记录（SysId_Dump 输出），
+ * 用最小二乘拟合离散模型，并按 λ 整定法给出速度环增益。
+ *
+ * 编译：gcc -O2 -o sysid_fit sysid_fit.c -lm
+ * 用法：sysid_fit [-l lambda_ms] [-d max_dead] < dump.txt
+ *       也可直接读串口：sysid_fit < /dev/ttyUSB0
+ *       sysid_fit -t        自测：按已知对象（与 tune_check 相同的测速量化）生成
+ *                           PRBS 记录，拟合后增益与时间常数误差不超过 10%
+ *
+ * 一阶模型（含纯滞后d个周期与摩擦）：
+ *   v[k+1] = a·v[k] + b·u[k-d] + c·sgn(v[k])
+ *   → K = b/(1-a)，τ = -Ts/ln(a)，摩擦 = -c/b（指令单位）
+ * 二阶模型：
+ *   v[k+1] = a1·v[k] + a2·v[k-1] + b·u[k-d] + c·sgn(v[k])
+ *
+ * 输出：
+ *   model,1,<Ts s>,<K>,<τ s>,<滞后 s>,<摩擦>     K 为 Encoder_Get_Speed 单位（×1.85）每单位指令
+ *   model,2,<Ts s>,<a1>,<a2>,<b>,<c>,<滞后 s>
+ *   plant,<增益>,<τ ms>    换算为仿真工具的单位（脉冲/ms 每单位指令、ms），
+ *                          即 tune_check、adapt_check 的 -k、-t 参数
+ *   @pid%...               可原样发送给固件
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAX_SAMPLES   4096
+#define MAX_PARAMS    4
+#define FIT_IV_ITER   3             // 工具变量迭代次数
+
+static double u[MAX_SAMPLES];
+static double v[MAX_SAMPLES];
+static int sample_count = 0;
+static double ts = 0.001;           // 采样周期（秒）
+
+#define SPEED_SCALE   1.85          // Encoder_Get_Speed：每ms脉冲数 × 1.85
+#define SYNTH_SAMPLES 1024          // 自测记录长度，与 SYSID_SAMPLES 相同
+
+typedef struct
+{
+    double gain;            // 稳态增益（速度单位每单位指令）
+    double tau;             // 时间常数（秒）
+    double dead;            // 纯滞后（秒）
+    double friction;        // 库仑摩擦（指令单位）
+} Model;
+
+static double sgn(double x)
+{
+    return (x > 0) - (x < 0);
+}
+
+/* 高斯消元（列主元）求解 n×n 方程组，成功返回0 */
+static int solve(double a[MAX_PARAMS][MAX_PARAMS], double b[MAX_PARAMS], double x[MAX_PARAMS], int n)
+{
+    for (int col = 0; col < n; col++)
+    {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++)
+            if (fabs(a[row][col]) > fabs(a[pivot][col]))
+                pivot = row;
+        if (fabs(a[pivot][col]) < 1e-12)
+            return -1;
+
+        for (int k = 0; k < n; k++)
+        {
+            double t = a[col][k]; a[col][k] = a[pivot][k]; a[pivot][k] = t;
+        }
+        double t = b[col]; b[col] = b[pivot]; b[pivot] = t;
+
+        for (int row = col + 1; row < n; row++)
+        {
+            double f = a[row][col] / a[col][col];
+            for (int k = col; k < n; k++)
+                a[row][k] -= f * a[col][k];
+            b[row] -= f * b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; row--)
+    {
+        double sum = b[row];
+        for (int k = row + 1; k < n; k++)
+            sum -= a[row][k] * x[k];
+        x[row] = sum / a[row][row];
+    }
+    return 0;
+}
+
+static double xhat[MAX_SAMPLES];      // 辅助模型输出（工具变量）
+
+/* 回归向量 φ（测速值）或工具变量 z（辅助模型输出）：
+ * order 1 → [v, u, sgn]，order 2 → [v, v-1, u, sgn] */
+static int regressor_of(const double *y, int order, int dead, int k, double phi[MAX_PARAMS])
+{
+    int n = 0;
+    phi[n++] = y[k];
+    if (order == 2)
+        phi[n++] = y[k - 1];
+    phi[n++] = u[k - dead];
+    phi[n++] = sgn(y[k]);
+    return n;
+}
+
+/* 以当前参数仿真无噪声输出，作为下一轮的工具变量；发散返回非0 */
+static int simulate(int order, int dead, const double theta[MAX_PARAMS])
+{
+    double phi[MAX_PARAMS];
+    int start = dead + order;
+
+    for (int k = 0; k <= start && k < sample_count; k++)
+        xhat[k] = v[k];
+    for (int k = start; k < sample_count - 1; k++)
+    {
+        int n = regressor_of(xhat, order, dead, k, phi);
+        double x = 0;
+        for (int i = 0; i < n; i++)
+            x += theta[i] * phi[i];
+        if (!(fabs(x) < 1e6))
+            return -1;
+        xhat[k + 1] = x;
+    }
+    return 0;
+}
+
+/* 对给定阶次与滞后做参数估计，返回残差均方，参数写入theta
+ *
+ * 测速为整数脉冲差，量化噪声同时出现在回归向量 v[k] 与输出 v[k+1] 中，
+ * 普通最小二乘会把 a 估小（τ 偏小、增益偏小）。先做最小二乘，再以
+ * 辅助模型法（工具变量）迭代：用上一轮参数仿真的无噪声输出代替回归
+ * 向量中的测速值作为工具变量，解 Σ z·φᵀ θ = Σ z·v[k+1]。 */
+static double fit(int order, int dead, double theta[MAX_PARAMS])
+{
+    double phi[MAX_PARAMS], z[MAX_PARAMS];
+    int n = 0, start = dead + order;
+
+    for (int iter = 0; iter <= FIT_IV_ITER; iter++)
+    {
+        double ata[MAX_PARAMS][MAX_PARAMS] = {{0}};
+        double atb[MAX_PARAMS] = {0};
+
+        if (iter > 0 && simulate(order, dead, theta) != 0)
+            return INFINITY;
+        for (int k = start; k < sample_count - 1; k++)
+        {
+            n = regressor_of(v, order, dead, k, phi);
+            regressor_of(iter ? xhat : v, order, dead, k, z);
+            for (int i = 0; i < n; i++)
+            {
+                for (int j = 0; j < n; j++)
+                    ata[i][j] += z[i] * phi[j];
+                atb[i] += z[i] * v[k + 1];
+            }
+        }
+        if (n == 0 || solve(ata, atb, theta, n) != 0)
+            return INFINITY;
+    }
+
+    double sse = 0;
+    int count = 0;
+    for (int k = start; k < sample_count - 1; k++)
+    {
+        regressor_of(v, order, dead, k, phi);
+        double pred = 0;
+        for (int i = 0; i < n; i++)
+            pred += theta[i] * phi[i];
+        sse += (v[k + 1] - pred) * (v[k + 1] - pred);
+        count++;
+    }
+    return sse / count;
+}
+
+/* 读取 ident 数据块，成功返回0 */
+static int read_dump(FILE *fp)
+{
+    char line[128];
+    int in_block = 0, expected = 0;
+    int motor, offset, amp, hold, period_us;
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (!in_block)
+        {
+            if (sscanf(line, "ident,%d,%d,%d,%d,%d,%d", &motor, &offset, &amp,
+                       &hold, &expected, &period_us) == 6)
+            {
+                in_block = 1;
+                sample_count = 0;
+                ts = period_us * 1e-6;
+                fprintf(stderr, "motor %d, offset %d, amp %d, hold %d, %d samples\n",
+                        motor, offset, amp, hold, expected);
+            }
+            continue;
+        }
+        if (strncmp(line, "ident,end", 9) == 0)
+            return sample_count > 10 ? 0 : -1;
+
+        int uu, vv;
+        char extra;
+        if (sscanf(line, "%d,%d%c", &uu, &vv, &extra) >= 2 && sample_count < MAX_SAMPLES)
+        {
+            u[sample_count] = uu;
+            v[sample_count] = vv;
+            sample_count++;
+        }
+    }
+    return (in_block && sample_count > 10) ? 0 : -1;
+}
+
+/* 拟合一阶与二阶模型，print 非0时输出结果行，失败返回非0 */
+static int fit_and_print(double lambda_ms, int max_dead, int print, Model *model)
+{
+    /* 一阶：搜索使残差最小的纯滞后 */
+    double best1[MAX_PARAMS] = {0}, theta[MAX_PARAMS];
+    double best_mse = INFINITY;
+    int best_dead = 0;
+    for (int d = 0; d <= max_dead; d++)
+    {
+        double mse = fit(1, d, theta);
+        if (mse < best_mse)
+        {
+            best_mse = mse;
+            best_dead = d;
+            memcpy(best1, theta, sizeof(theta));
+        }
+    }
+    double a = best1[0], b = best1[1], c = best1[2];
+    if (!(a > 0 && a < 1) || b == 0)
+    {
+        fprintf(stderr, "first-order fit failed (a=%g b=%g)\n", a, b);
+        return 1;
+    }
+    double gain = b / (1 - a);
+    double tau = -ts / log(a);
+    double dead = best_dead * ts;
+    double friction = -c / b;
+
+    if (print) printf("# first order: a=%.6f b=%.6f c=%.4f mse=%.4f\n", a, b, c, best_mse);
+    if (print) printf("model,1,%.6f,%.6f,%.6f,%.6f,%.3f\n", ts, gain, tau, dead, friction);
+    if (print) printf("plant,%.5f,%.2f\n", gain / SPEED_SCALE, tau * 1000);
+
+    /* 二阶：沿用一阶的滞后 */
+    double best2[MAX_PARAMS];
+    double mse2 = fit(2, best_dead, best2);
+    if (isfinite(mse2))
+    {
+        double a1 = best2[0], a2 = best2[1];
+        double disc = a1 * a1 + 4 * a2;
+        if (print) printf("# second order: a1=%.6f a2=%.6f b=%.6f c=%.4f mse=%.4f\n",
+               a1, a2, best2[2], best2[3], mse2);
+        if (print) printf("model,2,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n", ts, a1, a2, best2[2], best2[3], dead);
+        if (disc >= 0)
+        {
+            double p1 = (a1 + sqrt(disc)) / 2, p2 = (a1 - sqrt(disc)) / 2;
+            if (p1 > 0 && p1 < 1 && p2 > 0 && p2 < 1)
+                if (print) printf("# poles: tau1=%.4fs tau2=%.4fs\n", -ts / log(p1), -ts / log(p2));
+        }
+    }
+
+    /* λ整定（IMC-PI）：Kp = τ/(K(λ+θ))，Ti = τ，换算为每周期增量式系数 */
+    double lambda = (lambda_ms > 0) ? lambda_ms * 1e-3 : tau;
+    double kp = tau / (gain * (lambda + dead + ts));
+    double ki = kp * ts / tau;
+    if (print) printf("@pid%%%.4f,%.5f,%.4f\n", kp, ki, 0.0);
+
+    model->gain = gain;
+    model->tau = tau;
+    model->dead = dead;
+    model->friction = friction;
+    return 0;
+}
+
+/* ---------------- 自测 ---------------- */
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-60s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+/* 按固件 SysId_Dump 的格式生成记录：一阶对象（含库仑摩擦），编码器按整数
+ * 脉冲计数、测速与 Encoder_Get_Speed 相同（×1.85 向0截断），指令晚一个周期生效 */
+static void synth_dump(FILE *fp, double gain, double tau_ms, double friction,
+                       int offset, int amp, int hold, int samples)
+{
+    const int sub = 10;
+    double w = 0, pos = 0, applied = 0;
+    int32_t prev = 0;
+    int bit = 0;
+
+    fprintf(fp, "ident,1,%d,%d,%d,%d,1000\n", offset, amp, hold, samples);
+    for (int k = 0; k < samples; k++)
+    {
+        if (k % hold == 0)
+            bit = rand() & 1;
+        int cmd = bit ? offset + amp : offset - amp;
+        for (int i = 0; i < sub; i++)
+        {
+            double drive = applied - (w > 0 ? friction : w < 0 ? -friction : 0);
+            w += (gain * drive - w) / tau_ms / sub;
+            pos += w / sub;
+        }
+        applied = cmd;
+        int32_t count = (int32_t)floor(pos);
+        fprintf(fp, "%d,%d\n", cmd, (int)((count - prev) * (float)SPEED_SCALE));
+        prev = count;
+    }
+    fprintf(fp, "ident,end\n");
+}
+
+static int self_test(void)
+{
+    /* 只检查仿真工具使用的增益与时间常数：单向运行时摩擦与增益近似共线，
+     * 过零时测速量化使 sgn(v) 不可靠，摩擦估计只作参考 */
+    static const struct { double gain, tau_ms, friction; int offset, amp, hold; } cases[] =
+    {
+        { 0.06, 30,  0, 400, 150, 20 },     // tune_check、adapt_check 的默认对象
+        { 0.06, 30, 40, 400, 150, 20 },
+        { 0.15, 80, 20, 200, 100, 40 },
+    };
+    char what[128];
+
+    srand(1);
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        FILE *fp = tmpfile();
+        Model m = { 0, 0, 0, 0 };
+        synth_dump(fp, cases[i].gain, cases[i].tau_ms, cases[i].friction,
+                   cases[i].offset, cases[i].amp, cases[i].hold, SYNTH_SAMPLES);
+        rewind(fp);
+        int ok = read_dump(fp) == 0 && fit_and_print(0, 20, 0, &m) == 0;
+        fclose(fp);
+
+        // 按 plant 行的单位比较
+        double gain = m.gain / SPEED_SCALE, tau_ms = m.tau * 1000;
+        snprintf(what, sizeof(what), "K %.2f, tau %.0f ms, F %.0f, u %d+/-%d: plant %.4f,%.1f F %.1f",
+                 cases[i].gain, cases[i].tau_ms, cases[i].friction, cases[i].offset, cases[i].amp,
+                 gain, tau_ms, m.friction);
+        check(ok && fabs(gain / cases[i].gain - 1) < 0.1 && fabs(tau_ms / cases[i].tau_ms - 1) < 0.1, what);
+    }
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    double lambda_ms = 0;
+    int max_dead = 20;
+    Model model;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+            lambda_ms = atof(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            max_dead = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0)
+            return self_test();
+        else
+        {
+            fprintf(stderr, "usage: %s [-l lambda_ms] [-d max_dead] < dump\n       %s -t\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if (read_dump(stdin) != 0)
+    {
+        fprintf(stderr, "no ident block found\n");
+        return 1;
+    }
+    return fit_and_print(lambda_ms, max_dead, 1, &model);
+}
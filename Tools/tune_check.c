@@ -0,0 +1,258 @@
+/* ==========================================================
+ * 继电反馈自整定校验工具（上位机，Linux）
+ *
+ * 直接编译固件中的 Hardware/Autotune.c，对象为直流电机一阶模型
+ * （时间常数、增益），编码器按整数脉冲计数，测速与固件 Encoder_Get_Speed
+ * 相同（每ms脉冲数×1.85，向0截断），电机指令晚一个周期生效（内环输出）。
+ * PID 与电机接口由本文件提供，算法与 PID.c 相同：
+ *   Ku/Tu    带回差继电器的描述函数：振荡点满足 G(jω) = -1/N(a)，即
+ *            Re G = -π√(a²-ε²)/(4d)、Im G = -πε/(4d)。以正弦注入同一线性模型
+ *            （不量化，含指令延迟、测速与整定器内的低通）求 ω=2π/Tu 处的 G：
+ *            Im G 校验测得的 Tu，由 Re G 预测的振幅 a 与整定器由 Ku 反推的
+ *            振幅比较（a 接近 ε 时 Ku 对振幅极敏感，故比较振幅；描述函数为
+ *            近似，加上量化，允许 ±30%）
+ *   闭环     按 Z-N PID 与 Tyreus-Luyben 规则整定后，目标阶跃的超调与
+ *            5秒时的稳态误差
+ *   失败     继电幅值过小（振荡淹没在回差内）时报告失败并停止电机，增益不变
+ *
+ * 编译：gcc -O2 -Ihost -I../Hardware -o tune_check tune_check.c ../Hardware/Autotune.c -lm
+ * 用法：tune_check [-k 稳态增益(脉冲/ms每单位指令)] [-t 时间常数ms] [-s 工作点速度]
+ *       -k、-t 可直接取 sysid_fit 输出的 plant 行
+ * ========================================================== */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <unistd.h>
+#include "Autotune.h"
+#include "PID.h"
+#include "Motor.h"
+#include "GainSched.h"
+
+#define TUNE_RELAY      100     // 继电幅值（固件默认值）
+#define TUNE_EPS        3.0     // 继电回差（Autotune.c 中 TUNE_HYSTERESIS_Q4）
+
+static int failures = 0;
+
+static void check(int ok, const char *what)
+{
+    printf("%-66s %s\n", what, ok ? "PASS" : "FAIL");
+    if (!ok) failures++;
+}
+
+/* ---------------- 固件接口替身 ---------------- */
+
+static float pid_kp = 2.0f, pid_ki = 0.5f, pid_kd = 0.1f;
+static float pid_output, pid_err[3];
+static int16_t motor_command;               // 本周期写入的指令，下周期生效
+static int pid_set_count;
+
+void Speed_PID_SetParams(float p, float i, float d)
+{
+    pid_kp = p;
+    pid_ki = i;
+    pid_kd = d;
+    pid_set_count++;
+}
+
+void Speed_PID_Reset(void)
+{
+    pid_output = 0;
+    pid_err[0] = pid_err[1] = pid_err[2] = 0;
+}
+
+/* 调度表不参与仿真 */
+void GainSched_Invalidate(void)
+{
+}
+
+/* 与 PID.c 中 Speed_PID_Compute_Motor 相同的增量式 PID */
+int16_t Speed_PID_Compute(int16_t target, int16_t actual)
+{
+    pid_err[2] = pid_err[1];
+    pid_err[1] = pid_err[0];
+    pid_err[0] = target - actual;
+    pid_output += pid_kp * (pid_err[0] - pid_err[1]) + pid_ki * pid_err[0] +
+                  pid_kd * (pid_err[0] - 2 * pid_err[1] + pid_err[2]);
+    if (pid_output > SPEED_PID_OUT_MAX) pid_output = SPEED_PID_OUT_MAX;
+    if (pid_output < -SPEED_PID_OUT_MAX) pid_output = -SPEED_PID_OUT_MAX;
+    return (int16_t)pid_output;
+}
+
+void Motor_Set_Speed(uint8_t motor_num, int16_t speed)
+{
+    if (motor_num == 1) motor_command = speed;
+}
+
+/* ---------------- 对象模型 ---------------- */
+
+typedef struct
+{
+    double gain;            // 稳态速度 / 指令（脉冲/ms 每单位指令）
+    double tau_ms;
+    double w;               // 速度（脉冲/ms）
+    double pos;
+    int32_t prev_count;
+    int16_t applied;        // 上周期指令（本周期生效）
+} Plant;
+
+static void plant_reset(Plant *m)
+{
+    m->w = m->pos = 0;
+    m->prev_count = 0;
+    m->applied = 0;
+    motor_command = 0;
+}
+
+/* 推进1ms，返回固件测速值 */
+static int16_t plant_step(Plant *m)
+{
+    const int sub = 10;
+    for (int i = 0; i < sub; i++)
+    {
+        m->w += (m->gain * m->applied - m->w) / m->tau_ms / sub;
+        m->pos += m->w / sub;
+    }
+    m->applied = motor_command;
+    int32_t count = (int32_t)floor(m->pos);
+    int16_t delta = (int16_t)(count - m->prev_count);
+    m->prev_count = count;
+    return (int16_t)(delta * 1.85f);
+}
+
+/* 回路频率响应（无量化）：指令以正弦注入，按固件顺序经一周期延迟、对象、
+ * 测速与整定器内 α=1/4 低通，到继电器所见速度的复数增益 */
+static void loop_response(const Plant *ref, double w_rad, double *re, double *im)
+{
+    Plant m = *ref;
+    double filt = 0, prev_pos = 0, sum_re = 0, sum_im = 0;
+    double u_prev = 0;
+    long settle = (long)(20 * m.tau_ms) + 2000, n = 0;
+
+    m.w = m.pos = 0;
+    for (long t = 0; t < settle + 20000; t++)
+    {
+        double u = sin(w_rad * t);
+        if (t >= settle)
+        {
+            // filt 为本周期继电器所见值，相对本周期注入的 u 求增益
+            sum_re += filt * cos(w_rad * t);
+            sum_im += filt * -sin(w_rad * t);
+            n++;
+        }
+        const int sub = 10;
+        for (int i = 0; i < sub; i++)
+        {
+            m.w += (m.gain * u_prev - m.w) / m.tau_ms / sub;
+            m.pos += m.w / sub;
+        }
+        u_prev = u;
+        double v = (m.pos - prev_pos) * 1.85;
+        prev_pos = m.pos;
+        filt += (v - filt) / 4;
+    }
+    // y = |G| sin(ωt+φ)：Σ y cos = N/2 |G| sin φ，Σ y·(-sin) = -N/2 |G| cos φ
+    *re = -2 * sum_im / n;
+    *im = 2 * sum_re / n;
+}
+
+/* 运行整定直至完成，返回 Autotune_PollDone 结果 */
+static uint8_t run_tune(Plant *m, int16_t speed, uint8_t rule, int16_t relay)
+{
+    uint8_t done = 0;
+    int16_t v = 0;
+
+    plant_reset(m);
+    Autotune_Start(speed, rule, relay);
+    for (long t = 0; t < 30000 && !done; t++)
+    {
+        Autotune_Tick(v);
+        v = plant_step(m);
+        done = Autotune_PollDone();
+    }
+    return done;
+}
+
+/* 以当前增益跟随阶跃 speed，返回超调（%）与最后 500ms 平均误差 */
+static void step_response(Plant *m, int16_t speed, double *overshoot, double *ss_err)
+{
+    int16_t v = 0;
+    int max = 0;
+    double err_sum = 0;
+
+    plant_reset(m);
+    Speed_PID_Reset();
+    for (long t = 0; t < 5000; t++)
+    {
+        Motor_Set_Speed(1, Speed_PID_Compute(speed, v));
+        v = plant_step(m);
+        if (v > max) max = v;
+        if (t >= 4500) err_sum += speed - v;
+    }
+    *overshoot = 100.0 * (max - speed) / speed;
+    *ss_err = err_sum / 500;
+}
+
+int main(int argc, char **argv)
+{
+    Plant m = { 0.06, 30, 0, 0, 0, 0 };
+    int speed = 30, opt;
+    char what[128];
+    double re, im, os, ss;
+
+    while ((opt = getopt(argc, argv, "k:t:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'k': m.gain = atof(optarg); break;
+            case 't': m.tau_ms = atof(optarg); break;
+            case 's': speed = atoi(optarg); break;
+            default:
+                fprintf(stderr, "usage: tune_check [-k gain] [-t tau_ms] [-s speed]\n");
+                return 2;
+        }
+    }
+    if (m.gain <= 0 || m.tau_ms < 2 || speed <= 0 || speed > 200)
+    {
+        fprintf(stderr, "tune_check: gain > 0, tau >= 2 ms, 0 < speed <= 200\n");
+        return 2;
+    }
+
+    printf("plant: gain %.3f counts/ms per unit, tau %.0f ms, relay %d, hysteresis %.0f\n",
+           m.gain, m.tau_ms, TUNE_RELAY, TUNE_EPS);
+
+    /* Z-N PID：Kp = 0.6Ku，Kd = Kp·Tu/8 */
+    uint8_t done = run_tune(&m, speed, TUNE_RULE_ZN_PID, TUNE_RELAY);
+    double ku = pid_kp / 0.6, tu = pid_kd / pid_kp * 8;
+    snprintf(what, sizeof(what), "Z-N PID tune completes (done %u): Ku %.2f, Tu %.1f ms", done, ku, tu);
+    check(done == 1 && ku > 0 && tu > 2, what);
+    loop_response(&m, 2 * M_PI / tu, &re, &im);
+    double im_expect = -M_PI * TUNE_EPS / (4 * TUNE_RELAY);
+    snprintf(what, sizeof(what), "  Im G(2pi/Tu) %.4f, expect -pi*eps/4d %.4f", im, im_expect);
+    check(fabs(im / im_expect - 1) <= 0.3, what);
+    double a_meas = hypot(4 * TUNE_RELAY / (M_PI * ku), TUNE_EPS);
+    double a_pred = hypot(4 * TUNE_RELAY * re / M_PI, TUNE_EPS);
+    snprintf(what, sizeof(what), "  relay amplitude %.2f (Re G %.4f predicts %.2f)", a_meas, re, a_pred);
+    check(re < 0 && fabs(a_meas / a_pred - 1) <= 0.3, what);
+    step_response(&m, speed, &os, &ss);
+    snprintf(what, sizeof(what), "  step to %d with Z-N gains: overshoot %.0f%%, error %.2f", speed, os, ss);
+    check(os < 60 && fabs(ss) < 1.5, what);
+
+    /* Tyreus-Luyben：更保守，超调应不大于 Z-N */
+    double os_zn = os;
+    done = run_tune(&m, speed, TUNE_RULE_TL_PID, TUNE_RELAY);
+    step_response(&m, speed, &os, &ss);
+    snprintf(what, sizeof(what), "Tyreus-Luyben: overshoot %.0f%% (Z-N %.0f%%), error %.2f", os, os_zn, ss);
+    check(done == 1 && os <= os_zn && fabs(ss) < 1.5, what);
+
+    /* 继电幅值过小：振荡幅值不超过回差，整定失败，增益不变、电机停止 */
+    float kp_before = pid_kp;
+    int sets_before = pid_set_count;
+    done = run_tune(&m, speed, TUNE_RULE_ZN_PID, 1);
+    snprintf(what, sizeof(what), "relay 1: reports failure (done %u), gains kept, motor stopped", done);
+    check(done == 2 && pid_set_count == sets_before && pid_kp == kp_before && motor_command == 0, what);
+
+    printf("%s\n", failures ? "FAILED" : "all passed");
+    return failures ? 1 : 0;
+}
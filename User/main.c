@@ -1,4 +1,5 @@
 #include "stm32f10x.h"
+#include <stdio.h>
 #include "OLED.h"
 #include "Serial.h"
 #include "PID.h"
@@ -6,77 +7,232 @@
 #include "Timer.h"
 #include "Encoder.h"
 #include "Motor.h"
+#include "QEnc.h"
+#include "Delay.h"
+#include "Param.h"
+#include "Friction.h"
+#include "Autotune.h"
+#include "SysId.h"
+#include "Adaptive.h"
+#include "GainSched.h"
+#include "Observer.h"
+#include "Defer.h"
+#include "Sched.h"
+#include "CpuLoad.h"
+#include "Profiler.h"
+#include "MemInfo.h"
+#include "Baud.h"
+#include "Telemetry.h"
+#include "Measure.h"
+#include "Link.h"
+#include "Pvt.h"
+#include "Gear.h"
+#include "Sync.h"
+#include "Drive.h"
 
 // =====================================================
 // 全局变量定义
 // =====================================================
-uint8_t current_mode = 1;     // 当前控制模式：1-速度控制，2-位置跟随
+uint8_t current_mode = 1;     // 当前控制模式：1-速度控制，2-位置跟随，3-同步（@sync%1），4-差速底盘（@drv%1）
 int16_t target_speed = 0;     // 电机目标速度，通过串口设置
 
+static uint8_t display_mode = 0;    // OLED上已显示的模式，0表示需要刷新
+
+// =====================================================
+// 任务：按键扫描与模式切换（10ms）
+// =====================================================
+static void Task_Key(void)
+{
+    if(Key_GetNum() == 0)
+        return;
+
+    Friction_Calib_Abort();                       // 切换模式时中止标定
+    Autotune_Abort();
+    SysId_Abort();
+    Pvt_Stop();                                   // 轨迹以电机1当前位置为起点，切换后不再有效
+    Adaptive_Enable(0, 0, 0);                     // 自适应需在速度模式重新开启
+
+    if(current_mode != 1)                         // 切换模式（模式3、4回到速度模式）
+    {
+        current_mode = 1;
+
+        // 停止两个电机
+        Motor_Stop_All();
+
+        // 重置速度PID
+        Speed_PID_Reset();
+    }
+    else
+    {
+        // 重置编码器位置
+        Encoder_Clear_TotalCount(1);
+        Encoder_Clear_TotalCount(2);
+        Observer_Rebase(1);
+        Observer_Rebase(2);
+        Drive_Odom_Rebase();                      // 位姿保持，不因计数清零跳变
+
+        // 重置目标位置变量
+        target_position2 = 0;
+
+        // 记录电机1当前位置作为参考
+        last_position1 = Encoder_Get_Position(1);
+
+        // 计数清零与重定基准完成后才进入模式2：位置环在控制中断中运行，
+        // 先置模式会让齿轮以清零前的位置为起点，产生一次跟随误差跳变
+        Gear_Release();
+        current_mode = 2;
+    }
+}
+
+// =====================================================
+// 任务：命令结果处理与状态上报（10ms）
+// 串口命令在接收中断中解析，耗时的输出在此完成
+// =====================================================
+static void Task_Command(void)
+{
+    // ---------- 摩擦标定完成：上报并保存 ----------
+    uint8_t calib_result = Friction_Calib_PollDone();
+    if(calib_result == 1)
+    {
+        Friction_Report(Friction_Calib_Motor());
+        Param_Request_Save();
+    }
+    else if(calib_result == 2)
+    {
+        printf("fric,%d,fail\n", Friction_Calib_Motor());
+    }
+
+    // ---------- 自整定完成：上报增益（已在中断中生效） ----------
+    uint8_t tune_result = Autotune_PollDone();
+    if(tune_result == 1)
+    {
+        Autotune_Report();
+    }
+    else if(tune_result == 2)
+    {
+        printf("tune,fail\n");
+    }
+
+    // ---------- 辨识记录完成：导出数据 ----------
+    if(SysId_PollDone())
+    {
+        SysId_Dump();
+    }
+
+    // ---------- 各模块状态查询 ----------
+    Adaptive_PollReport();
+    GainSched_Poll();
+    Observer_PollReport();
+    Timer_PollReport();
+    Sched_PollReport();
+    CpuLoad_PollReport();
+    Profiler_PollDump();
+    MemInfo_PollReport();
+    Telemetry_PollReport();
+    Measure_PollReport();
+    Link_PollReport();
+    Pvt_PollReport();
+    Gear_PollReport();
+    Sync_PollReport();
+    Drive_PollReport(Sched_Now());
+    Baud_Poll(Sched_Now());
+}
+
+// =====================================================
+// 任务：OLED刷新（100ms）
+// 模式文字只在变化时重写，目标速度与CPU占用每次刷新
+// =====================================================
+static void Task_Display(void)
+{
+    if(display_mode != current_mode)
+    {
+        display_mode = current_mode;
+        OLED_ShowNum(1, 6, current_mode, 1);
+        OLED_ShowString(2, 1, current_mode == 1 ? "Speed Control" :
+                              current_mode == 2 ? "Pos Following" :
+                              current_mode == 3 ? "Sync Control " : "Diff Drive   ");
+    }
+    OLED_ShowSignedNum(3, 3, target_speed, 4);
+
+    uint16_t busy = CpuLoad_Get_Busy();           // ‰，显示为 xx.x%
+    OLED_ShowNum(4, 5, busy / 10, 3);
+    OLED_ShowNum(4, 9, busy % 10, 1);
+}
+
+// =====================================================
+// 任务：参数保存（100ms）
+// 擦写Flash期间CPU停顿约20ms，集中在此任务中执行
+// =====================================================
+static void Task_Param(void)
+{
+    Param_Poll();
+}
+
+// =====================================================
+// 任务：健康检查（1s）
+// 控制中断丢失时基或主循环任务超时时上报
+// =====================================================
+static void Task_Health(void)
+{
+    static uint32_t last_late = 0, last_misses = 0;
+    uint32_t late = Timer_Get_Late();
+    uint32_t misses = Sched_Get_Misses();
+
+    if(late != last_late || misses != last_misses)
+    {
+        printf("health,late,%lu,miss,%lu,load,%u\n", (unsigned long)late, (unsigned long)misses, Sched_Get_Load());
+        last_late = late;
+        last_misses = misses;
+    }
+}
+
+// 主循环任务表：数组顺序即优先级
+// 名称、周期(ms)、期限(ms)、任务函数
+static Sched_Task main_tasks[] =
+{
+    { "key",     KEY_SCAN_MS, 10,   Task_Key     },
+    { "cmd",     10,          50,   Task_Command },
+    { "display", 100,         100,  Task_Display },
+    { "param",   100,         500,  Task_Param   },
+    { "health",  1000,        1000, Task_Health  },
+};
+
 int main(void)
 {
+    MemInfo_Paint(); // 栈填充图案，须在开中断之前
+
     // -------------------- 外设初始化 --------------------
+    Delay_Init();    // DWT周期计数器初始化
     Key_Init();      // 按键初始化
     OLED_Init();     // OLED显示初始化
     Serial_Init();   // 串口初始化
-    Timer_Init();    // 定时器初始化（10ms周期）
+    Defer_Init();    // PendSV下半部（最低优先级）
     Encoder_Init();  // 编码器初始化
-    PWM_Init();      // PWM初始化，用于电机控制
+    QEnc_Init();     // 附加轴软件正交解码初始化（PB0/PB1，PB10/PB11）
+    Observer_Init(); // 编码器状态观测器初始化（α-β-γ，默认θ=0.8）
+    PWM_Init();      // PWM初始化，用于电机控制（TIM2，20kHz）
+
+    Param_Load();    // 读取Flash中的标定参数（无效时使用默认值）
 
     // -------------------- PID参数设置 --------------------
     Speed_PID_SetParams(5.0f, 1.5f, 0.5f);         // 电机速度PID
     Position_PID_SetParams(0.15f, 0.01f, 0.03f);   // 位置PID，低增益减少振动
 
     // -------------------- 电机停止初始化 --------------------
-    GPIO_ResetBits(GPIOB, GPIO_Pin_12 | GPIO_Pin_13 | GPIO_Pin_14 | GPIO_Pin_15);
-    TIM_SetCompare3(TIM2, 0);  // 电机1PWM置0
-    TIM_SetCompare4(TIM2, 0);  // 电机2PWM置0
+    Motor_Stop_All();          // 方向引脚拉低，两路PWM置0
+
+    // -------------------- 启动控制时基 --------------------
+    // 控制中断会读写编码器、PWM与标定参数，须在它们全部就绪后最后开启
+    Timer_Init();    // 控制时基初始化（TIM1，10kHz，多速率调度）
 
     // -------------------- OLED显示初始状态 --------------------
     OLED_ShowString(1, 1, "Mode:");
-    OLED_ShowNum(1, 6, current_mode, 1);
-    OLED_ShowString(2, 1, "Speed Control");
+    OLED_ShowString(3, 1, "T:");
+    OLED_ShowString(4, 1, "CPU:   . %");
 
     // =====================================================
-    // 主循环
+    // 主循环：协作式任务调度（1ms节拍，空闲时休眠）
     // =====================================================
-    while(1)
-    {
-        // ---------- 按键检测与模式切换 ----------
-        uint8_t key_num = Key_GetNum();
-        if(key_num != 0)  // 如果有按键按下
-        {
-            current_mode = (current_mode == 1) ? 2 : 1;   // 切换模式
-            OLED_ShowNum(1, 6, current_mode, 1);         // 更新OLED显示模式
-
-            if(current_mode == 1)
-            {
-                // 速度控制模式显示
-                OLED_ShowString(2, 1, "Speed Control");
-
-                // 停止两个电机
-                GPIO_ResetBits(GPIOB, GPIO_Pin_12 | GPIO_Pin_13 | GPIO_Pin_14 | GPIO_Pin_15);
-                TIM_SetCompare3(TIM2, 0);
-                TIM_SetCompare4(TIM2, 0);
-
-                // 重置速度PID
-                Speed_PID_Reset();
-            }
-            else
-            {
-                // 位置跟随模式显示
-                OLED_ShowString(2, 1, "Pos Following");
-
-                // 重置编码器位置
-                Encoder_Clear_TotalCount(1);
-                Encoder_Clear_TotalCount(2);
-
-                // 重置目标位置变量
-                target_position2 = 0;
-
-                // 记录电机1当前位置作为参考
-                last_position1 = Encoder_Get_Position(1);
-            }
-        }
-    }
+    Sched_Init();
+    Sched_Run(main_tasks, sizeof(main_tasks) / sizeof(main_tasks[0]));
 }
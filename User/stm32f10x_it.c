@@ -23,6 +23,9 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f10x_it.h"
+#include "Defer.h"
+#include "Sched.h"
+#include "CpuLoad.h"
 
 /** @addtogroup STM32F10x_StdPeriph_Template
   * @{
@@ -125,6 +128,9 @@ void DebugMon_Handler(void)
   */
 void PendSV_Handler(void)
 {
+  CPULOAD_ENTER(CPU_CTX_PENDSV);
+  Defer_Run();    // 控制中断等置位的延后工作（遥测、浮点整定）
+  CPULOAD_EXIT();
 }
 
 /**
@@ -134,6 +140,10 @@ void PendSV_Handler(void)
   */
 void SysTick_Handler(void)
 {
+  CPULOAD_ENTER(CPU_CTX_SYSTICK);
+  Sched_Tick();   // 主循环调度1ms节拍
+  CpuLoad_Tick(); // CPU负载窗口结算
+  CPULOAD_EXIT();
 }
 
 /******************************************************************************/